@@ -44,7 +44,7 @@ cleanup_test_environment()
 }
 
 void print_help(){
-  printf ("\nUsage: Bsa [-v <n>] | [--skip <n>]\n"
+  printf ("\nUsage: Bsa [-v <n>] | [--skip <n>] | [--sysfs[=<dir>]] | [--msg-bench[=<n>]]\n"
          "Options:\n"
          "-v      Verbosity of the Prints\n"
          "        1 shows all prints, 5 shows Errors\n"
@@ -55,6 +55,11 @@ void print_help(){
          "-os     Enable the execution of operating system tests\n"
          "-hyp    Enable the execution of hypervisor tests\n"
          "-ps     Enable the execution of platform security tests\n"
+         "--sysfs Access PCIe from user space through the sysfs PCI device tree\n"
+         "        at <dir>, " PCIE_SYSFS_ROOT " by default. Runs without the\n"
+         "        BSA kernel module\n"
+         "--msg-bench Compare the driver log channels with <n> records from\n"
+         "        a user space producer, then exit\n"
   );
 }
 
@@ -66,7 +71,9 @@ main (int argc, char **argv)
     char *endptr, *pt;
     int   status;
     int   run_exerciser = 0;
+    unsigned int num_jobs, job;
     int   sw_view = 0;
+    char *sysfs_root = NULL;
 
     struct option long_opt[] =
     {
@@ -75,6 +82,8 @@ main (int argc, char **argv)
       {"os", no_argument, NULL, 'o'},
       {"hyp", no_argument, NULL, 'q'},
       {"ps", no_argument, NULL, 'p'},
+      {"sysfs", optional_argument, NULL, 's'},
+      {"msg-bench", optional_argument, NULL, 'b'},
       {NULL, 0, NULL, 0}
     };
 
@@ -110,6 +119,11 @@ main (int argc, char **argv)
        case 'e':
          run_exerciser = 1;
          break;
+       case 's':
+         sysfs_root = optarg ? optarg : PCIE_SYSFS_ROOT;
+         break;
+       case 'b':
+         return msg_ring_benchmark(optarg ? strtoul(optarg, &endptr, 10) : 1000000);
        case '?':
          if (isprint (optopt))
            fprintf (stderr, "Unknown option `-%c'.\n", optopt);
@@ -136,6 +150,11 @@ main (int argc, char **argv)
 
     printf ("\n Starting tests (Print level is %2d)\n\n", g_print_level);
 
+    if (sysfs_root) {
+        printf("\n      *** Starting user space PCIe pass ***  \n");
+        execute_tests_pcie_sysfs(sysfs_root, g_print_level);
+    }
+
     printf (" Gathering system information.... \n");
     status = initialize_test_environment(g_print_level);
     if (status) {
@@ -143,20 +162,37 @@ main (int argc, char **argv)
         return 0;
     }
 
-    printf("\n      *** Starting Memory Map tests ***  \n");
-    execute_tests_memory(1, g_print_level);
+    bsa_job_t jobs[] = {
+        {0, "Memory Map",  execute_tests_memory,     0},
+        {1, "Peripherals", execute_tests_peripheral, 0},
+        {2, "PCIe",        execute_tests_pcie,       0},
+    };
+    num_jobs = sizeof(jobs) / sizeof(jobs[0]);
 
-    printf("\n      *** Starting Peripherals tests ***  \n");
-    execute_tests_peripheral(1, g_print_level);
+    /* PCIe tests are not run when the exerciser tests are requested */
+    if (run_exerciser)
+        num_jobs--;
 
-    if (run_exerciser) {
-        printf("\n      *** PCIe Exerciser tests only runs on UEFI ***  \n");
-        //execute_tests_exerciser(1, g_print_level);
-    } else {
-        printf("\n      *** Starting PCIe tests ***  \n");
-        execute_tests_pcie(1, g_print_level);
+    /* The driver runs one module at a time. Its messages are streamed by a
+       separate thread while the module runs */
+    if (start_msg_reader())
+        printf(" Cannot start the message reader, messages are read while waiting \n");
+
+    for (job = 0; job < num_jobs; job++) {
+        printf("\n      *** Starting %s tests ***  \n", jobs[job].name);
+        jobs[job].status = jobs[job].run(1, g_print_level);
     }
 
+    stop_msg_reader();
+
+    if (run_exerciser)
+        printf("\n      *** PCIe Exerciser tests only runs on UEFI ***  \n");
+
+    printf("\n      Module results:\n");
+    for (job = 0; job < num_jobs; job++)
+        printf("      Job %d  %-12s : %s\n", jobs[job].job_id, jobs[job].name,
+               jobs[job].status ? "One or more tests Failed/Skipped" : "Passed");
+
     printf("\n                    *** BSA tests complete *** \n\n");
 
     cleanup_test_environment();
@@ -0,0 +1,194 @@
+/** @file
+ * Copyright (c) 2021 Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#include "include/bsa_app.h"
+#include "include/bsa_msg_ring.h"
+
+/* Log channel benchmark.
+
+   A producer thread stands in for the driver and sends records to a
+   consumer which formats them to /dev/null, once through a pipe read one
+   record per system call, like the records of /proc/bsa_msg, and once
+   through a shared ring drained in bulk. For the ring, a pipe plays the
+   part of the driver poll() wake up. */
+
+#define BENCH_RING_RECORDS  1024
+
+typedef struct {
+    bsa_msg_ring_t *ring;
+    int             data_fd;        ///< Record pipe, read() path
+    int             bell_fd;        ///< Wake up pipe, ring path
+    unsigned int    num_records;
+} bench_ctx_t;
+
+static double
+bench_now(void)
+{
+
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void
+bench_fill(bsa_msg_parms_t *rec, unsigned int i)
+{
+
+    snprintf(rec->string, sizeof(rec->string), "\n       Benchmark record %u", i);
+    rec->data = i;
+}
+
+static void *
+bench_pipe_producer(void *arg)
+{
+
+    bench_ctx_t *ctx = arg;
+    bsa_msg_parms_t rec;
+    unsigned int i;
+
+    for (i = 0; i < ctx->num_records; i++) {
+        bench_fill(&rec, i);
+        if (write(ctx->data_fd, &rec, sizeof(rec)) != sizeof(rec))
+            break;
+    }
+
+    close(ctx->data_fd);
+    return NULL;
+}
+
+static void *
+bench_ring_producer(void *arg)
+{
+
+    bench_ctx_t *ctx = arg;
+    bsa_msg_ring_t *ring = ctx->ring;
+    uint32_t head = 0, tail;
+    unsigned int i;
+    char bell = 0;
+
+    for (i = 0; i < ctx->num_records; i++) {
+        while ((head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE)) == ring->num_records)
+            sched_yield();
+
+        bench_fill(&ring->record[head & (ring->num_records - 1)], i);
+
+        tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        __atomic_store_n(&ring->head, ++head, __ATOMIC_RELEASE);
+
+        /* Wake the consumer when the ring was empty, as the driver would */
+        if (tail == head - 1)
+            if (write(ctx->bell_fd, &bell, 1) < 0)
+                break;
+    }
+
+    return NULL;
+}
+
+/**
+  This function measures the records per second of the record at a time
+  read() path and of the shared ring, using a user space producer
+**/
+int
+msg_ring_benchmark(unsigned int num_records)
+{
+
+    bench_ctx_t     ctx;
+    pthread_t       producer;
+    bsa_msg_parms_t rec;
+    struct pollfd   pfd;
+    FILE   *out;
+    double  start, read_rate, ring_rate;
+    int     data_pipe[2], bell_pipe[2];
+    unsigned int done, count;
+    char    bell[64];
+
+    out = fopen("/dev/null", "w");
+    if (out == NULL)
+        return 1;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.num_records = num_records;
+
+    /* One read() per record */
+    if (pipe(data_pipe)) {
+        fclose(out);
+        return 1;
+    }
+
+    ctx.data_fd = data_pipe[1];
+    start = bench_now();
+    pthread_create(&producer, NULL, bench_pipe_producer, &ctx);
+    for (done = 0; read(data_pipe[0], &rec, sizeof(rec)) == sizeof(rec); done++)
+        fprintf(out, "%s", rec.string);
+    pthread_join(producer, NULL);
+    read_rate = done / (bench_now() - start);
+    close(data_pipe[0]);
+
+    /* Shared ring drained in bulk */
+    ctx.ring = mmap(NULL, BSA_MSG_RING_SIZE(BENCH_RING_RECORDS), PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if ((ctx.ring == MAP_FAILED) || pipe(bell_pipe)) {
+        fclose(out);
+        return 1;
+    }
+
+    ctx.ring->magic       = BSA_MSG_RING_MAGIC;
+    ctx.ring->version     = BSA_MSG_RING_VERSION;
+    ctx.ring->num_records = BENCH_RING_RECORDS;
+    ctx.bell_fd = bell_pipe[1];
+    fcntl(bell_pipe[0], F_SETFL, O_NONBLOCK);
+    pfd.fd = bell_pipe[0];
+    pfd.events = POLLIN;
+
+    start = bench_now();
+    pthread_create(&producer, NULL, bench_ring_producer, &ctx);
+    for (done = 0; done < num_records; ) {
+        while (read(bell_pipe[0], bell, sizeof(bell)) > 0)
+            ;
+
+        count = msg_ring_drain(ctx.ring, out);
+        done += count;
+        if ((count == 0) && (done < num_records))
+            poll(&pfd, 1, 10);
+    }
+    pthread_join(producer, NULL);
+    ring_rate = done / (bench_now() - start);
+
+    close(bell_pipe[0]);
+    close(bell_pipe[1]);
+    munmap(ctx.ring, BSA_MSG_RING_SIZE(BENCH_RING_RECORDS));
+    fclose(out);
+
+    printf("\n Log channel benchmark, %u records\n", num_records);
+    printf("   read() per record : %10.0f records/s\n", read_rate);
+    printf("   mmap ring         : %10.0f records/s\n", ring_rate);
+    return 0;
+}
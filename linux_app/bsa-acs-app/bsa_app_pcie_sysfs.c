@@ -0,0 +1,340 @@
+/** @file
+ * Copyright (c) 2021 Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "include/bsa_app.h"
+
+/* User space PCIe access through sysfs.
+
+   Config space is read with pread on <root>/<ssss:bb:dd.f>/config and BARs
+   are mapped from the resourceN files of the same directory, so no call
+   goes through the BSA kernel module. The root defaults to
+   /sys/bus/pci/devices and can point at a copy of that tree. Without
+   CAP_SYS_ADMIN, the kernel only exposes the first 64 bytes of config
+   space and refuses BAR mappings. */
+
+#define PCIE_SYSFS_MAX_FUNC    1024
+#define PCIE_SYSFS_MAX_BAR     6
+
+#define PCIE_SYSFS_BDF(seg, bus, dev, func) \
+    ((seg << 24) | ((bus & 0xFF) << 16) | ((dev & 0xFF) << 8) | (func & 0xFF))
+
+#define CFG_VENDOR_ID          0x00
+#define CFG_CLASS_REV          0x08
+#define CFG_HEADER_TYPE        0x0C
+#define CFG_STATUS_CMD         0x04
+#define CFG_CAP_PTR            0x34
+#define CFG_STATUS_CAP_LIST    (1 << 20)
+#define CAP_ID_PCIE            0x10
+#define CFG_PRIV_LIMIT         64
+
+typedef struct {
+    unsigned int bdf;
+    int          cfg_fd;
+    char         name[32];
+} pcie_sysfs_func_t;
+
+static pcie_sysfs_func_t *g_sysfs_func;
+static unsigned int       g_sysfs_num_func;
+static char               g_sysfs_root[256];
+
+/**
+  This function looks up a function enumerated by pcie_sysfs_init
+**/
+static pcie_sysfs_func_t *
+pcie_sysfs_find(unsigned int bdf)
+{
+
+    unsigned int i;
+
+    for (i = 0; i < g_sysfs_num_func; i++)
+        if (g_sysfs_func[i].bdf == bdf)
+            return &g_sysfs_func[i];
+
+    return NULL;
+}
+
+/**
+  This function enumerates the PCIe functions under a sysfs root and opens
+  their config space. Returns the number of functions, -1 on error.
+**/
+int
+pcie_sysfs_init(const char *root)
+{
+
+    DIR           *dir;
+    struct dirent *entry;
+    char           path[512];
+    unsigned int   seg, bus, dev, func;
+    pcie_sysfs_func_t *fn;
+
+    pcie_sysfs_exit();
+
+    snprintf(g_sysfs_root, sizeof(g_sysfs_root), "%s", root);
+    dir = opendir(g_sysfs_root);
+    if (dir == NULL) {
+        printf("\n Cannot open %s", g_sysfs_root);
+        return -1;
+    }
+
+    g_sysfs_func = calloc(PCIE_SYSFS_MAX_FUNC, sizeof(pcie_sysfs_func_t));
+    if (g_sysfs_func == NULL) {
+        closedir(dir);
+        return -1;
+    }
+
+    while (((entry = readdir(dir)) != NULL) && (g_sysfs_num_func < PCIE_SYSFS_MAX_FUNC)) {
+        if (sscanf(entry->d_name, "%x:%x:%x.%x", &seg, &bus, &dev, &func) != 4)
+            continue;
+
+        if ((strlen(entry->d_name) >= sizeof(fn->name)) ||
+            (snprintf(path, sizeof(path), "%s/%s/config", g_sysfs_root, entry->d_name) >=
+             (int)sizeof(path)))
+            continue;
+
+        fn = &g_sysfs_func[g_sysfs_num_func];
+        fn->cfg_fd = open(path, O_RDONLY);
+        if (fn->cfg_fd < 0)
+            continue;
+
+        fn->bdf = PCIE_SYSFS_BDF(seg, bus, dev, func);
+        strcpy(fn->name, entry->d_name);
+        g_sysfs_num_func++;
+    }
+
+    closedir(dir);
+    return g_sysfs_num_func;
+}
+
+/**
+  This function closes everything opened by pcie_sysfs_init
+**/
+void
+pcie_sysfs_exit(void)
+{
+
+    unsigned int i;
+
+    for (i = 0; i < g_sysfs_num_func; i++)
+        close(g_sysfs_func[i].cfg_fd);
+
+    free(g_sysfs_func);
+    g_sysfs_func = NULL;
+    g_sysfs_num_func = 0;
+}
+
+/**
+  This function returns the number of functions found by pcie_sysfs_init
+**/
+unsigned int
+pcie_sysfs_get_num_func(void)
+{
+
+    return g_sysfs_num_func;
+}
+
+/**
+  This function returns the BDF of the function at an index
+**/
+unsigned int
+pcie_sysfs_get_bdf(unsigned int index)
+{
+
+    if (index >= g_sysfs_num_func)
+        return 0xFFFFFFFF;
+
+    return g_sysfs_func[index].bdf;
+}
+
+/**
+  This function reads a config space dword. Returns 0 on success. On a
+  failed or short read, data is all ones and 1 is returned.
+**/
+int
+pcie_sysfs_read_cfg(unsigned int bdf, unsigned int offset, unsigned int *data)
+{
+
+    pcie_sysfs_func_t *fn = pcie_sysfs_find(bdf);
+
+    *data = 0xFFFFFFFF;
+    if ((fn == NULL) || (offset & 0x3))
+        return 1;
+
+    if (pread(fn->cfg_fd, data, sizeof(*data), offset) != sizeof(*data)) {
+        *data = 0xFFFFFFFF;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+  This function maps a memory BAR through its resourceN file.
+  Returns the mapping, NULL if the BAR is not mappable.
+**/
+void *
+pcie_sysfs_map_bar(unsigned int bdf, unsigned int bar, unsigned long *size)
+{
+
+    pcie_sysfs_func_t *fn = pcie_sysfs_find(bdf);
+    struct stat st;
+    char   path[512];
+    void  *addr;
+    int    fd;
+
+    *size = 0;
+    if ((fn == NULL) || (bar >= PCIE_SYSFS_MAX_BAR))
+        return NULL;
+
+    if (snprintf(path, sizeof(path), "%s/%s/resource%u", g_sysfs_root, fn->name, bar) >=
+        (int)sizeof(path))
+        return NULL;
+
+    fd = open(path, O_RDWR | O_SYNC);
+    if (fd < 0)
+        return NULL;
+
+    if ((fstat(fd, &st) != 0) || (st.st_size == 0)) {
+        close(fd);
+        return NULL;
+    }
+
+    /* I/O BARs and BARs without access rights fail here */
+    addr = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+        return NULL;
+
+    *size = st.st_size;
+    return addr;
+}
+
+/**
+  This function unmaps a BAR mapped by pcie_sysfs_map_bar
+**/
+void
+pcie_sysfs_unmap_bar(void *addr, unsigned long size)
+{
+
+    if (addr)
+        munmap(addr, size);
+}
+
+/**
+  This function returns the config offset of the PCI Express capability,
+  0 if the function has none or its capability list is not readable
+**/
+static unsigned int
+pcie_sysfs_find_pcie_cap(unsigned int bdf)
+{
+
+    unsigned int data, ptr;
+    unsigned int count = 0;
+
+    if (pcie_sysfs_read_cfg(bdf, CFG_STATUS_CMD, &data) || !(data & CFG_STATUS_CAP_LIST))
+        return 0;
+
+    if (pcie_sysfs_read_cfg(bdf, CFG_CAP_PTR, &data))
+        return 0;
+
+    ptr = data & 0xFC;
+    while (ptr && (count++ < 48)) {
+        if (pcie_sysfs_read_cfg(bdf, ptr, &data))
+            return 0;
+        if ((data & 0xFF) == CAP_ID_PCIE)
+            return ptr;
+        ptr = (data >> 8) & 0xFC;
+    }
+
+    return 0;
+}
+
+/**
+  This function runs the user space PCIe pass. It enumerates the functions
+  under the sysfs root, reads their headers and PCI Express capability and
+  maps their memory BARs, without using the BSA kernel module.
+**/
+int
+execute_tests_pcie_sysfs(const char *root, unsigned int print_level)
+{
+
+    unsigned int i, bar, bdf;
+    unsigned int id, class_rev, hdr, cap, data = 0;
+    unsigned int num_pcie = 0, num_limited = 0, num_bar = 0;
+    unsigned long size;
+    void *addr;
+    int   num_func;
+
+    num_func = pcie_sysfs_init(root);
+    if (num_func < 0)
+        return 1;
+
+    printf(" PCIe sysfs: Num of functions        :    %d \n", num_func);
+
+    for (i = 0; i < (unsigned int)num_func; i++) {
+        bdf = pcie_sysfs_get_bdf(i);
+        pcie_sysfs_read_cfg(bdf, CFG_VENDOR_ID, &id);
+        pcie_sysfs_read_cfg(bdf, CFG_CLASS_REV, &class_rev);
+        pcie_sysfs_read_cfg(bdf, CFG_HEADER_TYPE, &hdr);
+
+        /* Reads past the first 64 bytes are cut short without privileges */
+        if (pcie_sysfs_read_cfg(bdf, CFG_PRIV_LIMIT, &data))
+            num_limited++;
+
+        cap = pcie_sysfs_find_pcie_cap(bdf);
+        if (cap) {
+            num_pcie++;
+            pcie_sysfs_read_cfg(bdf, cap, &data);
+        }
+
+        if (print_level <= 2)
+            printf("  %s vid 0x%04x did 0x%04x class 0x%06x hdr %d port type 0x%x\n",
+                   g_sysfs_func[i].name, id & 0xFFFF, id >> 16, class_rev >> 8,
+                   (hdr >> 16) & 0x7F, cap ? ((data >> 20) & 0xF) : 0xFF);
+
+        /* Type 1 headers have 2 BARs */
+        for (bar = 0; bar < ((((hdr >> 16) & 0x7F) == 1) ? 2 : PCIE_SYSFS_MAX_BAR); bar++) {
+            addr = pcie_sysfs_map_bar(bdf, bar, &size);
+            if (addr == NULL)
+                continue;
+
+            num_bar++;
+            if (print_level <= 1)
+                printf("    BAR%d mapped, size 0x%lx\n", bar, size);
+            pcie_sysfs_unmap_bar(addr, size);
+        }
+    }
+
+    printf(" PCIe sysfs: Num of PCIe functions   :    %d \n", num_pcie);
+    printf(" PCIe sysfs: Num of mappable BARs    :    %d \n", num_bar);
+    if (num_limited)
+        printf(" PCIe sysfs: %d functions expose only %d bytes of config space,"
+               " run as root for full access\n", num_limited, CFG_PRIV_LIMIT);
+
+    pcie_sysfs_exit();
+    return 0;
+}
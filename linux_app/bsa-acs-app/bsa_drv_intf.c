@@ -18,9 +18,26 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
 
 #include <stdint.h>
 #include "include/bsa_drv_intf.h"
+#include "include/bsa_msg_ring.h"
+
+#define BSA_MSG_POLL_US     1000
+#define BSA_MSG_POLL_MS     10
+#define BSA_STATUS_POLL_US  1000
+
+static pthread_t        g_msg_reader;
+static pthread_mutex_t  g_msg_lock = PTHREAD_MUTEX_INITIALIZER;
+static volatile int     g_msg_reader_run;
+static bsa_msg_ring_t  *g_msg_ring;
+static size_t           g_msg_ring_size;
+static int              g_msg_ring_fd = -1;
 
 typedef
 struct __BSA_DRV_PARMS__
@@ -71,9 +88,16 @@ call_drv_wait_for_completion()
 
   while (arg0 == DRV_STATUS_PENDING){
     call_drv_get_status(&arg0, &arg1, &arg2);
-    read_from_proc_bsa_msg();
+    if (g_msg_reader_run)
+      usleep(BSA_STATUS_POLL_US);
+    else
+      read_from_proc_bsa_msg();
   }
 
+  /* Print what is left of this command before the caller moves on */
+  if (g_msg_reader_run)
+    read_from_proc_bsa_msg();
+
   return arg1;
 }
 
@@ -207,20 +231,125 @@ call_update_sw_view(unsigned int api_num, int *p_sw_view)
 
 }
 
-typedef struct __BSA_MSG__ {
-    char string[92];
-    unsigned long data;
-}bsa_msg_parms_t;
+/**
+  This function writes every record of a log ring to out and hands the
+  space back to the producer. Returns the number of records consumed.
+**/
+unsigned int
+msg_ring_drain(bsa_msg_ring_t *ring, FILE *out)
+{
+  uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+  uint32_t tail = ring->tail;
+  uint32_t mask = ring->num_records - 1;
+  unsigned int count;
+  bsa_msg_parms_t *rec;
+
+  /* Records overwritten by a misbehaving producer are skipped */
+  if (head - tail > ring->num_records)
+    tail = head - ring->num_records;
+
+  count = head - tail;
+  while (tail != head) {
+    rec = &ring->record[tail & mask];
+    fwrite(rec->string, 1, strnlen(rec->string, sizeof(rec->string)), out);
+    tail++;
+  }
+
+  __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+  return count;
+}
+
+/**
+  This function maps the log ring of the driver. Returns 0 on success,
+  1 if the driver does not provide one.
+**/
+static int
+msg_ring_open()
+{
+  bsa_msg_ring_t *hdr;
+  uint32_t num;
+  int fd;
+
+  fd = open(BSA_MSG_RING_PATH, O_RDWR);
+  if (fd < 0)
+    return 1;
+
+  hdr = mmap(NULL, sizeof(bsa_msg_ring_t), PROT_READ, MAP_SHARED, fd, 0);
+  if (hdr == MAP_FAILED) {
+    close(fd);
+    return 1;
+  }
+
+  num = hdr->num_records;
+  if ((hdr->magic != BSA_MSG_RING_MAGIC) || (hdr->version != BSA_MSG_RING_VERSION) ||
+      (num == 0) || (num & (num - 1))) {
+    munmap(hdr, sizeof(bsa_msg_ring_t));
+    close(fd);
+    return 1;
+  }
+  munmap(hdr, sizeof(bsa_msg_ring_t));
+
+  g_msg_ring_size = BSA_MSG_RING_SIZE(num);
+  g_msg_ring = mmap(NULL, g_msg_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (g_msg_ring == MAP_FAILED) {
+    g_msg_ring = NULL;
+    close(fd);
+    return 1;
+  }
+
+  g_msg_ring_fd = fd;
+  return 0;
+}
+
+static void
+msg_ring_close()
+{
+  if (g_msg_ring == NULL)
+    return;
+
+  if (g_msg_ring->dropped)
+    printf("\n %d log records were dropped, the log ring was full\n", g_msg_ring->dropped);
+
+  munmap(g_msg_ring, g_msg_ring_size);
+  close(g_msg_ring_fd);
+  g_msg_ring = NULL;
+  g_msg_ring_fd = -1;
+}
+
+/**
+  This function prints the pending log records of the driver. Returns the
+  number of records printed from the log ring, 0 when it is not mapped.
+**/
+static unsigned int
+read_from_msg_ring()
+{
+  unsigned int count;
+
+  pthread_mutex_lock(&g_msg_lock);
+  count = msg_ring_drain(g_msg_ring, stdout);
+  if (count)
+    fflush(stdout);
+  pthread_mutex_unlock(&g_msg_lock);
+
+  return count;
+}
 
 int read_from_proc_bsa_msg() {
 
   char buf_msg[sizeof(bsa_msg_parms_t)];
 
   FILE  *fd = NULL;
-  bsa_msg_parms_t msg_params;
 
-  fd = fopen("/proc/bsa_msg", "r");
+  if (g_msg_ring) {
+    read_from_msg_ring();
+    return 0;
+  }
+
+  pthread_mutex_lock(&g_msg_lock);
+
+  fd = fopen(BSA_MSG_PATH, "r");
   if (NULL == fd) {
+    pthread_mutex_unlock(&g_msg_lock);
     printf("fopen failed \n");
     return 1;
   }
@@ -231,4 +360,64 @@ int read_from_proc_bsa_msg() {
   }
 
   fclose(fd);
+  fflush(stdout);
+  pthread_mutex_unlock(&g_msg_lock);
+  return 0;
+}
+
+static void *
+msg_reader_thread(void *arg)
+{
+  struct pollfd pfd;
+
+  pfd.fd = g_msg_ring_fd;
+  pfd.events = POLLIN;
+
+  while (g_msg_reader_run) {
+    if (g_msg_ring == NULL) {
+      read_from_proc_bsa_msg();
+      usleep(BSA_MSG_POLL_US);
+      continue;
+    }
+
+    /* Sleep until the driver adds records to the empty ring */
+    if (read_from_msg_ring() == 0)
+      poll(&pfd, 1, BSA_MSG_POLL_MS);
+  }
+
+  return NULL;
+}
+
+/**
+  This function starts a thread which streams the driver log to stdout while
+  the driver runs tests, so waiting for a command only polls its status.
+  The log ring is used when the driver provides one.
+**/
+int
+start_msg_reader()
+{
+  msg_ring_open();
+
+  g_msg_reader_run = 1;
+  if (pthread_create(&g_msg_reader, NULL, msg_reader_thread, NULL)) {
+    g_msg_reader_run = 0;
+    return 1;
+  }
+
+  return 0;
+}
+
+/**
+  This function stops the message reader thread and prints what is left
+**/
+void
+stop_msg_reader()
+{
+  if (g_msg_reader_run) {
+    g_msg_reader_run = 0;
+    pthread_join(g_msg_reader, NULL);
+  }
+
+  read_from_proc_bsa_msg();
+  msg_ring_close();
 }
@@ -32,6 +32,14 @@
 typedef unsigned long int addr_t;
 typedef unsigned char     char8_t;
 
+/* A module run by the driver, its status is filled in once it completes */
+typedef struct {
+    unsigned int job_id;
+    const char  *name;
+    int        (*run)(int num_pe, unsigned int print_level);
+    int          status;
+} bsa_job_t;
+
 int
 execute_tests_pcie(int num_pe, unsigned int print_level);
 
@@ -43,4 +51,34 @@ execute_tests_peripheral(int num_pe, unsigned int print_level);
 
 int
 execute_tests_memory(int num_pe, unsigned int print_level);
+
+/* User space PCIe access through sysfs */
+#define PCIE_SYSFS_ROOT "/sys/bus/pci/devices"
+
+int
+pcie_sysfs_init(const char *root);
+
+void
+pcie_sysfs_exit(void);
+
+unsigned int
+pcie_sysfs_get_num_func(void);
+
+unsigned int
+pcie_sysfs_get_bdf(unsigned int index);
+
+int
+pcie_sysfs_read_cfg(unsigned int bdf, unsigned int offset, unsigned int *data);
+
+void *
+pcie_sysfs_map_bar(unsigned int bdf, unsigned int bar, unsigned long *size);
+
+void
+pcie_sysfs_unmap_bar(void *addr, unsigned long size);
+
+int
+execute_tests_pcie_sysfs(const char *root, unsigned int print_level);
+
+int
+msg_ring_benchmark(unsigned int num_records);
 #endif
@@ -62,4 +62,10 @@ call_drv_wait_for_completion();
 
 int read_from_proc_bsa_msg();
 
+int
+start_msg_reader();
+
+void
+stop_msg_reader();
+
 #endif
@@ -0,0 +1,60 @@
+/** @file
+ * Copyright (c) 2021 Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+
+#ifndef __BSA_MSG_RING_H__
+#define __BSA_MSG_RING_H__
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* Log records shared with the BSA kernel module.
+
+   The driver exposes the ring at BSA_MSG_RING_PATH. The app maps the file,
+   the driver appends records at head and the app consumes them from tail.
+   Both indices only grow and are reduced modulo num_records, which is a
+   power of two. The driver wakes poll() waiters on the file when it adds
+   records to an empty ring, and counts records it had to drop because the
+   ring was full. Without the ring the app reads BSA_MSG_PATH. */
+
+#define BSA_MSG_PATH            "/proc/bsa_msg"
+#define BSA_MSG_RING_PATH       "/proc/bsa_msg_ring"
+#define BSA_MSG_RING_MAGIC      0x52415342      /* "BSAR" */
+#define BSA_MSG_RING_VERSION    1
+
+typedef struct __BSA_MSG__ {
+    char string[92];
+    unsigned long data;
+}bsa_msg_parms_t;
+
+typedef struct {
+    uint32_t          magic;
+    uint32_t          version;
+    uint32_t          num_records;
+    uint32_t          dropped;      ///< Written by the driver
+    volatile uint32_t head;         ///< Written by the driver
+    volatile uint32_t tail;         ///< Written by the app
+    uint32_t          reserved[2];
+    bsa_msg_parms_t   record[];
+} bsa_msg_ring_t;
+
+#define BSA_MSG_RING_SIZE(num)  (sizeof(bsa_msg_ring_t) + (num) * sizeof(bsa_msg_parms_t))
+
+unsigned int
+msg_ring_drain(bsa_msg_ring_t *ring, FILE *out);
+
+#endif
@@ -83,6 +83,7 @@
 #define PCIE_CAP_PTR_OFFSET 20
 
 #define MSI_GENERATION_MASK     (1 << 31)
+#define MSI_VECTOR_MASK         0x7FF
 
 #define NO_SNOOP_START_MASK 0x20
 #define NO_SNOOP_STOP_MASK  0xFFFFFFDF
@@ -211,16 +212,18 @@ typedef enum {
     EXERCISER_DATA_BAR0_SPACE = 0x2,
 } EXERCISER_DATA_TYPE;
 
+#include "pal_exerciser_context.h"
+
+UINT32 pal_exerciser_create_context(UINT32 Bdf, UINT64 Ecam, EXERCISER_CONTEXT *Ctx);
 UINT32 pal_exerciser_set_param(EXERCISER_PARAM_TYPE Type, UINT64 Value1,
-                                       UINT64 Value2, UINT32 Bdf, UINT64 Ecam);
+                                       UINT64 Value2, EXERCISER_CONTEXT *Ctx);
 UINT32 pal_exerciser_get_param(EXERCISER_PARAM_TYPE Type, UINT64 *Value1,
-                                      UINT64 *Value2, UINT32 Bdf, UINT64 Ecam);
+                                      UINT64 *Value2, EXERCISER_CONTEXT *Ctx);
 UINT32 pal_exerciser_set_state(EXERCISER_STATE State, UINT64 *Value,
                                                                    UINT32 Bdf);
 UINT32 pal_exerciser_get_state(EXERCISER_STATE *State, UINT32 Bdf);
-UINT32 pal_exerciser_ops(EXERCISER_OPS Ops, UINT64 Param, UINT32 Bdf,
-                                                                  UINT64 Ecam);
+UINT32 pal_exerciser_ops(EXERCISER_OPS Ops, UINT64 Param, EXERCISER_CONTEXT *Ctx);
 UINT32 pal_exerciser_get_data(EXERCISER_DATA_TYPE Type, exerciser_data_t *Data,
-                                                      UINT32 Bdf, UINT64 Ecam);
+                                                      EXERCISER_CONTEXT *Ctx);
 
 #endif
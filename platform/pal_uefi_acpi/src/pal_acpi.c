@@ -85,6 +85,67 @@ pal_get_xsdt_ptr()
 
 }
 
+/**
+  @brief  Fold one firmware table into the platform hash
+
+  @param  Hash    Running hash
+  @param  Table   Table address
+  @param  Length  Table length in bytes
+
+  @return Updated hash
+**/
+STATIC
+UINT64
+PalPlatformHashAdd (
+  UINT64 Hash,
+  VOID   *Table,
+  UINTN  Length
+  )
+{
+  UINT32 Crc = 0;
+
+  if (EFI_ERROR(gBS->CalculateCrc32(Table, Length, &Crc)))
+    return 0;
+
+  Hash = (Hash ^ Length) * 0x100000001B3ULL;
+  Hash = (Hash ^ Crc) * 0x100000001B3ULL;
+  return Hash;
+}
+
+/**
+  @brief  Hash of the XSDT and every table it points to. Used to tell
+          whether a saved platform snapshot still describes this platform.
+
+  @param  None
+
+  @return 64-bit hash, 0 if the tables cannot be found
+**/
+UINT64
+pal_get_platform_hash()
+{
+  EFI_ACPI_DESCRIPTION_HEADER   *Xsdt;
+  EFI_ACPI_DESCRIPTION_HEADER   *Table;
+  UINT64                        *Entry64;
+  UINT32                        Entry64Num;
+  UINT32                        Idx;
+  UINT64                        Hash = 0xCBF29CE484222325ULL;
+
+  Xsdt = (EFI_ACPI_DESCRIPTION_HEADER *) pal_get_xsdt_ptr();
+  if (Xsdt == NULL)
+      return 0;
+
+  Hash = PalPlatformHashAdd(Hash, Xsdt, Xsdt->Length);
+
+  Entry64  = (UINT64 *)(Xsdt + 1);
+  Entry64Num = (Xsdt->Length - sizeof(EFI_ACPI_DESCRIPTION_HEADER)) >> 3;
+  for (Idx = 0; (Idx < Entry64Num) && Hash; Idx++) {
+    Table = (EFI_ACPI_DESCRIPTION_HEADER *)(UINTN)(Entry64[Idx]);
+    Hash = PalPlatformHashAdd(Hash, Table, Table->Length);
+  }
+
+  return Hash;
+}
+
 /**
   @brief  Iterate through the tables pointed by XSDT and return MADT address
 
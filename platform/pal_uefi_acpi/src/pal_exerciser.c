@@ -133,35 +133,33 @@ pal_is_bdf_exerciser(UINT32 bdf)
 /**
   @brief This function triggers the DMA operation
 
-  @param Base DMA Base address
+  @param Ctx Exerciser context
   @param Direction Specify DMA direction
 
   @return status of the DMA
 **/
 UINT32
 pal_exerciser_start_dma_direction (
-  UINT64 Base,
+  EXERCISER_CONTEXT *Ctx,
   EXERCISER_DMA_ATTR Direction
   )
 {
-  UINT32 Mask;
+  UINT32 Data;
   UINT32 Status;
 
-  if (Direction == EDMA_TO_DEVICE) {
-      Mask = DMA_TO_DEVICE_MASK;//  DMA direction:to Device
-      // Setting DMA direction in DMA control register 1
-      pal_mmio_write(Base + DMACTL1, (pal_mmio_read(Base + DMACTL1) & Mask));
-  }
-  if (Direction == EDMA_FROM_DEVICE) {
-      Mask = (MASK_BIT << SHIFT_4BIT);// DMA direction:from device
-      // Setting DMA direction in DMA control register 1
-      pal_mmio_write(Base + DMACTL1, (pal_mmio_read(Base + DMACTL1) | Mask));
-  }
+  Data = pal_mmio_read(Ctx->dma_ctl);
+  if (Direction == EDMA_TO_DEVICE)
+      Data &= DMA_TO_DEVICE_MASK;//  DMA direction:to Device
+  if (Direction == EDMA_FROM_DEVICE)
+      Data |= (MASK_BIT << SHIFT_4BIT);// DMA direction:from device
+
+  // Setting DMA direction in DMA control register 1
+  pal_mmio_write(Ctx->dma_ctl, Data);
   // Triggering the DMA
-  pal_mmio_write(Base + DMACTL1, (pal_mmio_read(Base + DMACTL1) | MASK_BIT));
+  pal_mmio_write(Ctx->dma_ctl, Data | MASK_BIT);
 
   // Reading the Status of the DMA
-  Status = (pal_mmio_read(Base + DMASTATUS) & ((MASK_BIT << 1) | MASK_BIT));
+  Status = (pal_mmio_read(Ctx->dma_status) & ((MASK_BIT << 1) | MASK_BIT));
   return Status;
 }
 
@@ -169,16 +167,16 @@ pal_exerciser_start_dma_direction (
   @brief This function finds the PCI capability and return 0 if it finds.
 
   @param ID    PCI capability IF 
-  @param Bdf   BDF value for the device
+  @param CfgVa Config space address of the device
   @param Value 1 PCIE capability 0 PCI capability
   @param Offset capability offset
 
-  @return 0 if PCI capability found ; 1 if PCI capability found
+  @return 0 if PCI capability found ; 1 if PCI capability not found
 **/
 UINT32
 pal_exerciser_find_pcie_capability (
   UINT32 ID,
-  UINT32 Bdf,
+  UINT64 CfgVa,
   UINT32 Value,
   UINT32 *Offset
   )
@@ -186,12 +184,10 @@ pal_exerciser_find_pcie_capability (
   UINT64 NxtPtr;
   UINT32 Data;
   UINT32 TempId;
-  UINT64 Ecam;
   UINT32 IdMask;
   UINT32 PtrMask;
   UINT32 PtrOffset;
 
-  Ecam = pal_pcie_get_mcfg_ecam();
   NxtPtr = PCIE_CAP_OFFSET;
 
   if (Value == 1) {
@@ -204,10 +200,10 @@ pal_exerciser_find_pcie_capability (
       IdMask = PCI_CAP_ID_MASK;
       PtrMask = PCI_NXT_CAP_PTR_MASK;
       PtrOffset = PCI_CAP_PTR_OFFSET;
-      NxtPtr = (pal_mmio_read(Ecam + CAP_PTR_OFFSET + pal_exerciser_get_pcie_config_offset(Bdf))) & CAP_PTR_MASK;
+      NxtPtr = (pal_mmio_read(CfgVa + CAP_PTR_OFFSET)) & CAP_PTR_MASK;
   }
   while (NxtPtr != 0) {
-    Data = pal_mmio_read(Ecam + pal_exerciser_get_pcie_config_offset(Bdf) + NxtPtr);
+    Data = pal_mmio_read(CfgVa + NxtPtr);
     TempId = Data & IdMask;
     if (TempId == ID){
         *Offset = NxtPtr;
@@ -215,33 +211,63 @@ pal_exerciser_find_pcie_capability (
     }
     NxtPtr = (Data >> PtrOffset) & PtrMask;
   }
-  bsa_print(ACS_PRINT_ERR, L"\n       No capabilities found", 0);
   return 1;
 }
 
+/**
+  @brief   This API fills the exerciser context used by all later operations on
+           the exerciser, so that they do not recompute the config space address,
+           re-read BAR0 or walk the capability list again.
+  @param   Bdf          - Stimulus hardware bdf number
+  @param   Ecam         - Ecam base for exerciser under test
+  @param   Ctx          - Exerciser context to be filled
+  @return  Status       - SUCCESS if the context is filled
+**/
+UINT32
+pal_exerciser_create_context (
+  UINT32 Bdf,
+  UINT64 Ecam,
+  EXERCISER_CONTEXT *Ctx
+  )
+{
+  UINT32 Offset;
+
+  Ctx->bdf = Bdf;
+  Ctx->ecam = Ecam;
+  Ctx->cfg_va = Ecam + pal_exerciser_get_pcie_config_offset(Bdf);
+  Ctx->bar0_base = pal_exerciser_get_ecsr_base(Ctx->cfg_va, 0);
+
+  Ctx->pasid_cap = 0;
+  if (!pal_exerciser_find_pcie_capability(PASID, Ctx->cfg_va, PCIE, &Offset))
+      Ctx->pasid_cap = Offset;
+
+  Ctx->dma_ctl = Ctx->bar0_base + DMACTL1;
+  Ctx->dma_bus_addr = Ctx->bar0_base + DMA_BUS_ADDR;
+  Ctx->dma_len = Ctx->bar0_base + DMA_LEN;
+  Ctx->dma_status = Ctx->bar0_base + DMASTATUS;
+
+  return 0;
+}
+
 /**
   @brief   This API writes the configuration parameters of the PCIe stimulus generation hardware
   @param   Type         - Parameter type that needs to be set in the stimulus hadrware
   @param   Value1       - Parameter 1 that needs to be set
   @param   Value2       - Parameter 2 that needs to be set
-  @param   Bdf          - Stimulus hardware bdf number
-  @param   Ecam         - Ecam base for exerciser under test
+  @param   Ctx          - Exerciser context
   @return  Status       - SUCCESS if the input paramter type is successfully written
 **/
 UINT32 pal_exerciser_set_param (
   EXERCISER_PARAM_TYPE Type,
   UINT64 Value1,
   UINT64 Value2,
-  UINT32 Bdf,
-  UINT64 Ecam
+  EXERCISER_CONTEXT *Ctx
   )
 {
   UINT32 Data;
   UINT64 Base;
-  UINT64 EcsrBase; /* Exerciser Base */
 
-  EcsrBase = (Ecam + pal_exerciser_get_pcie_config_offset(Bdf));
-  Base = pal_exerciser_get_ecsr_base(EcsrBase, 0); /* BAR0 address */
+  Base = Ctx->bar0_base; /* BAR0 address */
 
   switch (Type) {
 
@@ -252,18 +278,18 @@ UINT32 pal_exerciser_set_param (
           return 0;
 
       case DMA_ATTRIBUTES:
-          pal_mmio_write(Base + DMA_BUS_ADDR,Value1);// wrting into the DMA Control Register 2
-          pal_mmio_write(Base + DMA_LEN,Value2);// writing into the DMA Control Register 3
+          pal_mmio_write(Ctx->dma_bus_addr, Value1);// wrting into the DMA Control Register 2
+          pal_mmio_write(Ctx->dma_len, Value2);// writing into the DMA Control Register 3
           return 0;
 
       case P2P_ATTRIBUTES:
           return 0;
 
       case PASID_ATTRIBUTES:
-          Data = pal_mmio_read(Base + DMACTL1);
+          Data = pal_mmio_read(Ctx->dma_ctl);
           Data &= ~(PASID_LEN_MASK << PASID_LEN_SHIFT);
           Data |= ((Value1 - 16) & PASID_LEN_MASK) << PASID_LEN_SHIFT;
-          pal_mmio_write(Base + DMACTL1, Data);
+          pal_mmio_write(Ctx->dma_ctl, Data);
           return 0;
 
       case MSIX_ATTRIBUTES:
@@ -295,15 +321,15 @@ UINT32 pal_exerciser_set_param (
                 {
                     case AT_UNTRANSLATED:
                         Data = 0x1;
-                        pal_mmio_write(Base + DMACTL1, pal_mmio_read(Base + DMACTL1) | (Data << 10));
+                        pal_mmio_write(Ctx->dma_ctl, pal_mmio_read(Ctx->dma_ctl) | (Data << 10));
                         break;
                     case AT_TRANSLATED:
                         Data = 0x2;
-                        pal_mmio_write(Base + DMACTL1, pal_mmio_read(Base + DMACTL1) | (Data << 10));
+                        pal_mmio_write(Ctx->dma_ctl, pal_mmio_read(Ctx->dma_ctl) | (Data << 10));
                         break;
                     case AT_RESERVED:
                         Data = 0x3;
-                        pal_mmio_write(Base + DMACTL1, pal_mmio_read(Base + DMACTL1) | (Data << 10));
+                        pal_mmio_write(Ctx->dma_ctl, pal_mmio_read(Ctx->dma_ctl) | (Data << 10));
                         break;
                 }
                 return 0;
@@ -321,8 +347,7 @@ UINT32 pal_exerciser_set_param (
   @param   Type         - Parameter type that needs to be read from the stimulus hadrware
   @param   Value1       - Parameter 1 that is read from hardware
   @param   Value2       - Parameter 2 that is read from hardware
-  @param   Bdf          - Stimulus hardware bdf number
-  @param   Ecam         - Ecam base for exerciser under test
+  @param   Ctx          - Exerciser context
   @return  Status       - SUCCESS if the requested paramter type is successfully read
 **/
 UINT32
@@ -330,17 +355,14 @@ pal_exerciser_get_param (
   EXERCISER_PARAM_TYPE Type,
   UINT64 *Value1,
   UINT64 *Value2,
-  UINT32 Bdf,
-  UINT64 Ecam
+  EXERCISER_CONTEXT *Ctx
   )
 {
   UINT32 Status;
   UINT32 Temp;
   UINT64 Base;
-  UINT64 EcsrBase; /* Exerciser Base */
 
-  EcsrBase = (Ecam + pal_exerciser_get_pcie_config_offset(Bdf));
-  Base = pal_exerciser_get_ecsr_base(EcsrBase, 0); /*BAR0 address */
+  Base = Ctx->bar0_base; /*BAR0 address */
 
   switch (Type) {
 
@@ -348,21 +370,21 @@ pal_exerciser_get_param (
           return 0;
       case LEGACY_IRQ:
           *Value1 = pal_mmio_read(Base + INTXCTL);
-          return pal_mmio_read(Base + INTXCTL) | MASK_BIT ;
+          return *Value1 | MASK_BIT;
       case DMA_ATTRIBUTES:
-          *Value1 = pal_mmio_read(Base + DMA_BUS_ADDR); // Reading the data from DMA Control Register 2
-          *Value2 = pal_mmio_read(Base + DMA_LEN); // Reading the data from DMA Control Register 3
-          Temp = pal_mmio_read(Base + DMASTATUS);
+          *Value1 = pal_mmio_read(Ctx->dma_bus_addr); // Reading the data from DMA Control Register 2
+          *Value2 = pal_mmio_read(Ctx->dma_len); // Reading the data from DMA Control Register 3
+          Temp = pal_mmio_read(Ctx->dma_status);
           Status = Temp & MASK_BIT;// returning the DMA status
           return Status;
       case P2P_ATTRIBUTES:
           return 0;
       case PASID_ATTRIBUTES:
-          *Value1 = ((pal_mmio_read(Base + DMACTL1) >> PASID_LEN_SHIFT) & PASID_LEN_MASK) + 16;
+          *Value1 = ((pal_mmio_read(Ctx->dma_ctl) >> PASID_LEN_SHIFT) & PASID_LEN_MASK) + 16;
           return 0;
       case MSIX_ATTRIBUTES:
           *Value1 = pal_mmio_read(Base + MSICTL);
-          return pal_mmio_read(Base + MSICTL) | MASK_BIT;
+          return *Value1 | MASK_BIT;
       case ATS_RES_ATTRIBUTES:
           *Value1 = pal_mmio_read(Base + ATS_ADDR);
           return 0;
@@ -408,25 +430,21 @@ pal_exerciser_get_state (
   @brief   This API performs the input operation using the PCIe stimulus generation hardware
   @param   Ops          - Operation thta needs to be performed with the stimulus hadrware
   @param   Param        - Additional information to perform the operation
-  @param   Bdf          - Stimulus hardware bdf number
-  @param   Ecam         - Ecam base for exerciser under test
+  @param   Ctx          - Exerciser context
   @return  Status       - SUCCESS if the operation is successfully performed using the hardware
 **/
 UINT32
 pal_exerciser_ops (
   EXERCISER_OPS Ops,
   UINT64 Param,
-  UINT32 Bdf,
-  UINT64 Ecam
+  EXERCISER_CONTEXT *Ctx
   )
 {
   UINT64 Base;
-  UINT32 CapabilityOffset;
+  UINT64 PasidCtrl;
   UINT32 data;
-  UINT64 EcsrBase; /* Exerciser Base */
 
-  EcsrBase = (Ecam + pal_exerciser_get_pcie_config_offset(Bdf));
-  Base = pal_exerciser_get_ecsr_base(EcsrBase, 0); /*BAR 0 address */
+  Base = Ctx->bar0_base; /*BAR 0 address */
 
   switch(Ops){
 
@@ -440,16 +458,17 @@ pal_exerciser_ops (
             case EDMA_NOT_COHERENT:
                 return 0;
             case EDMA_FROM_DEVICE:
-                return pal_exerciser_start_dma_direction(Base, EDMA_FROM_DEVICE);// DMA from Device
+                return pal_exerciser_start_dma_direction(Ctx, EDMA_FROM_DEVICE);// DMA from Device
             case EDMA_TO_DEVICE:
-                return pal_exerciser_start_dma_direction(Base, EDMA_TO_DEVICE);// DMA to Device
+                return pal_exerciser_start_dma_direction(Ctx, EDMA_TO_DEVICE);// DMA to Device
             default:
                 return 1;
         }
 
     case GENERATE_MSI:
         /* Param is the msi_index */
-        pal_mmio_write( Base + MSICTL ,(pal_mmio_read(Base + MSICTL) | (MSI_GENERATION_MASK) | (Param)));
+        pal_mmio_write( Base + MSICTL ,((pal_mmio_read(Base + MSICTL) & ~MSI_VECTOR_MASK) |
+                                        (MSI_GENERATION_MASK) | (Param)));
         return 0;
 
     case GENERATE_L_INTR:
@@ -467,39 +486,41 @@ pal_exerciser_ops (
         return 0;
 
     case PASID_TLP_START:
-        data = pal_mmio_read(Base + DMACTL1);
+        data = pal_mmio_read(Ctx->dma_ctl);
         data |= (MASK_BIT << PASID_EN_SHIFT);
-        pal_mmio_write(Base + DMACTL1, data);
+        pal_mmio_write(Ctx->dma_ctl, data);
         data = ((Param & PASID_VAL_MASK));
         pal_mmio_write(Base + PASID_VAL, data);
 
-        if (!pal_exerciser_find_pcie_capability(PASID, Bdf, PCIE, &CapabilityOffset)) {
-            pal_mmio_write(Ecam + pal_exerciser_get_pcie_config_offset(Bdf) + CapabilityOffset + PCIE_CAP_CTRL_OFFSET,
-                            (pal_mmio_read(Ecam + pal_exerciser_get_pcie_config_offset(Bdf) + CapabilityOffset + PCIE_CAP_CTRL_OFFSET)) | PCIE_CAP_EN_MASK);
+        if (Ctx->pasid_cap) {
+            PasidCtrl = Ctx->cfg_va + Ctx->pasid_cap + PCIE_CAP_CTRL_OFFSET;
+            pal_mmio_write(PasidCtrl, pal_mmio_read(PasidCtrl) | PCIE_CAP_EN_MASK);
             return 0;
         }
+        bsa_print(ACS_PRINT_ERR, L"\n       No capabilities found", 0);
         return 1;
 
     case PASID_TLP_STOP:
-        pal_mmio_write(Base + DMACTL1, (pal_mmio_read(Base + DMACTL1) & PASID_TLP_STOP_MASK));
+        pal_mmio_write(Ctx->dma_ctl, (pal_mmio_read(Ctx->dma_ctl) & PASID_TLP_STOP_MASK));
 
-        if (!pal_exerciser_find_pcie_capability(PASID, Bdf, PCIE, &CapabilityOffset)) {
-            pal_mmio_write(Ecam + pal_exerciser_get_pcie_config_offset(Bdf) + CapabilityOffset + PCIE_CAP_CTRL_OFFSET,
-                            (pal_mmio_read(Ecam + pal_exerciser_get_pcie_config_offset(Bdf) + CapabilityOffset + PCIE_CAP_CTRL_OFFSET)) & PCIE_CAP_DIS_MASK);
+        if (Ctx->pasid_cap) {
+            PasidCtrl = Ctx->cfg_va + Ctx->pasid_cap + PCIE_CAP_CTRL_OFFSET;
+            pal_mmio_write(PasidCtrl, pal_mmio_read(PasidCtrl) & PCIE_CAP_DIS_MASK);
             return 0;
         }
+        bsa_print(ACS_PRINT_ERR, L"\n       No capabilities found", 0);
         return 1;
 
     case TXN_NO_SNOOP_ENABLE:
-        pal_mmio_write(Base + DMACTL1, (pal_mmio_read(Base + DMACTL1)) | NO_SNOOP_START_MASK);//enabling the NO SNOOP
+        pal_mmio_write(Ctx->dma_ctl, (pal_mmio_read(Ctx->dma_ctl)) | NO_SNOOP_START_MASK);//enabling the NO SNOOP
         return 0;
 
     case TXN_NO_SNOOP_DISABLE:
-        pal_mmio_write(Base + DMACTL1, (pal_mmio_read(Base + DMACTL1)) & NO_SNOOP_STOP_MASK);//disabling the NO SNOOP
+        pal_mmio_write(Ctx->dma_ctl, (pal_mmio_read(Ctx->dma_ctl)) & NO_SNOOP_STOP_MASK);//disabling the NO SNOOP
         return 0;
 
     case ATS_TXN_REQ:
-        pal_mmio_write(Base + DMA_BUS_ADDR, Param);
+        pal_mmio_write(Ctx->dma_bus_addr, Param);
         pal_mmio_write(Base + ATSCTL, ATS_TRIGGER);
         return !(pal_mmio_read(Base + ATSCTL) & ATS_STATUS);
 
@@ -512,24 +533,22 @@ pal_exerciser_ops (
   @brief   This API returns test specific data from the PCIe stimulus generation hardware
   @param   Type         - data type for which the data needs to be returned
   @param   Data         - test specific data to be be filled by pal layer
-  @param   Bdf          - Stimulus hardware bdf number
-  @param   Ecam         - Ecam base for exerciser under test
+  @param   Ctx          - Exerciser context
   @return  status       - SUCCESS if the requested data is successfully filled
 **/
 UINT32
 pal_exerciser_get_data (
   EXERCISER_DATA_TYPE Type,
   exerciser_data_t *Data,
-  UINT32 Bdf,
-  UINT64 Ecam
+  EXERCISER_CONTEXT *Ctx
   )
 {
   UINT32 Index;
   UINT64 Base;
   UINT64 EcsrBase; /* Exerciser Base */
 
-  EcsrBase = (Ecam + pal_exerciser_get_pcie_config_offset(Bdf));
-  Base = pal_exerciser_get_ecsr_base(EcsrBase, 0); /* BAR0 address */
+  EcsrBase = Ctx->cfg_va;
+  Base = Ctx->bar0_base; /* BAR0 address */
 
   //In the Latest version of BSA 6.0 this part of the test is obsolete hence filling the reg with same data
   UINT32 offset_table[TEST_REG_COUNT] = {0x00,0x08,0x00,0x08,0x00,0x08,0x00,0x08,0x00,0x08};
@@ -539,7 +558,7 @@ pal_exerciser_get_data (
   switch(Type){
       case EXERCISER_DATA_CFG_SPACE:
           for (Index = 0; Index < TEST_REG_COUNT; Index++) {
-              Data->cfg_space.reg[Index].offset = (offset_table[Index] + pal_exerciser_get_pcie_config_offset (Bdf));
+              Data->cfg_space.reg[Index].offset = (offset_table[Index] + (EcsrBase - Ctx->ecam));
               Data->cfg_space.reg[Index].attribute = attr_table[Index];
               Data->cfg_space.reg[Index].value = pal_mmio_read(EcsrBase + offset_table[Index]);
           }
@@ -197,12 +197,199 @@ pal_print(CHAR8 *string, UINT64 data)
       AsciiPrint(string, data);
 }
 
+/* SPCR interface types handled by the raw print driver */
+#define UART_TYPE_FULL_16550     0x0
+#define UART_TYPE_SUBSET_16550   0x1
+#define UART_TYPE_PL011          0x3
+#define UART_TYPE_SBSA_32BIT     0xD
+#define UART_TYPE_SBSA_GENERIC   0xE
+#define UART_TYPE_GENERIC_16550  0x12
+#define UART_TYPE_UNKNOWN        0xFFFFFFFF
+
+#define PL011_DR                 0x0
+#define PL011_FR                 0x18
+#define PL011_FR_TXFF            (1 << 5)
+#define UART16550_THR            0x0
+#define UART16550_LSR            0x5
+#define UART16550_LSR_THRE       (1 << 5)
+#define GAS_ACCESS_BYTE          1
+#define GAS_ACCESS_DWORD         3
+#define UART_POLL_LIMIT          0x100000
+#define RAW_PRINT_BUF_SIZE       128
+
 /**
-  @brief  Sends a string to the output console without using UEFI print function
-          This function will get COMM port address and directly writes to the addr char-by-char
+  @brief  Read a 16550 register
 
-  @param  addr    Address to be written
-  @param  string  An ASCII string
+  @param  addr  UART base address
+  @param  reg   Register index
+  @param  wide  Registers are 32-bit and 4 bytes apart
+
+  @return Register value
+**/
+STATIC
+UINT32
+pal_uart16550_read(UINT64 addr, UINT32 reg, UINT32 wide)
+{
+  if (wide)
+    return *(volatile UINT32 *)(addr + (reg << 2));
+
+  return *(volatile UINT8 *)(addr + reg);
+}
+
+/**
+  @brief  Write a 16550 register
+
+  @param  addr  UART base address
+  @param  reg   Register index
+  @param  wide  Registers are 32-bit and 4 bytes apart
+  @param  data  Value to write
+
+  @return None
+**/
+STATIC
+VOID
+pal_uart16550_write(UINT64 addr, UINT32 reg, UINT32 wide, UINT8 data)
+{
+  if (wide)
+    *(volatile UINT32 *)(addr + (reg << 2)) = data;
+  else
+    *(volatile UINT8 *)(addr + reg) = data;
+}
+
+/**
+  @brief  Write characters to a UART. PL011 UARTs wait for FR.TXFF to
+          clear and 16550 UARTs for LSR.THRE before every character. Both
+          report room for at least one character whether or not the FIFO
+          is enabled. Other UARTs are written without any status check.
+
+  @param  addr          UART base address
+  @param  uart_type     SPCR interface type of the UART
+  @param  access_width  GAS access size of the UART registers, 0 if not known
+  @param  buffer        Characters to write
+  @param  len           Number of characters
+
+  @return None
+**/
+STATIC
+VOID
+pal_uart_write_raw(UINT64 addr, UINT32 uart_type, UINT32 access_width, CHAR8 *buffer, UINT32 len)
+{
+  UINT32 i, poll;
+  UINT32 wide;
+
+  if ((uart_type == UART_TYPE_PL011) || (uart_type == UART_TYPE_SBSA_32BIT) ||
+      (uart_type == UART_TYPE_SBSA_GENERIC)) {
+    for (i = 0; i < len; i++) {
+      for (poll = 0; poll < UART_POLL_LIMIT; poll++)
+        if (!(*(volatile UINT32 *)(addr + PL011_FR) & PL011_FR_TXFF))
+          break;
+      /* Drop the rest rather than hang on a stuck UART */
+      if (poll == UART_POLL_LIMIT)
+        return;
+
+      *(volatile UINT32 *)(addr + PL011_DR) = (UINT8)buffer[i];
+    }
+    return;
+  }
+
+  if ((uart_type == UART_TYPE_FULL_16550) || (uart_type == UART_TYPE_SUBSET_16550) ||
+      (uart_type == UART_TYPE_GENERIC_16550)) {
+    /* The access width gives the register layout. Without it, the generic
+       16550 of SPCR is taken to have 32-bit registers, the others byte ones */
+    if (access_width == GAS_ACCESS_DWORD)
+      wide = 1;
+    else if (access_width == GAS_ACCESS_BYTE)
+      wide = 0;
+    else
+      wide = (uart_type == UART_TYPE_GENERIC_16550);
+
+    for (i = 0; i < len; i++) {
+      for (poll = 0; poll < UART_POLL_LIMIT; poll++)
+        if (pal_uart16550_read(addr, UART16550_LSR, wide) & UART16550_LSR_THRE)
+          break;
+      if (poll == UART_POLL_LIMIT)
+        return;
+
+      pal_uart16550_write(addr, UART16550_THR, wide, buffer[i]);
+    }
+    return;
+  }
+
+  for (i = 0; i < len; i++)
+    *(volatile UINT8 *)addr = buffer[i];
+}
+
+/**
+  @brief  Print a formatted string to a UART without going through UEFI.
+          The output is formatted into a buffer on the stack of the calling
+          PE, so this is usable from secondary PEs and exception handlers.
+          Only %d and %x (with optional l modifiers) are supported.
+
+  @param  addr          UART base address
+  @param  uart_type     SPCR interface type of the UART, 0xFFFFFFFF if not known
+  @param  access_width  GAS access size of the UART registers, 0 if not known
+  @param  string        format string
+  @param  data          data for the formatted output
+
+  @return None
+**/
+VOID
+pal_uart_print_raw(UINT64 addr, UINT32 uart_type, UINT32 access_width, CHAR8 *string,
+                   UINT64 data)
+{
+  CHAR8  buffer[RAW_PRINT_BUF_SIZE];
+  CHAR8  digits[20];           // UINT64 in decimal
+  UINT32 len = 0;
+  UINT32 i, j;
+
+  for (; *string != '\0'; ++string) {
+    /* Keep room for the longest number */
+    if (len > RAW_PRINT_BUF_SIZE - sizeof(digits)) {
+      pal_uart_write_raw(addr, uart_type, access_width, buffer, len);
+      len = 0;
+    }
+
+    if (*string != '%') {
+      buffer[len++] = *string;
+      continue;
+    }
+
+    ++string;
+    while (*string == 'l')
+      ++string;
+
+    i = 0;
+    if (*string == 'd') {
+      do {
+        digits[i++] = (data % 10) + '0';
+        data = data / 10;
+      } while (data != 0);
+    } else if ((*string == 'x') || (*string == 'X')) {
+      do {
+        j = data & 0xf;
+        digits[i++] = j + ((j > 9) ? 55 : 48);
+        data = data >> 4;
+      } while (data != 0);
+    } else if (*string == '\0') {
+      break;
+    } else {
+      buffer[len++] = *string;
+      continue;
+    }
+
+    while (i > 0)
+      buffer[len++] = digits[--i];
+  }
+
+  if (len)
+    pal_uart_write_raw(addr, uart_type, access_width, buffer, len);
+}
+
+/**
+  @brief  Print a formatted string to a UART of unknown type
+
+  @param  addr    UART base address
+  @param  string  format string
   @param  data    data for the formatted output
 
   @return None
@@ -210,35 +397,7 @@ pal_print(CHAR8 *string, UINT64 data)
 VOID
 pal_print_raw(UINT64 addr, CHAR8 *string, UINT64 data)
 {
-    UINT8 j, buffer[16];
-    INT8  i=0;
-    for(;*string!='\0';++string){
-        if(*string == '%'){
-            ++string;
-            if(*string == 'd'){
-                while(data != 0){
-                    j = data%10;
-                    data = data/10;
-                    buffer[i]= j + 48 ;
-                    i = i+1;
-                }
-            } else if(*string == 'x' || *string == 'X'){
-                while(data != 0){
-                    j = data & 0xf;
-                    data = data >> 4;
-                    buffer[i]= j + ((j > 9) ? 55 : 48) ;
-                    i = i+1;
-                }
-            }
-            if(i>0) {
-                while(i>=0)
-                    *(volatile UINT8 *)addr = buffer[--i];
-            } else
-                *(volatile UINT8 *)addr = 48;
-
-        } else
-            *(volatile UINT8 *)addr = *string;
-    }
+  pal_uart_print_raw(addr, UART_TYPE_UNKNOWN, 0, string, data);
 }
 
 /**
@@ -27,10 +27,19 @@
 
 static   EFI_ACPI_6_1_MULTIPLE_APIC_DESCRIPTION_TABLE_HEADER *gMadtHdr;
 UINT8   *gSecondaryPeStack;
+UINT64  *gSecondaryPeMpidr;
+UINT64  gSecondaryStackSize;
 UINT64  gMpidrMax;
 static UINT32 g_num_pe;
 
-#define SIZE_STACK_SECONDARY_PE  0x100		//256 bytes per core
+/* Per PE secondary stack size. Override with -DPAL_SECONDARY_STACK_SIZE=<bytes>
+   in the [BuildOptions] of BsaPalLib.inf, it is rounded up to a cache line. */
+#ifndef PAL_SECONDARY_STACK_SIZE
+#define PAL_SECONDARY_STACK_SIZE  0x1000
+#endif
+#define SECONDARY_STACK_ALIGN     64
+#define PSCI_RET_DENIED           ((UINT64)-3)
+#define SECONDARY_STACK_CANARY    0xDEADC0DEFEEDFACEULL
 #define UPDATE_AFF_MAX(src,dest,mask)  ((dest & mask) > (src & mask) ? (dest & mask) : (src & mask))
 
 UINT64
@@ -79,37 +88,114 @@ PalGetMaxMpidr()
 }
 
 /**
-  @brief  Allocate memory region for secondary PE stack use. SIZE of stack for each PE
-          is a #define
+  @brief   Return the size of the Stack of each Secondary PE.
+  @param   None
+  @return  Stack size in bytes
+**/
+UINT64
+PalGetSecondaryStackSize()
+{
+
+  return gSecondaryStackSize;
+}
 
-  @param  mpidr Pass MIPDR register content
+/**
+  @brief   Return the MPIDR list the Secondary PE entry point searches for its
+           PE index. Entry n holds the MPIDR of PE index n.
+  @param   None
+  @return  base address of the MPIDR list
+**/
+UINT64
+PalGetSecondaryPeMpidrList()
+{
+
+  return (UINT64)gSecondaryPeMpidr;
+}
+
+/**
+  @brief  Allocate memory region for secondary PE stack use. Stacks are indexed
+          by PE index, so the region scales with the number of PEs. Each stack
+          is a cache line multiple, so neighbouring PEs do not share a line,
+          and has a canary at its lowest address to detect overflow.
+
+  @param  PeTable PE Info table, to map MPIDRs to PE indexes
   @return  None
 **/
 VOID
-PalAllocateSecondaryStack(UINT64 mpidr)
+PalAllocateSecondaryStack(PE_INFO_TABLE *PeTable)
 {
   EFI_STATUS Status;
-  UINT32 NumPe, Aff0, Aff1, Aff2, Aff3;
-
-  Aff0 = ((mpidr & 0x00000000ff) >>  0);
-  Aff1 = ((mpidr & 0x000000ff00) >>  8);
-  Aff2 = ((mpidr & 0x0000ff0000) >> 16);
-  Aff3 = ((mpidr & 0xff00000000) >> 32);
+  EFI_PHYSICAL_ADDRESS Address;
+  UINT32 NumPe, Index;
 
-  NumPe = ((Aff3+1) * (Aff2+1) * (Aff1+1) * (Aff0+1));
+  NumPe = PeTable->header.num_of_pe;
 
   if (gSecondaryPeStack == NULL) {
-      Status = gBS->AllocatePool ( EfiBootServicesData,
-                    (NumPe * SIZE_STACK_SECONDARY_PE),
-                    (VOID **) &gSecondaryPeStack);
+      gSecondaryStackSize = (PAL_SECONDARY_STACK_SIZE + SECONDARY_STACK_ALIGN - 1) &
+                            ~((UINT64)SECONDARY_STACK_ALIGN - 1);
+
+      /* Page allocation keeps the region, and so each stack, cache line aligned */
+      Status = gBS->AllocatePages (AllocateAnyPages, EfiBootServicesData,
+                    EFI_SIZE_TO_PAGES(NumPe * gSecondaryStackSize),
+                    &Address);
       if (EFI_ERROR(Status)) {
           bsa_print(ACS_PRINT_ERR, L"\n FATAL - Allocation for Seconday stack failed %x \n", Status);
+          return;
+      }
+      gSecondaryPeStack = (UINT8 *)Address;
+
+      Status = gBS->AllocatePool (EfiBootServicesData,
+                    NumPe * sizeof(UINT64),
+                    (VOID **) &gSecondaryPeMpidr);
+      if (EFI_ERROR(Status)) {
+          bsa_print(ACS_PRINT_ERR, L"\n FATAL - Allocation for Seconday MPIDR list failed %x \n",
+                    Status);
+          /* Without the list no secondary PE can find its stack */
+          gBS->FreePages((EFI_PHYSICAL_ADDRESS)(UINTN)gSecondaryPeStack,
+                         EFI_SIZE_TO_PAGES(NumPe * gSecondaryStackSize));
+          gSecondaryPeStack = NULL;
+          gSecondaryPeMpidr = NULL;
+          return;
       }
+
+      for (Index = 0; Index < NumPe; Index++) {
+          gSecondaryPeMpidr[Index] = PeTable->pe_info[Index].mpidr;
+          *(UINT64 *)(gSecondaryPeStack + (Index * gSecondaryStackSize)) = SECONDARY_STACK_CANARY;
+      }
+
+      /* Secondary PEs read these with caches off, push them to memory */
+      pal_pe_data_cache_ops_by_range((UINT64)gSecondaryPeStack, NumPe * gSecondaryStackSize,
+                                     CLEAN_AND_INVALIDATE);
+      pal_pe_data_cache_ops_by_range((UINT64)gSecondaryPeMpidr, NumPe * sizeof(UINT64),
+                                     CLEAN_AND_INVALIDATE);
       pal_pe_data_cache_ops_by_va((UINT64)&gSecondaryPeStack, CLEAN_AND_INVALIDATE);
+      pal_pe_data_cache_ops_by_va((UINT64)&gSecondaryPeMpidr, CLEAN_AND_INVALIDATE);
+      pal_pe_data_cache_ops_by_va((UINT64)&gSecondaryStackSize, CLEAN_AND_INVALIDATE);
+      pal_pe_data_cache_ops_by_va((UINT64)&g_num_pe, CLEAN_AND_INVALIDATE);
   }
 
 }
 
+/**
+  @brief  Check the canary at the bottom of the Stack of a Secondary PE
+
+  @param  Index PE index
+  @return  0 if the canary is intact, 1 if the Stack has overflowed
+**/
+UINT32
+pal_pe_secondary_stack_overflow(UINT32 Index)
+{
+  UINT64 *Canary;
+
+  if ((gSecondaryPeStack == NULL) || (Index >= g_num_pe))
+      return 0;
+
+  Canary = (UINT64 *)(gSecondaryPeStack + (Index * gSecondaryStackSize));
+  pal_pe_data_cache_ops_by_va((UINT64)Canary, INVALIDATE);
+
+  return (*Canary != SECONDARY_STACK_CANARY);
+}
+
 /**
   @brief  This API fills in the PE_INFO Table with information about the PEs in the
           system. This is achieved by parsing the ACPI - MADT table.
@@ -158,7 +244,6 @@ pal_pe_create_info_table(PE_INFO_TABLE *PeTable)
       Ptr->pmu_gsiv   = Entry->PerformanceInterruptGsiv;
       Ptr->gmain_gsiv = Entry->VGICMaintenanceInterrupt;
       bsa_print(ACS_PRINT_DEBUG, L"  MPIDR %x PE num %x \n", Ptr->mpidr, Ptr->pe_num);
-      pal_pe_data_cache_ops_by_va((UINT64)Ptr, CLEAN_AND_INVALIDATE);
       Ptr++;
       PeTable->header.num_of_pe++;
 
@@ -175,9 +260,11 @@ pal_pe_create_info_table(PE_INFO_TABLE *PeTable)
 
   gMpidrMax = MpidrAff0Max | MpidrAff1Max | MpidrAff2Max | MpidrAff3Max;
   g_num_pe = PeTable->header.num_of_pe;
-  pal_pe_data_cache_ops_by_va((UINT64)PeTable, CLEAN_AND_INVALIDATE);
+  pal_pe_data_cache_ops_by_range((UINT64)PeTable, sizeof(PE_INFO_HDR) +
+                                 (PeTable->header.num_of_pe * sizeof(PE_INFO_ENTRY)),
+                                 CLEAN_AND_INVALIDATE);
   pal_pe_data_cache_ops_by_va((UINT64)&gMpidrMax, CLEAN_AND_INVALIDATE);
-  PalAllocateSecondaryStack(gMpidrMax);
+  PalAllocateSecondaryStack(PeTable);
 
 }
 
@@ -248,6 +335,12 @@ ModuleEntryPoint();
 VOID
 pal_pe_execute_payload(ARM_SMC_ARGS *ArmSmcArgs)
 {
+  /* The PE would have no stack to run on, fail the CPU_ON instead */
+  if ((gSecondaryPeStack == NULL) || (gSecondaryPeMpidr == NULL)) {
+      ArmSmcArgs->Arg0 = PSCI_RET_DENIED;
+      return;
+  }
+
   ArmSmcArgs->Arg2 = (UINT64)ModuleEntryPoint;
   pal_pe_call_smc(ArmSmcArgs);
 }
@@ -298,6 +391,21 @@ DataCacheCleanInvalidateVA(UINT64 addr);
 VOID
 DataCacheCleanVA(UINT64 addr);
 
+VOID
+DataCacheCleanInvalidateRange(UINT64 addr, UINT64 len);
+
+VOID
+DataCacheCleanRange(UINT64 addr, UINT64 len);
+
+VOID
+DataCacheInvalidateRange(UINT64 addr, UINT64 len);
+
+VOID
+DataCacheCleanInvalidateAll(VOID);
+
+VOID
+DataCacheCleanAll(VOID);
+
 VOID
 DataCacheInvalidateVA(UINT64 addr);
 
@@ -327,3 +435,51 @@ pal_pe_data_cache_ops_by_va(UINT64 addr, UINT32 type)
   }
 
 }
+
+/**
+  @brief Perform cache maintenance operation on an address range, with a single
+         barrier after the last line
+
+  @param addr - start address of the range
+  @param len  - length of the range in bytes
+  @param type - type of cache ops
+
+  @return  None
+**/
+VOID
+pal_pe_data_cache_ops_by_range(UINT64 addr, UINT64 len, UINT32 type)
+{
+  switch(type){
+      case CLEAN_AND_INVALIDATE:
+          DataCacheCleanInvalidateRange(addr, len);
+      break;
+      case CLEAN:
+          DataCacheCleanRange(addr, len);
+      break;
+      case INVALIDATE:
+          DataCacheInvalidateRange(addr, len);
+      break;
+      default:
+          DataCacheCleanInvalidateRange(addr, len);
+  }
+
+}
+
+/**
+  @brief Perform cache maintenance operation on the whole data cache hierarchy
+         up to the Level of Coherency, by set/way. Invalidate without clean
+         would drop live data, so INVALIDATE is performed as clean and
+         invalidate.
+
+  @param type - type of cache ops
+
+  @return  None
+**/
+VOID
+pal_pe_data_cache_ops_by_set_way(UINT32 type)
+{
+  if (type == CLEAN)
+      DataCacheCleanAll();
+  else
+      DataCacheCleanInvalidateAll();
+}
@@ -122,6 +122,7 @@ pal_peripheral_create_info_table(PERIPHERAL_INFO_TABLE *peripheralInfoTable)
          per_info->baud_rate = 0;
 
     per_info->interface_type = spcr->InterfaceType;
+    per_info->access_width = spcr->BaseAddress.AccessSize;
     per_info++;
   }
 
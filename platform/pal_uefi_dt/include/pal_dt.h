@@ -59,6 +59,18 @@ fdt_frame_number(const void *fdt, int nodeoffset);
 int
 fdt_interrupt_cells(const void *fdt, int nodeoffset);
 
+int
+pal_dt_node_offset_by_compatible(const void *fdt, int startoffset, const char *compatible);
+
+int
+pal_dt_node_offset_by_phandle(const void *fdt, UINT32 phandle);
+
+int
+pal_dt_parent_offset(const void *fdt, int nodeoffset);
+
+int
+pal_dt_interrupt_parent_offset(const void *fdt, int nodeoffset);
+
 
 
 /*-----------------DEBUG FUNCTION----------------*/
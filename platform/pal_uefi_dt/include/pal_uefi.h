@@ -68,6 +68,8 @@ typedef struct {
 }PE_INFO_TABLE;
 
 VOID     pal_pe_data_cache_ops_by_va(UINT64 addr, UINT32 type);
+VOID     pal_pe_data_cache_ops_by_range(UINT64 addr, UINT64 len, UINT32 type);
+VOID     pal_pe_data_cache_ops_by_set_way(UINT32 type);
 
 #define CLEAN_AND_INVALIDATE  0x1
 #define CLEAN                 0x2
@@ -409,5 +411,6 @@ VOID    *pal_mem_phys_to_virt(UINT64 pa);
 UINT64  pal_memory_get_unpopulated_addr(UINT64 *addr, UINT32 instance);
 
 UINT32 pal_pe_get_num();
+UINT32 pal_pe_secondary_stack_overflow(UINT32 Index);
 
 #endif
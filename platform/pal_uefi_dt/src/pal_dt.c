@@ -79,6 +79,507 @@ pal_get_dt_ptr()
   return (UINT64) DTB;
 }
 
+/**
+  @brief  Fold one firmware table into the platform hash
+
+  @param  Hash    Running hash
+  @param  Table   Table address
+  @param  Length  Table length in bytes
+
+  @return Updated hash
+**/
+STATIC
+UINT64
+PalPlatformHashAdd (
+  UINT64 Hash,
+  VOID   *Table,
+  UINTN  Length
+  )
+{
+  UINT32 Crc = 0;
+
+  if (EFI_ERROR(gBS->CalculateCrc32(Table, Length, &Crc)))
+    return 0;
+
+  Hash = (Hash ^ Length) * 0x100000001B3ULL;
+  Hash = (Hash ^ Crc) * 0x100000001B3ULL;
+  return Hash;
+}
+
+/**
+  @brief  Hash of the DT blob. Used to tell whether a saved platform
+          snapshot still describes this platform.
+
+  @param  None
+
+  @return 64-bit hash, 0 if the blob cannot be found
+**/
+UINT64
+pal_get_platform_hash()
+{
+  VOID *Fdt;
+
+  Fdt = (VOID *) pal_get_dt_ptr();
+  if (Fdt == NULL)
+      return 0;
+
+  return PalPlatformHashAdd(0xCBF29CE484222325ULL, Fdt, fdt_totalsize(Fdt));
+}
+
+/* Device tree index. The *_dt table builders look nodes up by compatible
+   string, parent and phandle many times over, and libfdt answers each of
+   those with a linear walk of the structure block. The index below is built
+   with a single walk of the blob on first use and answers the same queries
+   from memory. */
+
+#define DT_INDEX_MAX_DEPTH   64
+#define DT_INDEX_MIN_BUCKETS 16
+
+typedef struct {
+  INT32  Offset;           /* Node offset in the structure block */
+  INT32  Parent;           /* Parent node offset, -FDT_ERR_NOTFOUND for root */
+  INT32  IntParent;        /* interrupt-parent node offset, else Parent */
+  UINT32 Phandle;          /* Own phandle, 0 if none */
+  UINT32 IntParentPhandle; /* interrupt-parent phandle, 0 if none */
+} DT_INDEX_NODE;
+
+typedef struct {
+  const CHAR8 *Compat;     /* Points into the blob */
+  UINT32      Hash;
+  INT32       First;       /* First reference in DT order */
+  INT32       Last;        /* Last reference in DT order */
+  INT32       Next;        /* Next entry in the same hash bucket */
+} DT_INDEX_COMPAT;
+
+typedef struct {
+  INT32 Node;              /* Index into the node array */
+  INT32 Next;              /* Next node with the same compatible string */
+} DT_INDEX_REF;
+
+typedef struct {
+  const VOID      *Fdt;
+  UINT32          Valid;
+  UINT32          NumNodes;
+  DT_INDEX_NODE   *Nodes;
+  UINT32          NumCompat;
+  DT_INDEX_COMPAT *Compat;
+  INT32           *CompatBucket;
+  UINT32          CompatMask;
+  UINT32          NumRefs;
+  DT_INDEX_REF    *Refs;
+  INT32           *PhandleBucket;  /* Holds node index + 1, 0 when empty */
+  UINT32          PhandleMask;
+} DT_INDEX;
+
+STATIC DT_INDEX g_dt_index;
+
+STATIC
+UINT32
+pal_dt_index_hash_str(const CHAR8 *Str)
+{
+  UINT32 Hash = 2166136261U;
+
+  while (*Str) {
+    Hash ^= (UINT8)*Str++;
+    Hash *= 16777619U;
+  }
+  return Hash;
+}
+
+STATIC
+UINT32
+pal_dt_index_buckets(UINT32 Count)
+{
+  UINT32 Size = DT_INDEX_MIN_BUCKETS;
+
+  while (Size < (2 * Count))
+    Size <<= 1;
+  return Size;
+}
+
+/**
+  @brief  Walk the blob once to size the index
+
+  @param  Fdt       Address of fdt blob
+  @param  NumNodes  Number of nodes found
+  @param  NumRefs   Number of compatible strings found across all nodes
+
+  @return 0 on success, 1 if the tree is deeper than the index supports
+**/
+STATIC
+UINT32
+pal_dt_index_count(const VOID *Fdt, UINT32 *NumNodes, UINT32 *NumRefs)
+{
+  const CHAR8 *Prop;
+  INT32 Offset;
+  INT32 Depth = -1;
+  INT32 Len;
+  INT32 Pos;
+
+  *NumNodes = 0;
+  *NumRefs = 0;
+
+  for (Offset = fdt_next_node(Fdt, -1, &Depth);
+       (Offset >= 0) && (Depth >= 0); Offset = fdt_next_node(Fdt, Offset, &Depth)) {
+      if (Depth >= DT_INDEX_MAX_DEPTH)
+          return 1;
+
+      (*NumNodes)++;
+      Prop = fdt_getprop(Fdt, Offset, "compatible", &Len);
+      if (Prop == NULL)
+          continue;
+
+      for (Pos = 0; Pos < Len; Pos += AsciiStrLen(Prop + Pos) + 1)
+          (*NumRefs)++;
+  }
+
+  return 0;
+}
+
+/**
+  @brief  Find or insert the compatible entry for a string
+
+  @param  Index   Device tree index being built
+  @param  Compat  NUL terminated compatible string inside the blob
+
+  @return Index of the compatible entry
+**/
+STATIC
+INT32
+pal_dt_index_compat_entry(DT_INDEX *Index, const CHAR8 *Compat)
+{
+  DT_INDEX_COMPAT *Entry;
+  UINT32 Hash;
+  INT32  *Slot;
+  INT32  i;
+
+  Hash = pal_dt_index_hash_str(Compat);
+  Slot = &Index->CompatBucket[Hash & Index->CompatMask];
+
+  for (i = *Slot; i >= 0; i = Index->Compat[i].Next) {
+      if ((Index->Compat[i].Hash == Hash) && !AsciiStrCmp(Index->Compat[i].Compat, Compat))
+          return i;
+  }
+
+  i = Index->NumCompat++;
+  Entry = &Index->Compat[i];
+  Entry->Compat = Compat;
+  Entry->Hash   = Hash;
+  Entry->First  = -1;
+  Entry->Last   = -1;
+  Entry->Next   = *Slot;
+  *Slot = i;
+
+  return i;
+}
+
+/**
+  @brief  Build the compatible, phandle and interrupt-parent maps of the blob
+
+  1. Caller       -  Index lookups, on first use for a given blob.
+
+  @param  Index  Device tree index to fill
+  @param  Fdt    Address of fdt blob
+
+  @return 0 on success, 1 on failure (lookups then fall back to libfdt)
+**/
+STATIC
+UINT32
+pal_dt_index_build(DT_INDEX *Index, const VOID *Fdt)
+{
+  EFI_STATUS    Status;
+  DT_INDEX_NODE *Node;
+  const CHAR8   *Prop;
+  INT32         Stack[DT_INDEX_MAX_DEPTH];
+  INT32         Offset;
+  INT32         Depth = -1;
+  INT32         Len;
+  INT32         Pos;
+  INT32         Entry;
+  INT32         Ref;
+  UINT32        NumNodes;
+  UINT32        NumRefs;
+  UINT32        CompatBuckets;
+  UINT32        PhandleBuckets;
+  UINT32        Slot;
+  UINT32        i;
+  UINT8         *Buffer;
+  UINTN         Size;
+
+  if (pal_dt_index_count(Fdt, &NumNodes, &NumRefs))
+      return 1;
+
+  CompatBuckets  = pal_dt_index_buckets(NumRefs);
+  PhandleBuckets = pal_dt_index_buckets(NumNodes);
+
+  Size = (NumRefs * sizeof(DT_INDEX_COMPAT)) + (NumNodes * sizeof(DT_INDEX_NODE)) +
+         (NumRefs * sizeof(DT_INDEX_REF)) + ((CompatBuckets + PhandleBuckets) * sizeof(INT32));
+
+  Status = gBS->AllocatePool(EfiBootServicesData, Size, (VOID **) &Buffer);
+  if (EFI_ERROR(Status)) {
+      bsa_print(ACS_PRINT_WARN, L" DT index allocation failed, using libfdt lookups\n");
+      return 1;
+  }
+
+  Index->Compat        = (DT_INDEX_COMPAT *) Buffer;
+  Index->Nodes         = (DT_INDEX_NODE *) (Index->Compat + NumRefs);
+  Index->Refs          = (DT_INDEX_REF *) (Index->Nodes + NumNodes);
+  Index->CompatBucket  = (INT32 *) (Index->Refs + NumRefs);
+  Index->PhandleBucket = Index->CompatBucket + CompatBuckets;
+  Index->CompatMask    = CompatBuckets - 1;
+  Index->PhandleMask   = PhandleBuckets - 1;
+  Index->NumCompat     = 0;
+  Index->NumNodes      = 0;
+  Index->NumRefs       = 0;
+
+  SetMem(Index->CompatBucket, CompatBuckets * sizeof(INT32), 0xFF);
+  SetMem(Index->PhandleBucket, PhandleBuckets * sizeof(INT32), 0);
+
+  for (Offset = fdt_next_node(Fdt, -1, &Depth);
+       (Offset >= 0) && (Depth >= 0); Offset = fdt_next_node(Fdt, Offset, &Depth)) {
+
+      Stack[Depth] = Index->NumNodes;
+      Node = &Index->Nodes[Index->NumNodes++];
+      Node->Offset  = Offset;
+      Node->Parent  = (Depth > 0) ? Index->Nodes[Stack[Depth - 1]].Offset : -FDT_ERR_NOTFOUND;
+      Node->Phandle = fdt_get_phandle(Fdt, Offset);
+
+      Prop = fdt_getprop(Fdt, Offset, "interrupt-parent", &Len);
+      Node->IntParentPhandle = (Prop != NULL) ? fdt32_to_cpu(*(const fdt32_t *)Prop) : 0;
+
+      if ((Node->Phandle != 0) && (Node->Phandle != (UINT32)-1)) {
+          Slot = (Node->Phandle * 0x9E3779B1U) & Index->PhandleMask;
+          while (Index->PhandleBucket[Slot] != 0)
+              Slot = (Slot + 1) & Index->PhandleMask;
+          Index->PhandleBucket[Slot] = Index->NumNodes;
+      }
+
+      Prop = fdt_getprop(Fdt, Offset, "compatible", &Len);
+      if (Prop == NULL)
+          continue;
+
+      for (Pos = 0; Pos < Len; Pos += AsciiStrLen(Prop + Pos) + 1) {
+          Entry = pal_dt_index_compat_entry(Index, Prop + Pos);
+
+          /* A node listing the same string twice is only recorded once */
+          if ((Index->Compat[Entry].Last >= 0) &&
+              (Index->Refs[Index->Compat[Entry].Last].Node == Stack[Depth]))
+              continue;
+
+          Ref = Index->NumRefs++;
+          Index->Refs[Ref].Node = Stack[Depth];
+          Index->Refs[Ref].Next = -1;
+          if (Index->Compat[Entry].Last >= 0)
+              Index->Refs[Index->Compat[Entry].Last].Next = Ref;
+          else
+              Index->Compat[Entry].First = Ref;
+          Index->Compat[Entry].Last = Ref;
+      }
+  }
+
+  Index->Fdt   = Fdt;
+  Index->Valid = 1;
+
+  /* Phandles may point forward, so interrupt parents are resolved last */
+  for (i = 0; i < Index->NumNodes; i++) {
+      Node = &Index->Nodes[i];
+      if (Node->IntParentPhandle)
+          Node->IntParent = pal_dt_node_offset_by_phandle(Fdt, Node->IntParentPhandle);
+      else
+          Node->IntParent = Node->Parent;
+  }
+
+  bsa_print(ACS_PRINT_DEBUG, L"  DT index: %d nodes", Index->NumNodes);
+  bsa_print(ACS_PRINT_DEBUG, L", %d compatible strings\n", Index->NumCompat);
+
+  return 0;
+}
+
+/**
+  @brief  Return the index for a blob, building it on first use
+
+  @param  Fdt  Address of fdt blob
+
+  @return Index, or NULL when lookups must fall back to libfdt
+**/
+STATIC
+DT_INDEX *
+pal_dt_index_get(const VOID *Fdt)
+{
+  if (Fdt == NULL)
+      return NULL;
+
+  if (g_dt_index.Fdt != Fdt) {
+      if (g_dt_index.Valid && g_dt_index.Compat)
+          gBS->FreePool(g_dt_index.Compat);
+
+      ZeroMem(&g_dt_index, sizeof(g_dt_index));
+      if (pal_dt_index_build(&g_dt_index, Fdt)) {
+          if (g_dt_index.Compat)
+              gBS->FreePool(g_dt_index.Compat);
+          ZeroMem(&g_dt_index, sizeof(g_dt_index));
+          /* Remember the failure so the walk is not retried per lookup */
+          g_dt_index.Fdt = Fdt;
+      }
+  }
+
+  return g_dt_index.Valid ? &g_dt_index : NULL;
+}
+
+/**
+  @brief  Find the index entry of a node offset
+
+  @param  Index       Device tree index
+  @param  nodeoffset  Node offset to look up
+
+  @return Pointer to the node entry, NULL if the offset is not a node
+**/
+STATIC
+DT_INDEX_NODE *
+pal_dt_index_node(DT_INDEX *Index, int nodeoffset)
+{
+  UINT32 Low = 0;
+  UINT32 High = Index->NumNodes;
+  UINT32 Mid;
+
+  while (Low < High) {
+      Mid = Low + ((High - Low) / 2);
+      if (Index->Nodes[Mid].Offset == nodeoffset)
+          return &Index->Nodes[Mid];
+      if (Index->Nodes[Mid].Offset < nodeoffset)
+          Low = Mid + 1;
+      else
+          High = Mid;
+  }
+
+  return NULL;
+}
+
+/**
+  @brief  Indexed equivalent of fdt_node_offset_by_compatible
+
+  @param  fdt          Address of fdt blob
+  @param  startoffset  Offset after which to search, -1 to search from the root
+  @param  compatible   Compatible string to match
+
+  @return Offset of the next matching node, or -FDT_ERR_NOTFOUND
+**/
+int pal_dt_node_offset_by_compatible(const void *fdt, int startoffset, const char *compatible)
+{
+  DT_INDEX *Index;
+  UINT32 Hash;
+  INT32  Entry;
+  INT32  Ref;
+
+  Index = pal_dt_index_get(fdt);
+  if (Index == NULL)
+      return fdt_node_offset_by_compatible(fdt, startoffset, compatible);
+
+  Hash = pal_dt_index_hash_str(compatible);
+  for (Entry = Index->CompatBucket[Hash & Index->CompatMask]; Entry >= 0;
+       Entry = Index->Compat[Entry].Next) {
+      if ((Index->Compat[Entry].Hash == Hash) &&
+          !AsciiStrCmp(Index->Compat[Entry].Compat, compatible))
+          break;
+  }
+
+  if (Entry < 0)
+      return -FDT_ERR_NOTFOUND;
+
+  for (Ref = Index->Compat[Entry].First; Ref >= 0; Ref = Index->Refs[Ref].Next) {
+      if (Index->Nodes[Index->Refs[Ref].Node].Offset > startoffset)
+          return Index->Nodes[Index->Refs[Ref].Node].Offset;
+  }
+
+  return -FDT_ERR_NOTFOUND;
+}
+
+/**
+  @brief  Indexed equivalent of fdt_node_offset_by_phandle
+
+  @param  fdt      Address of fdt blob
+  @param  phandle  Phandle to resolve
+
+  @return Offset of the node with that phandle, or a negative FDT error
+**/
+int pal_dt_node_offset_by_phandle(const void *fdt, UINT32 phandle)
+{
+  DT_INDEX *Index;
+  UINT32 Slot;
+  INT32  Node;
+
+  Index = pal_dt_index_get(fdt);
+  if (Index == NULL)
+      return fdt_node_offset_by_phandle(fdt, phandle);
+
+  if ((phandle == 0) || (phandle == (UINT32)-1))
+      return -FDT_ERR_BADPHANDLE;
+
+  Slot = (phandle * 0x9E3779B1U) & Index->PhandleMask;
+  while ((Node = Index->PhandleBucket[Slot]) != 0) {
+      if (Index->Nodes[Node - 1].Phandle == phandle)
+          return Index->Nodes[Node - 1].Offset;
+      Slot = (Slot + 1) & Index->PhandleMask;
+  }
+
+  return -FDT_ERR_NOTFOUND;
+}
+
+/**
+  @brief  Indexed equivalent of fdt_parent_offset
+
+  @param  fdt         Address of fdt blob
+  @param  nodeoffset  Offset of the child node
+
+  @return Offset of the parent node, or a negative FDT error
+**/
+int pal_dt_parent_offset(const void *fdt, int nodeoffset)
+{
+  DT_INDEX      *Index;
+  DT_INDEX_NODE *Node;
+
+  Index = pal_dt_index_get(fdt);
+  if (Index == NULL)
+      return fdt_parent_offset(fdt, nodeoffset);
+
+  Node = pal_dt_index_node(Index, nodeoffset);
+  if (Node == NULL)
+      return -FDT_ERR_BADOFFSET;
+
+  return Node->Parent;
+}
+
+/**
+  @brief  Next node up the interrupt tree: the node named by the
+          interrupt-parent property, or the parent node when it has none
+
+  @param  fdt         Address of fdt blob
+  @param  nodeoffset  Offset of the node
+
+  @return Offset of the next node in the interrupt tree, or a negative FDT error
+**/
+int pal_dt_interrupt_parent_offset(const void *fdt, int nodeoffset)
+{
+  DT_INDEX      *Index;
+  DT_INDEX_NODE *Node;
+  const fdt32_t *ip;
+  int len;
+
+  Index = pal_dt_index_get(fdt);
+  if (Index == NULL) {
+      ip = fdt_getprop(fdt, nodeoffset, "interrupt-parent", &len);
+      if (ip)
+          return fdt_node_offset_by_phandle(fdt, fdt32_to_cpu(*ip));
+      return fdt_parent_offset(fdt, nodeoffset);
+  }
+
+  Node = pal_dt_index_node(Index, nodeoffset);
+  if (Node == NULL)
+      return -FDT_ERR_BADOFFSET;
+
+  return Node->IntParent;
+}
+
 /**
   @brief   Get frame number from given node
   @param  fdt - 64-bit FDT blob address
@@ -122,11 +623,7 @@ int fdt_interrupt_cells(const void *fdt, int nodeoffset)
       if (ic > 0)
           break;
 
-      ic = fdt_getprop(fdt, nodeoffset, "interrupt-parent", &len);
-      if (ic > 0)
-          nodeoffset = fdt_node_offset_by_phandle(fdt, (uint32_t)(fdt32_to_cpu(*ic)));
-      else
-          nodeoffset = fdt_parent_offset(fdt, nodeoffset);
+      nodeoffset = pal_dt_interrupt_parent_offset(fdt, nodeoffset);
 
   } while (nodeoffset >= 0);
 
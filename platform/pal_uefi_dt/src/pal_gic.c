@@ -92,7 +92,7 @@ pal_pe_info_table_gmaint_gsiv_dt(PE_INFO_TABLE *PeTable)
   Ptr = PeTable->pe_info;
   for (i = 0; i < (sizeof(gicv3_dt_arr)/GIC_COMPATIBLE_STR_LEN); i++) {
       /* Search for GICv3 nodes*/
-      offset = fdt_node_offset_by_compatible((const void *)dt_ptr, -1, gicv3_dt_arr[i]);
+      offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, -1, gicv3_dt_arr[i]);
       if (offset < 0) {
         bsa_print(ACS_PRINT_DEBUG, L"  GICv3 compatible value not found for index : %d\n", i);
         continue; /* Search for next compatible item*/
@@ -106,7 +106,7 @@ pal_pe_info_table_gmaint_gsiv_dt(PE_INFO_TABLE *PeTable)
   if (offset < 0) {
       for (i = 0; i < (sizeof(gicv2_dt_arr)/GIC_COMPATIBLE_STR_LEN); i++) {
           /* Search for GICv2 nodes*/
-          offset = fdt_node_offset_by_compatible((const void *)dt_ptr, -1, gicv2_dt_arr[i]);
+          offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, -1, gicv2_dt_arr[i]);
           if (offset < 0) {
               bsa_print(ACS_PRINT_DEBUG, L"  GICv2 compatible value not found for index : %d\n", i);
               continue; /* Search for next compatible item*/
@@ -408,7 +408,7 @@ pal_gic_create_info_table_dt(GIC_INFO_TABLE *GicTable)
 
   for (i = 0; i < (sizeof(gicv3_dt_arr)/GIC_COMPATIBLE_STR_LEN); i++) {
       /* Search for GICv3 nodes*/
-      offset = fdt_node_offset_by_compatible((const void *)dt_ptr, -1, gicv3_dt_arr[i]);
+      offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, -1, gicv3_dt_arr[i]);
       if (offset < 0) {
         bsa_print(ACS_PRINT_DEBUG, L"  GICv3 compatible value not found for index : %d\n", i);
         continue; /* Search for next compatible item*/
@@ -424,7 +424,7 @@ pal_gic_create_info_table_dt(GIC_INFO_TABLE *GicTable)
       bsa_print(ACS_PRINT_DEBUG, L"  GIC v3 compatible node not found\n");
       for (i = 0; i < (sizeof(gicv2_dt_arr)/GIC_COMPATIBLE_STR_LEN); i++) {
           /* Search for GICv2 nodes*/
-          offset = fdt_node_offset_by_compatible((const void *)dt_ptr, -1, gicv2_dt_arr[i]);
+          offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, -1, gicv2_dt_arr[i]);
           if (offset < 0) {
             bsa_print(ACS_PRINT_DEBUG, L"  GICv2 compatible value not found for index : %d\n", i);
             continue; /* Search for next compatible item*/
@@ -443,7 +443,7 @@ pal_gic_create_info_table_dt(GIC_INFO_TABLE *GicTable)
   }
 
   /* Read the address and size cell for decoding reg property */
-  parent_offset = fdt_parent_offset((const void *) dt_ptr, offset);
+  parent_offset = pal_dt_parent_offset((const void *) dt_ptr, offset);
 
   size_cell = fdt_size_cells((const void *) dt_ptr, parent_offset);
   bsa_print(ACS_PRINT_DEBUG, L"  NODE gic size cell %d\n", size_cell);
@@ -568,7 +568,7 @@ pal_gic_create_info_table_dt(GIC_INFO_TABLE *GicTable)
       }
 
       /* Search for GICv2m-frame nodes*/
-      offset = fdt_node_offset_by_compatible((const void *)dt_ptr, -1, gicv2m_frame_dt_arr[0]);
+      offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, -1, gicv2m_frame_dt_arr[0]);
       if (offset < 0) {
           bsa_print(ACS_PRINT_DEBUG, L"  No v2m-frame present\n", 0);
           GicEntry->type = 0xFF;
@@ -576,7 +576,7 @@ pal_gic_create_info_table_dt(GIC_INFO_TABLE *GicTable)
       }
 
       /* Read the address and size cell for decoding reg property */
-      parent_offset = fdt_parent_offset((const void *) dt_ptr, offset);
+      parent_offset = pal_dt_parent_offset((const void *) dt_ptr, offset);
 
       size_cell = fdt_size_cells((const void *) dt_ptr, parent_offset);
       bsa_print(ACS_PRINT_DEBUG, L"  NODE gic size cell %d\n", size_cell);
@@ -639,7 +639,7 @@ pal_gic_create_info_table_dt(GIC_INFO_TABLE *GicTable)
               GicEntry->spi_count = fdt32_to_cpu(Preg_val[0]);
 
           GicEntry++;
-          offset = fdt_node_offset_by_compatible((const void *)dt_ptr, offset,
+          offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, offset,
                                                  gicv2m_frame_dt_arr[0]);
       }
       bsa_print(ACS_PRINT_DEBUG, L"  Num of v2m frame %x \n", GicTable->header.num_msi_frame);
@@ -647,7 +647,7 @@ pal_gic_create_info_table_dt(GIC_INFO_TABLE *GicTable)
 
   if (GicTable->header.gic_version == 3) { /* Check if ITS sub-node present */
       /* Search for its nodes*/
-      offset = fdt_node_offset_by_compatible((const void *)dt_ptr, -1, its_dt_arr[0]);
+      offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, -1, its_dt_arr[0]);
       if (offset < 0) {
           bsa_print(ACS_PRINT_DEBUG, L"  No ITS present\n", 0);
           GicEntry->type = 0xFF;
@@ -655,7 +655,7 @@ pal_gic_create_info_table_dt(GIC_INFO_TABLE *GicTable)
       }
       while (offset != -FDT_ERR_NOTFOUND) {
           GicTable->header.num_its++;
-          offset = fdt_node_offset_by_compatible((const void *)dt_ptr, offset, its_dt_arr[0]);
+          offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, offset, its_dt_arr[0]);
       }
       bsa_print(ACS_PRINT_DEBUG, L"  Num of ITS frame %x \n", GicTable->header.num_its);
   }
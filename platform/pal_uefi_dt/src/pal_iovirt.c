@@ -599,11 +599,11 @@ pal_iovirt_create_info_table_dt(IOVIRT_INFO_TABLE *IoVirtTable)
   /* Add SMMUv3 nodes if present */
   offset = -1;
   for (i = 0; i < sizeof(smmu3_dt_arr)/SMMU_COMPATIBLE_STR_LEN; i++) {
-      offset = fdt_node_offset_by_compatible((const void *)dt_ptr, offset, smmu3_dt_arr[i]);
+      offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, offset, smmu3_dt_arr[i]);
       if (offset < 0)
           continue; /* Search for next compatible smmuv3*/
 
-      parent_offset = fdt_parent_offset((const void *) dt_ptr, offset);
+      parent_offset = pal_dt_parent_offset((const void *) dt_ptr, offset);
       bsa_print(ACS_PRINT_DEBUG, L"  Parent Node offset %d\n", offset);
 
       size_cell = fdt_size_cells((const void *) dt_ptr, parent_offset);
@@ -647,18 +647,18 @@ pal_iovirt_create_info_table_dt(IOVIRT_INFO_TABLE *IoVirtTable)
               (*data).smmu.base    = ((*data).smmu.base << 32) | fdt32_to_cpu(Preg_val[1]);
           }
           next_block = ADD_PTR(IOVIRT_BLOCK, data_map, 0);
-          offset = fdt_node_offset_by_compatible((const void *)dt_ptr, offset, smmu3_dt_arr[i]);
+          offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, offset, smmu3_dt_arr[i]);
       }
   }
 
   /* Add SMMUv2 nodes if present */
   offset = -1;
   for (i = 0; i < sizeof(smmu_dt_arr)/SMMU_COMPATIBLE_STR_LEN; i++) {
-      offset = fdt_node_offset_by_compatible((const void *)dt_ptr, offset, smmu_dt_arr[i]);
+      offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, offset, smmu_dt_arr[i]);
       if (offset < 0)
           continue; /* Search for next compatible smmuv2*/
 
-      parent_offset = fdt_parent_offset((const void *) dt_ptr, offset);
+      parent_offset = pal_dt_parent_offset((const void *) dt_ptr, offset);
       bsa_print(ACS_PRINT_DEBUG, L"  Parent Node offset %d\n", offset);
 
       size_cell = fdt_size_cells((const void *) dt_ptr, parent_offset);
@@ -702,7 +702,7 @@ pal_iovirt_create_info_table_dt(IOVIRT_INFO_TABLE *IoVirtTable)
               (*data).smmu.base    = ((*data).smmu.base << 32) | fdt32_to_cpu(Preg_val[1]);
           }
           next_block = ADD_PTR(IOVIRT_BLOCK, data_map, 0);
-          offset = fdt_node_offset_by_compatible((const void *)dt_ptr, offset, smmu_dt_arr[i]);
+          offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, offset, smmu_dt_arr[i]);
       }
   }
 
@@ -713,7 +713,7 @@ pal_iovirt_create_info_table_dt(IOVIRT_INFO_TABLE *IoVirtTable)
     return;
   }
 
-  parent_offset = fdt_parent_offset((const void *) dt_ptr, offset);
+  parent_offset = pal_dt_parent_offset((const void *) dt_ptr, offset);
   bsa_print(ACS_PRINT_DEBUG, L"  NODE pcie offset %d\n", offset);
 
   size_cell = fdt_size_cells((const void *) dt_ptr, parent_offset);
@@ -428,13 +428,13 @@ pal_pcie_create_info_table_dt(PCIE_INFO_TABLE *PcieTable)
   PcieTable->num_entries = 0;
 
   for (i = 0; i < sizeof(pci_dt_arr)/PCI_COMPATIBLE_STR_LEN ; i++) {
-      offset = fdt_node_offset_by_compatible((const void *)dt_ptr, -1, pci_dt_arr[i]);
+      offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, -1, pci_dt_arr[i]);
       if (offset < 0) {
           bsa_print(ACS_PRINT_DEBUG, L"  PCI node offset not found %d \n", offset);
           continue; /* Search for next compatible node*/
       }
 
-      parent_offset = fdt_parent_offset((const void *) dt_ptr, offset);
+      parent_offset = pal_dt_parent_offset((const void *) dt_ptr, offset);
       bsa_print(ACS_PRINT_DEBUG, L"  NODE pcie offset %d\n", offset);
 
       size_cell = fdt_size_cells((const void *) dt_ptr, parent_offset);
@@ -474,7 +474,7 @@ pal_pcie_create_info_table_dt(PCIE_INFO_TABLE *PcieTable)
           PcieTable->block[PcieTable->num_entries].segment_num = 0;
           PcieTable->block[PcieTable->num_entries].start_bus_num = fdt32_to_cpu(Pbus_val[0]);
           PcieTable->block[PcieTable->num_entries].end_bus_num = fdt32_to_cpu(Pbus_val[1]);
-          offset = fdt_node_offset_by_compatible((const void *)dt_ptr, offset, pci_dt_arr[i]);
+          offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, offset, pci_dt_arr[i]);
 
           PcieTable->num_entries++;
       }
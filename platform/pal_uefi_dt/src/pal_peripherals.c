@@ -98,14 +98,14 @@ pal_peripheral_usb_create_info_table_dt(PERIPHERAL_INFO_TABLE *peripheralInfoTab
   for (i = 0; i < (sizeof(usb_dt_compatible)/USB_COMPATIBLE_STR_LEN); i++) {
 
       /* Search for USB nodes*/
-      offset = fdt_node_offset_by_compatible((const void *)dt_ptr, -1, usb_dt_compatible[i]);
+      offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, -1, usb_dt_compatible[i]);
       if (offset < 0) {
           bsa_print(ACS_PRINT_DEBUG, L"  USB compatible value not found for index:%d\n", i);
           continue; /* Search for next compatible item*/
       }
 
       /* Get Address_cell & Size_cell length to parse reg property of timer*/
-      parent_offset = fdt_parent_offset((const void *) dt_ptr, offset);
+      parent_offset = pal_dt_parent_offset((const void *) dt_ptr, offset);
       bsa_print(ACS_PRINT_DEBUG, L"  Parent Node offset %d\n", offset);
 
       size_cell = fdt_size_cells((const void *) dt_ptr, parent_offset);
@@ -180,7 +180,7 @@ pal_peripheral_usb_create_info_table_dt(PERIPHERAL_INFO_TABLE *peripheralInfoTab
           peripheralInfoTable->header.num_usb++;
           per_info++;
           offset =
-              fdt_node_offset_by_compatible((const void *)dt_ptr, offset, usb_dt_compatible[i]);
+              pal_dt_node_offset_by_compatible((const void *)dt_ptr, offset, usb_dt_compatible[i]);
       }
   }
 }
@@ -219,14 +219,14 @@ pal_peripheral_sata_create_info_table_dt(PERIPHERAL_INFO_TABLE *peripheralInfoTa
   for (i = 0; i < (sizeof(sata_dt_compatible)/SATA_COMPATIBLE_STR_LEN); i++) {
 
       /* Search for sata node*/
-      offset = fdt_node_offset_by_compatible((const void *)dt_ptr, -1, sata_dt_compatible[i]);
+      offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, -1, sata_dt_compatible[i]);
       if (offset < 0) {
           bsa_print(ACS_PRINT_DEBUG, L"  SATA compatible value not found for index:%d\n", i);
           continue; /* Search for next compatible item*/
       }
 
       /* Get Address_cell & Size_cell length to parse reg property of timer*/
-      parent_offset = fdt_parent_offset((const void *) dt_ptr, offset);
+      parent_offset = pal_dt_parent_offset((const void *) dt_ptr, offset);
       bsa_print(ACS_PRINT_DEBUG, L"  Parent Node offset %d\n", offset);
 
       size_cell = fdt_size_cells((const void *) dt_ptr, parent_offset);
@@ -297,7 +297,7 @@ pal_peripheral_sata_create_info_table_dt(PERIPHERAL_INFO_TABLE *peripheralInfoTa
           peripheralInfoTable->header.num_sata++;
           per_info++;
           offset =
-              fdt_node_offset_by_compatible((const void *)dt_ptr, offset, sata_dt_compatible[i]);
+              pal_dt_node_offset_by_compatible((const void *)dt_ptr, offset, sata_dt_compatible[i]);
       }
   }
 }
@@ -318,7 +318,7 @@ pal_peripheral_uart_create_info_table_dt(PERIPHERAL_INFO_TABLE *peripheralInfoTa
   UINT64 dt_ptr = 0;
   UINT64 range_node_addr, parent_offset_addr;
   UINT64 temp_child_addr;
-  UINT32 *Preg, *Pintr, *Pranges;
+  UINT32 *Preg, *Pintr, *Pranges, *Pwidth;
   CHAR8  *Pstatus;
   int addr_cell, size_cell, index = 0;
   int interrupt_cell, range_node_left;
@@ -344,14 +344,14 @@ pal_peripheral_uart_create_info_table_dt(PERIPHERAL_INFO_TABLE *peripheralInfoTa
   for (i = 0; i < (sizeof(uart_dt_compatible) / UART_COMPATIBLE_STR_LEN); i++) {
 
       /* Search for uart nodes*/
-      offset = fdt_node_offset_by_compatible((const void *)dt_ptr, -1, uart_dt_compatible[i]);
+      offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, -1, uart_dt_compatible[i]);
       if (offset < 0) {
           bsa_print(ACS_PRINT_DEBUG, L"  UART compatible value not found for index:%d\n", i);
           continue; /* Search for next compatible item*/
       }
 
       /* Get Address_cell & Size_cell length to parse reg property of uart*/
-      parent_offset = fdt_parent_offset((const void *) dt_ptr, offset);
+      parent_offset = pal_dt_parent_offset((const void *) dt_ptr, offset);
       bsa_print(ACS_PRINT_DEBUG, L"  Parent Node offset %d\n", offset);
 
       size_cell = fdt_size_cells((const void *) dt_ptr, parent_offset);
@@ -376,7 +376,7 @@ pal_peripheral_uart_create_info_table_dt(PERIPHERAL_INFO_TABLE *peripheralInfoTa
               bsa_print(ACS_PRINT_DEBUG, L"  Status field length %d\n", prop_len);
               if (pal_strncmp(Pstatus, "disabled", 9) == 0) {
                   bsa_print(ACS_PRINT_DEBUG, L"  UART access is secure \n");
-                  offset = fdt_node_offset_by_compatible((const void *)dt_ptr, offset,
+                  offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, offset,
                                                           uart_dt_compatible[i]);
                   continue;
               }
@@ -406,7 +406,7 @@ pal_peripheral_uart_create_info_table_dt(PERIPHERAL_INFO_TABLE *peripheralInfoTa
   /* Start with searching current node address in parent ranges, so treat current node as child */
           range_node_offset = offset;
           range_node_addr = per_info->base0;
-          range_parent_offset = fdt_parent_offset((const void *) dt_ptr, offset);
+          range_parent_offset = pal_dt_parent_offset((const void *) dt_ptr, offset);
           parent_offset_addr = 0;
           range_node_left = 3; /* how many parent nodes will search */
           while (range_node_left > 0) {
@@ -421,11 +421,11 @@ pal_peripheral_uart_create_info_table_dt(PERIPHERAL_INFO_TABLE *peripheralInfoTa
               range_node_left--;
               if ((Pranges != NULL) && (prop_len == 0)) {// Empty ranges
                   bsa_print(ACS_PRINT_DEBUG, L"  Empty ranges is present \n");
-                  range_parent_offset = fdt_parent_offset((const void *) dt_ptr,
+                  range_parent_offset = pal_dt_parent_offset((const void *) dt_ptr,
                                                                              range_parent_offset);
               } else {
                   range_node_offset = range_parent_offset;
-                 range_parent_offset = fdt_parent_offset((const void *) dt_ptr, range_node_offset);
+                 range_parent_offset = pal_dt_parent_offset((const void *) dt_ptr, range_node_offset);
                   /* ranges = <child addr cell  parent addr cell   child size cell> */
                   child_addr_cell = fdt_address_cells((const void *) dt_ptr, range_node_offset);
                   parent_addr_cell = fdt_address_cells((const void *) dt_ptr, range_parent_offset);
@@ -511,13 +511,36 @@ pal_peripheral_uart_create_info_table_dt(PERIPHERAL_INFO_TABLE *peripheralInfoTa
           } else
               per_info->interface_type = ARM_PL011_UART;
 
+          /* reg-io-width is in bytes, the access width is a GAS access size */
+          per_info->access_width = 0;
+          Pwidth = (UINT32 *)
+                    fdt_getprop_namelen((void *)dt_ptr, offset, "reg-io-width", 12, &prop_len);
+          if ((prop_len == 4) && (Pwidth != NULL)) {
+              switch (fdt32_to_cpu(*Pwidth)) {
+                  case 1:
+                      per_info->access_width = 1;
+                      break;
+                  case 2:
+                      per_info->access_width = 2;
+                      break;
+                  case 4:
+                      per_info->access_width = 3;
+                      break;
+                  case 8:
+                      per_info->access_width = 4;
+                      break;
+                  default:
+                      break;
+              }
+          }
+
           per_info->bdf   = 0; /* NA in DT*/
           per_info->flags = 0; /* NA in DT*/
           per_info->baud_rate = 0; /* NA in DT*/
           peripheralInfoTable->header.num_uart++;
           per_info++;
           offset =
-              fdt_node_offset_by_compatible((const void *)dt_ptr, offset, uart_dt_compatible[i]);
+              pal_dt_node_offset_by_compatible((const void *)dt_ptr, offset, uart_dt_compatible[i]);
       }
   }
 }
@@ -601,6 +624,8 @@ pal_peripheral_create_info_table(PERIPHERAL_INFO_TABLE *peripheralInfoTable)
     per_info->base0 = spcr->BaseAddress.Address;
     per_info->irq   = spcr->GlobalSystemInterrupt;
     per_info->type  = PERIPHERAL_TYPE_UART;
+    per_info->interface_type = spcr->InterfaceType;
+    per_info->access_width = spcr->BaseAddress.AccessSize;
     per_info++;
   }
 
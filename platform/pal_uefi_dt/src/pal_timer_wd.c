@@ -281,13 +281,13 @@ pal_wd_create_info_table_dt(WD_INFO_TABLE *WdTable)
   }
 
   for (i = 0; i < sizeof(wd_dt_arr)/WD_COMPATIBLE_STR_LEN ; i++) {
-      offset = fdt_node_offset_by_compatible((const void *)dt_ptr, -1, wd_dt_arr[i]);
+      offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, -1, wd_dt_arr[i]);
       if (offset < 0) {
           bsa_print(ACS_PRINT_DEBUG, L"  WD node offset not found %d \n", offset);
           continue; /* Search for next compatible wd*/
       }
 
-      parent_offset = fdt_parent_offset((const void *) dt_ptr, offset);
+      parent_offset = pal_dt_parent_offset((const void *) dt_ptr, offset);
       bsa_print(ACS_PRINT_DEBUG, L"  Parent Node offset %d\n", offset);
 
       size_cell = fdt_size_cells((const void *) dt_ptr, parent_offset);
@@ -388,7 +388,7 @@ pal_wd_create_info_table_dt(WD_INFO_TABLE *WdTable)
           }
           WdEntry->wd_flags = ((wd_polarity << 1) | (wd_mode << 0));
           WdEntry++;
-          offset = fdt_node_offset_by_compatible((const void *)dt_ptr, offset, wd_dt_arr[i]);
+          offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, offset, wd_dt_arr[i]);
       }
   }
   pal_wd_platform_override(WdTable);
@@ -443,7 +443,7 @@ pal_timer_create_info_table_dt(TIMER_INFO_TABLE *TimerTable)
 
   /* Search for system timer , either V8 or V7 available*/
   for (i = 0; i < sizeof(systimer_dt_arr)/SYSTIMER_COMPATIBLE_STR_LEN ; i++) {
-      offset = fdt_node_offset_by_compatible((const void *)dt_ptr, -1, systimer_dt_arr[i]);
+      offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, -1, systimer_dt_arr[i]);
       if (offset >= 0)
         break;
   }
@@ -510,7 +510,7 @@ pal_timer_create_info_table_dt(TIMER_INFO_TABLE *TimerTable)
 
   /* Search for mem mapped timers*/
   for (i = 0; i < sizeof(memtimer_dt_arr)/MEMTIMER_COMPATIBLE_STR_LEN ; i++) {
-      offset = fdt_node_offset_by_compatible((const void *)dt_ptr, -1, memtimer_dt_arr[i]);
+      offset = pal_dt_node_offset_by_compatible((const void *)dt_ptr, -1, memtimer_dt_arr[i]);
       if (offset >= 0)
         break;
   }
@@ -520,7 +520,7 @@ pal_timer_create_info_table_dt(TIMER_INFO_TABLE *TimerTable)
   }
 
   /* Get Address_cell & Size_cell length to parse reg property of timer*/
-  parent_offset = fdt_parent_offset((const void *) dt_ptr, offset);
+  parent_offset = pal_dt_parent_offset((const void *) dt_ptr, offset);
   bsa_print(ACS_PRINT_DEBUG, L"  Parent Node offset %d\n", offset);
 
   size_cell = fdt_size_cells((const void *) dt_ptr, parent_offset);
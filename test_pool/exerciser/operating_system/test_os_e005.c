@@ -49,7 +49,7 @@ write_test_data(void *buf, uint32_t size)
     *((char8_t *)buf + index) = TEST_DATA;
   }
 
-  val_data_cache_ops_by_va((addr_t)buf, CLEAN_AND_INVALIDATE);
+  val_data_cache_ops_by_range((addr_t)buf, size, CLEAN_AND_INVALIDATE);
 }
 
 static
@@ -63,7 +63,7 @@ clear_dram_buf(void *buf, uint32_t size)
     *((char8_t *)buf + index) = 0;
   }
 
-  val_data_cache_ops_by_va((addr_t)buf, CLEAN_AND_INVALIDATE);
+  val_data_cache_ops_by_range((addr_t)buf, size, CLEAN_AND_INVALIDATE);
 }
 
 /*
@@ -82,6 +82,7 @@ payload(void)
   uint64_t e_bdf;
   uint32_t e_valid_cnt;
   uint32_t dma_len;
+  mem_compare_info_t mismatch;
   uint32_t smmu_ssid_bits;
   void *dram_buf_base_virt;
   void *dram_buf_pasid1_in_virt;
@@ -291,8 +292,9 @@ payload(void)
         goto test_fail;
     }
 
-    if (val_memory_compare(dram_buf_pasid1_in_virt, dram_buf_pasid1_out_virt, dma_len)) {
+    if (val_memory_compare_info(dram_buf_pasid1_in_virt, dram_buf_pasid1_out_virt, dma_len, &mismatch)) {
         val_print(ACS_PRINT_ERR, "\n       Data Comparision failure for Exerciser %4x", instance);
+        val_memory_print_mismatch(ACS_PRINT_ERR, &mismatch);
         goto test_fail;
     }
 
@@ -371,8 +373,9 @@ payload(void)
         goto test_fail;
     }
 
-    if (val_memory_compare(dram_buf_pasid2_in_virt, dram_buf_pasid2_out_virt, dma_len)) {
+    if (val_memory_compare_info(dram_buf_pasid2_in_virt, dram_buf_pasid2_out_virt, dma_len, &mismatch)) {
         val_print(ACS_PRINT_ERR, "\n       Data Comparison failure for Exerciser %4x", instance);
+        val_memory_print_mismatch(ACS_PRINT_ERR, &mismatch);
         goto test_fail;
     }
 
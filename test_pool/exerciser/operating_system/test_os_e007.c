@@ -55,6 +55,7 @@ test_sequence2(void *dram_buf1_virt, void *dram_buf1_phys, uint32_t e_bdf, uint3
 {
 
   uint32_t dma_len;
+  mem_compare_info_t mismatch;
   void *dram_buf2_virt;
   void *dram_buf2_phys;
 
@@ -68,7 +69,7 @@ test_sequence2(void *dram_buf1_virt, void *dram_buf1_phys, uint32_t e_bdf, uint3
 
   /* Write dram_buf2 with known data and flush the buffer to main memory */
   val_memory_set(dram_buf2_virt, dma_len, NEW_DATA);
-  val_data_cache_ops_by_va((addr_t)dram_buf2_virt, CLEAN_AND_INVALIDATE);
+  val_data_cache_ops_by_range((addr_t)dram_buf2_virt, dma_len, CLEAN_AND_INVALIDATE);
 
   /* Perform DMA OUT to copy contents of dram_buf2 to exerciser memory */
   val_exerciser_set_param(DMA_ATTRIBUTES, (uint64_t)dram_buf2_phys, dma_len, instance);
@@ -85,12 +86,13 @@ test_sequence2(void *dram_buf1_virt, void *dram_buf1_phys, uint32_t e_bdf, uint3
   }
 
   /* Invalidate dram_buf1 and dram_buf2 contents present in CPU caches */
-  val_data_cache_ops_by_va((addr_t)dram_buf1_virt, INVALIDATE);
-  val_data_cache_ops_by_va((addr_t)dram_buf2_virt, INVALIDATE);
+  val_data_cache_ops_by_range((addr_t)dram_buf1_virt, dma_len, INVALIDATE);
+  val_data_cache_ops_by_range((addr_t)dram_buf2_virt, dma_len, INVALIDATE);
 
   /* Compare the contents of ddr_buf1 and ddr_buf2 for NEW_DATA */
-  if (val_memory_compare(dram_buf1_virt, dram_buf2_virt, dma_len)) {
+  if (val_memory_compare_info(dram_buf2_virt, dram_buf1_virt, dma_len, &mismatch)) {
       val_print(ACS_PRINT_ERR, "\n        I/O coherency failure for Exerciser %4x", instance);
+      val_memory_print_mismatch(ACS_PRINT_ERR, &mismatch);
       return 1;
   }
 
@@ -103,6 +105,7 @@ test_sequence1(void *dram_buf1_virt, void *dram_buf1_phys, uint32_t e_bdf, uint3
 {
 
   uint32_t dma_len;
+  mem_compare_info_t mismatch;
   void *dram_buf2_virt;
 
   dram_buf2_virt = dram_buf1_virt + (TEST_DATA_BLK_SIZE / 2);
@@ -110,7 +113,7 @@ test_sequence1(void *dram_buf1_virt, void *dram_buf1_phys, uint32_t e_bdf, uint3
 
   /* Write dram_buf1 with known data and flush the buffer to main memory */
   val_memory_set(dram_buf1_virt, dma_len, KNOWN_DATA);
-  val_data_cache_ops_by_va((addr_t)dram_buf1_virt, CLEAN_AND_INVALIDATE);
+  val_data_cache_ops_by_range((addr_t)dram_buf1_virt, dma_len, CLEAN_AND_INVALIDATE);
 
   /* Write dram_buf1 cache with new data, don't flush the data to main memory */
   val_memory_set(dram_buf1_virt, dma_len, NEW_DATA);
@@ -133,11 +136,12 @@ test_sequence1(void *dram_buf1_virt, void *dram_buf1_phys, uint32_t e_bdf, uint3
   val_memory_set(dram_buf2_virt, dma_len, NEW_DATA);
 
   /* Invalidate dram_buf1 contents present in CPU caches */
-  val_data_cache_ops_by_va((addr_t)dram_buf1_virt, INVALIDATE);
+  val_data_cache_ops_by_range((addr_t)dram_buf1_virt, dma_len, INVALIDATE);
 
   /* Compare the contents of ddr_buf1 and ddr_buf2 for NEW_DATA */
-  if (val_memory_compare(dram_buf1_virt, dram_buf2_virt, dma_len)) {
+  if (val_memory_compare_info(dram_buf2_virt, dram_buf1_virt, dma_len, &mismatch)) {
       val_print(ACS_PRINT_ERR, "\n        I/O coherency failure for Exerciser %4x", instance);
+      val_memory_print_mismatch(ACS_PRINT_ERR, &mismatch);
       return 1;
   }
 
@@ -37,6 +37,7 @@
 #define TEST_DESC  "Check PCIe Software Coherency         "
 
 #define TEST_DATA_BLK_SIZE  (4*1024)
+/* Line tag seeds of the data written by the two sequences */
 #define NEW_DATA 0xAD
 #define NEWEST_DATA 0xBC
 
@@ -46,6 +47,9 @@ test_sequence2(void *dram_buf1_virt, void *dram_buf1_phys, uint32_t e_bdf, uint3
 {
 
   uint32_t dma_len;
+  uint32_t status;
+  mem_compare_info_t mismatch;
+  mem_pattern_t pattern;
   void *dram_buf2_virt;
   void *dram_buf2_phys;
   uint32_t tp_bit;
@@ -55,23 +59,17 @@ test_sequence2(void *dram_buf1_virt, void *dram_buf1_phys, uint32_t e_bdf, uint3
   dram_buf2_phys = dram_buf1_phys + (TEST_DATA_BLK_SIZE / 2);
   dma_len = TEST_DATA_BLK_SIZE / 2;
 
-  /* Write dram_buf2 with known data and flush the buffer to main memory */
-  val_memory_set(dram_buf2_virt, dma_len, NEWEST_DATA);
-  val_data_cache_ops_by_va((addr_t)dram_buf2_virt, CLEAN_AND_INVALIDATE);
-
-  /* Perform DMA OUT to copy contents of dram_buf2 to exerciser memory */
-  val_exerciser_set_param(DMA_ATTRIBUTES, (uint64_t)dram_buf2_phys, dma_len, instance);
-  if (val_exerciser_ops(START_DMA, EDMA_TO_DEVICE, instance)) {
-      val_print(ACS_PRINT_ERR, "\n       DMA write failure to exerciser %4x", instance);
+  /* Send NEWEST_DATA from dram_buf2 to exerciser memory and read it back
+   * into dram_buf1, which still holds NEW_DATA from the first sequence
+   */
+  pattern.type = MEM_PATTERN_LINE_TAG;
+  pattern.seed = NEWEST_DATA;
+  pattern.base = (uint64_t)dram_buf2_phys;
+  status = val_exerciser_dma_pattern(instance, dram_buf2_virt, dram_buf2_phys,
+                                     dram_buf1_virt, dram_buf1_phys, dma_len,
+                                     &pattern, &mismatch);
+  if (status == 1)
       return 1;
-  }
-
-  /* Perform DMA IN to copy content back from exerciser memory to dram_buf1 */
-  val_exerciser_set_param(DMA_ATTRIBUTES, (uint64_t)dram_buf1_phys, dma_len, instance);
-  if (val_exerciser_ops(START_DMA, EDMA_FROM_DEVICE, instance)) {
-      val_print(ACS_PRINT_ERR, "\n       DMA read failure from exerciser %4x", instance);
-      return 1;
-  }
 
   /* Check if the transaction pending bit is cleared */
   tp_bit = val_is_transaction_pending_set(e_bdf);
@@ -80,13 +78,10 @@ test_sequence2(void *dram_buf1_virt, void *dram_buf1_phys, uint32_t e_bdf, uint3
       return 1;
   }
 
-  /* Invalidate dram_buf1 and dram_buf2 contents present in CPU caches */
-  val_data_cache_ops_by_va((addr_t)dram_buf1_virt, INVALIDATE);
-  val_data_cache_ops_by_va((addr_t)dram_buf2_virt, INVALIDATE);
-
-  /* Compare the contents of ddr_buf1 and ddr_buf2 for NEW_DATA */
-  if (val_memory_compare(dram_buf1_virt, dram_buf2_virt, dma_len)) {
+  /* Check that ddr_buf1 holds NEWEST_DATA and no stale line of NEW_DATA */
+  if (status) {
       val_print(ACS_PRINT_ERR, "\n       I/O coherency failure for Exerciser %4x", instance);
+      val_memory_print_mismatch(ACS_PRINT_ERR, &mismatch);
       return 1;
   }
 
@@ -100,6 +95,9 @@ test_sequence1(void *dram_buf1_virt, void *dram_buf1_phys, uint32_t e_bdf, uint3
 {
 
   uint32_t dma_len;
+  uint32_t status;
+  mem_compare_info_t mismatch;
+  mem_pattern_t pattern;
   void *dram_buf2_virt;
   void *dram_buf2_phys;
   uint32_t tp_bit;
@@ -108,25 +106,17 @@ test_sequence1(void *dram_buf1_virt, void *dram_buf1_phys, uint32_t e_bdf, uint3
   dram_buf2_phys = dram_buf1_phys + (TEST_DATA_BLK_SIZE / 2);
   dma_len = TEST_DATA_BLK_SIZE / 2;
 
-  /* Write dram_buf1 cache with new data */
-  val_memory_set(dram_buf1_virt, dma_len, NEW_DATA);
-
-  /* Maintain software coherency */
-  val_data_cache_ops_by_va((addr_t)dram_buf1_virt, CLEAN_AND_INVALIDATE);
-
-  /* Perform DMA OUT to copy contents of dram_buf1 to exerciser memory */
-  val_exerciser_set_param(DMA_ATTRIBUTES, (uint64_t)dram_buf1_phys, dma_len, instance);
-  if (val_exerciser_ops(START_DMA, EDMA_TO_DEVICE, instance)) {
-      val_print(ACS_PRINT_ERR, "\n       DMA write failure to exerciser %4x", instance);
+  /* Write dram_buf1 cache with new data, maintain software coherency and
+   * copy it through exerciser memory into dram_buf2
+   */
+  pattern.type = MEM_PATTERN_LINE_TAG;
+  pattern.seed = NEW_DATA;
+  pattern.base = (uint64_t)dram_buf1_phys;
+  status = val_exerciser_dma_pattern(instance, dram_buf1_virt, dram_buf1_phys,
+                                     dram_buf2_virt, dram_buf2_phys, dma_len,
+                                     &pattern, &mismatch);
+  if (status == 1)
       return 1;
-  }
-
-  /* Perform DMA IN to copy the content from exerciser memory to dram_buf2 */
-  val_exerciser_set_param(DMA_ATTRIBUTES, (uint64_t)dram_buf2_phys, dma_len, instance);
-  if (val_exerciser_ops(START_DMA, EDMA_FROM_DEVICE, instance)) {
-      val_print(ACS_PRINT_ERR, "\n       DMA read failure from exerciser %4x", instance);
-      return 1;
-  }
 
   /* Check if the transaction pending bit is cleared */
   tp_bit = val_is_transaction_pending_set(e_bdf);
@@ -135,12 +125,10 @@ test_sequence1(void *dram_buf1_virt, void *dram_buf1_phys, uint32_t e_bdf, uint3
       return 1;
   }
 
-  /* Invalidate dram_buf2 contents present in CPU caches */
-  val_data_cache_ops_by_va((addr_t)dram_buf2_virt, INVALIDATE);
-
-  /* Compare the contents of ddr_buf1 and ddr_buf2 for NEW_DATA */
-  if (val_memory_compare(dram_buf1_virt, dram_buf2_virt, dma_len)) {
+  /* Check that ddr_buf2 holds NEW_DATA */
+  if (status) {
       val_print(ACS_PRINT_ERR, "\n       I/O coherency failure for Exerciser %4x", instance);
+      val_memory_print_mismatch(ACS_PRINT_ERR, &mismatch);
       return 1;
   }
 
@@ -148,7 +136,6 @@ test_sequence1(void *dram_buf1_virt, void *dram_buf1_phys, uint32_t e_bdf, uint3
   return 0;
 }
 
-
 static
 void
 payload (void)
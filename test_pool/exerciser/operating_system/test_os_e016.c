@@ -0,0 +1,463 @@
+/** @file
+ * Copyright (c) 2021, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+/* Exerciser DMA benchmark - not a compliance check. Only run with -perf.
+ *
+ * For each exerciser instance, sweep the DMA transfer size from
+ * BENCH_MIN_SIZE to BENCH_MAX_SIZE in both directions, with snoop and
+ * no-snoop TLPs, for each of:
+ *   - SMMU bypass      : SMMU disabled, DMA to the buffer PA
+ *   - SMMU translated  : stage 1 IOVA->PA mapping, no substream
+ *   - SMMU with PASID  : stage 1 mapping under BENCH_PASID, PASID TLP prefix on
+ * Every transfer is timed with the generic counter up to its completion.
+ * A device to memory transfer is complete once its last byte, poisoned
+ * before the trigger, holds the data again. A memory to device transfer is
+ * followed by a BENCH_PROBE_SIZE transfer back into a poisoned probe area,
+ * which the exerciser only performs once the first one is done, so those
+ * samples include the small probe. Per size the test reports bandwidth in
+ * GB/s and min/median/p99/max transfer latency in ns.
+ * The test only fails if DMA cannot be performed at the smallest size.
+ */
+
+#include "val/include/bsa_acs_val.h"
+#include "val/include/val_interface.h"
+
+#include "val/include/bsa_acs_pe.h"
+#include "val/include/bsa_acs_smmu.h"
+#include "val/include/bsa_acs_pgt.h"
+#include "val/include/bsa_acs_iovirt.h"
+#include "val/include/bsa_acs_pcie_enumeration.h"
+#include "val/include/bsa_acs_pcie.h"
+#include "val/include/bsa_acs_memory.h"
+#include "val/include/bsa_acs_exerciser.h"
+
+#define TEST_NUM   (ACS_EXERCISER_TEST_NUM_BASE + 16)
+#define TEST_RULE  ""
+#define TEST_DESC  "Exerciser DMA bandwidth and latency   "
+
+#define BENCH_MIN_SIZE     64
+#define BENCH_MAX_SIZE     (16 * 1024 * 1024)
+#define BENCH_ITERATIONS   100
+#define BENCH_DATA         0x5A
+#define BENCH_POISON       ((uint8_t)~BENCH_DATA)
+#define BENCH_PROBE_SIZE   64
+#define BENCH_BUF_SIZE     (BENCH_MAX_SIZE + BENCH_PROBE_SIZE)
+
+#define MIN_PASID_BITS 16
+#define BENCH_PASID    (0x1ul << (MIN_PASID_BITS - 1))
+
+#define NS_PER_SEC     1000000000ull
+
+typedef enum {
+  BENCH_SMMU_BYPASS = 0,
+  BENCH_SMMU_TRANSLATED,
+  BENCH_SMMU_PASID,
+  BENCH_SMMU_MODES
+} bench_smmu_mode_t;
+
+static char8_t *bench_mode_str[BENCH_SMMU_MODES] = {
+  "\n       SMMU bypass",
+  "\n       SMMU translated",
+  "\n       SMMU translated, PASID"
+};
+
+static uint64_t samples[BENCH_ITERATIONS];
+
+static
+uint64_t
+ticks_to_ns(uint64_t ticks, uint64_t freq)
+{
+  return (ticks * NS_PER_SEC) / freq;
+}
+
+/* Poison a byte the exerciser is about to write, making sure no dirty line
+ * can later overwrite the DMA data.
+ */
+static
+void
+bench_poison(volatile uint8_t *byte)
+{
+  *byte = BENCH_POISON;
+  val_data_cache_ops_by_va((addr_t)byte, CLEAN_AND_INVALIDATE);
+}
+
+/* Wait until the exerciser has written the poisoned byte.
+ * Returns 1 if it did not happen within a second.
+ */
+static
+uint32_t
+bench_wait_byte(volatile uint8_t *byte, uint64_t freq)
+{
+  uint64_t timeout = val_timer_get_counter() + freq;
+
+  do {
+      val_data_cache_ops_by_va((addr_t)byte, INVALIDATE);
+      if (*byte == BENCH_DATA)
+          return 0;
+  } while (val_timer_get_counter() < timeout);
+
+  return 1;
+}
+
+/* Run one transfer of size bytes and wait for it to complete.
+ * Returns 1 on failure.
+ */
+static
+uint32_t
+bench_transfer(uint32_t instance, uint8_t *buf_virt, uint64_t dma_addr, uint32_t size,
+               uint32_t direction, uint64_t freq)
+{
+  volatile uint8_t *probe = buf_virt + BENCH_MAX_SIZE;
+
+  if (direction == EDMA_FROM_DEVICE) {
+      if (val_exerciser_ops(START_DMA, EDMA_FROM_DEVICE, instance))
+          return 1;
+      return bench_wait_byte(&buf_virt[size - 1], freq);
+  }
+
+  if (val_exerciser_set_param(DMA_ATTRIBUTES, dma_addr, size, instance) ||
+      val_exerciser_ops(START_DMA, EDMA_TO_DEVICE, instance))
+      return 1;
+
+  if (val_exerciser_set_param(DMA_ATTRIBUTES, dma_addr + BENCH_MAX_SIZE, BENCH_PROBE_SIZE,
+                              instance) ||
+      val_exerciser_ops(START_DMA, EDMA_FROM_DEVICE, instance))
+      return 1;
+
+  return bench_wait_byte(probe, freq);
+}
+
+/* Time BENCH_ITERATIONS transfers for each size in the sweep and report them.
+ * The exerciser buffer holds BENCH_DATA from the memory to device sweep
+ * when the device to memory sweep runs.
+ * Returns 1 only when nothing at all could be transferred.
+ */
+static
+uint32_t
+bench_sweep(uint32_t instance, uint8_t *buf_virt, uint64_t dma_addr, uint32_t direction,
+            uint64_t freq)
+{
+  uint32_t size, iter;
+  uint64_t start, end;
+  uint64_t mbps;
+  perf_stats_t stats;
+
+  if (direction == EDMA_TO_DEVICE)
+      val_print(ACS_PRINT_TEST, "\n         Memory to device", 0);
+  else
+      val_print(ACS_PRINT_TEST, "\n         Device to memory", 0);
+  val_print(ACS_PRINT_TEST, "\n         Size(B)      GB/s    min(ns)    p50(ns)"
+                            "    p99(ns)    max(ns)", 0);
+
+  for (size = BENCH_MIN_SIZE; size <= BENCH_MAX_SIZE; size <<= 1) {
+
+      if (val_exerciser_set_param(DMA_ATTRIBUTES, dma_addr, size, instance)) {
+          val_print(ACS_PRINT_ERR, "\n       DMA attributes setting failure %4x", instance);
+          return 1;
+      }
+
+      for (iter = 0; iter < BENCH_ITERATIONS; iter++) {
+          if (direction == EDMA_FROM_DEVICE)
+              bench_poison(&buf_virt[size - 1]);
+          else
+              bench_poison(&buf_virt[BENCH_MAX_SIZE]);
+
+          start = val_timer_get_counter();
+          if (bench_transfer(instance, buf_virt, dma_addr, size, direction, freq)) {
+              /* Largest transfer the exerciser accepts has been reached */
+              if (size == BENCH_MIN_SIZE) {
+                  val_print(ACS_PRINT_ERR, "\n       DMA failure for exerciser %4x", instance);
+                  return 1;
+              }
+              val_print(ACS_PRINT_WARN, "\n         DMA of %d bytes failed, ending sweep", size);
+              return 0;
+          }
+          end = val_timer_get_counter();
+          samples[iter] = end - start;
+      }
+
+      val_perf_get_stats(samples, BENCH_ITERATIONS, &stats);
+      if (stats.total == 0)
+          stats.total = 1;
+
+      /* Bandwidth in MB/s, printed as GB/s with three decimals */
+      mbps = (((uint64_t)size * BENCH_ITERATIONS * freq) / stats.total) / 1000000;
+
+      val_print(ACS_PRINT_TEST, "\n       %9d", size);
+      val_print(ACS_PRINT_TEST, " %5d", mbps / 1000);
+      val_print(ACS_PRINT_TEST, ".%03d", mbps % 1000);
+      val_print(ACS_PRINT_TEST, " %10d", ticks_to_ns(stats.min, freq));
+      val_print(ACS_PRINT_TEST, " %10d", ticks_to_ns(stats.median, freq));
+      val_print(ACS_PRINT_TEST, " %10d", ticks_to_ns(stats.p99, freq));
+      val_print(ACS_PRINT_TEST, " %10d", ticks_to_ns(stats.max, freq));
+  }
+
+  return 0;
+}
+
+/* Run both directions with snoop and no-snoop TLPs */
+static
+uint32_t
+bench_run_config(uint32_t instance, uint8_t *buf_virt, uint64_t dma_addr, uint64_t freq)
+{
+  uint32_t no_snoop;
+
+  for (no_snoop = 0; no_snoop < 2; no_snoop++) {
+
+      if (val_exerciser_ops(no_snoop ? TXN_NO_SNOOP_ENABLE : TXN_NO_SNOOP_DISABLE, 0, instance)) {
+          val_print(ACS_PRINT_WARN, "\n       Exerciser %x No Snoop control error", instance);
+          continue;
+      }
+
+      if (no_snoop)
+          val_print(ACS_PRINT_TEST, "\n        No snoop TLPs", 0);
+      else
+          val_print(ACS_PRINT_TEST, "\n        Snoop TLPs", 0);
+
+      if (bench_sweep(instance, buf_virt, dma_addr, EDMA_TO_DEVICE, freq) ||
+          bench_sweep(instance, buf_virt, dma_addr, EDMA_FROM_DEVICE, freq)) {
+          val_exerciser_ops(TXN_NO_SNOOP_DISABLE, 0, instance);
+          return 1;
+      }
+  }
+
+  val_exerciser_ops(TXN_NO_SNOOP_DISABLE, 0, instance);
+  return 0;
+}
+
+/* Build a stage 1 identity-by-VA mapping of the benchmark buffer for this
+ * exerciser. Returns the IOVA to program into the exerciser in dma_addr.
+ */
+static
+uint32_t
+bench_smmu_map(smmu_master_attributes_t *master, pgt_descriptor_t *pgt_desc,
+               void *buf_virt, void *buf_phys, uint32_t e_bdf, uint64_t *dma_addr)
+{
+  memory_region_descriptor_t mem_desc_array[2], *mem_desc;
+  uint64_t ttbr;
+  uint32_t device_id, its_id;
+
+  val_memory_set(mem_desc_array, sizeof(mem_desc_array), 0);
+  mem_desc = &mem_desc_array[0];
+
+  if (val_iovirt_get_device_info(PCIE_CREATE_BDF_PACKED(e_bdf),
+                                 PCIE_EXTRACT_BDF_SEG(e_bdf),
+                                 &device_id, &master->streamid,
+                                 &its_id))
+      return 1;
+
+  /* Get translation attributes via TCR and translation table base via TTBR */
+  if (val_pe_reg_read_tcr(0 /*for TTBR0*/, &pgt_desc->tcr))
+      return 1;
+  if (val_pe_reg_read_ttbr(0 /*TTBR0*/, &ttbr))
+      return 1;
+  pgt_desc->pgt_base = (ttbr & AARCH64_TTBR_ADDR_MASK);
+  pgt_desc->mair = val_pe_reg_read(MAIR_ELx);
+  pgt_desc->stage = PGT_STAGE1;
+
+  /* Reuse the PE attributes of the buffer for the SMMU page table */
+  if (val_pgt_get_attributes(*pgt_desc, (uint64_t)buf_virt, &mem_desc->attributes))
+      return 1;
+
+  mem_desc->virtual_address = (uint64_t)buf_virt;
+  mem_desc->physical_address = (uint64_t)buf_phys;
+  mem_desc->length = BENCH_BUF_SIZE;
+  mem_desc->attributes |= PGT_STAGE1_AP_RW;
+
+  pgt_desc->ias = val_smmu_get_info(SMMU_IN_ADDR_SIZE, master->smmu_index);
+  if (pgt_desc->ias == 0)
+      return 1;
+
+  pgt_desc->oas = val_smmu_get_info(SMMU_OUT_ADDR_SIZE, master->smmu_index);
+  if (pgt_desc->oas == 0)
+      return 1;
+
+  if (val_pgt_create(mem_desc, pgt_desc))
+      return 1;
+
+  if (val_smmu_map(*master, *pgt_desc)) {
+      val_print(ACS_PRINT_ERR, "\n       SMMU mapping failed (%x)     ", e_bdf);
+      val_pgt_destroy(*pgt_desc);
+      return 1;
+  }
+
+  *dma_addr = mem_desc->virtual_address;
+  return 0;
+}
+
+/* Returns 0 if the mode is usable for this exerciser and sets dma_addr */
+static
+uint32_t
+bench_mode_setup(bench_smmu_mode_t mode, uint32_t instance, uint32_t e_bdf,
+                 smmu_master_attributes_t *master, pgt_descriptor_t *pgt_desc,
+                 void *buf_virt, void *buf_phys, uint64_t *dma_addr)
+{
+  uint32_t e_pasid_bits;
+
+  val_memory_set(master, sizeof(smmu_master_attributes_t), 0);
+  master->smmu_index = val_iovirt_get_rc_smmu_index(PCIE_EXTRACT_BDF_SEG(e_bdf),
+                                                    PCIE_CREATE_BDF_PACKED(e_bdf));
+
+  if (mode == BENCH_SMMU_BYPASS) {
+      if ((master->smmu_index != ACS_INVALID_INDEX) && val_smmu_disable(master->smmu_index))
+          return 1;
+      *dma_addr = (uint64_t)buf_phys;
+      return 0;
+  }
+
+  /* Translated modes need an SMMUv3 in front of the exerciser */
+  if (master->smmu_index == ACS_INVALID_INDEX ||
+      val_iovirt_get_smmu_info(SMMU_CTRL_ARCH_MAJOR_REV, master->smmu_index) != 3)
+      return 1;
+
+  if (mode == BENCH_SMMU_PASID) {
+      if (val_smmu_get_info(SMMU_SSID_BITS, master->smmu_index) < MIN_PASID_BITS)
+          return 1;
+      if (val_pcie_get_max_pasid_width(e_bdf, &e_pasid_bits) ||
+          e_pasid_bits < MIN_PASID_BITS)
+          return 1;
+      master->ssid_bits = MIN_PASID_BITS;
+      master->substreamid = BENCH_PASID;
+  }
+
+  val_smmu_enable(master->smmu_index);
+
+  if (bench_smmu_map(master, pgt_desc, buf_virt, buf_phys, e_bdf, dma_addr)) {
+      val_smmu_disable(master->smmu_index);
+      return 1;
+  }
+
+  if (mode == BENCH_SMMU_PASID &&
+      val_exerciser_ops(PASID_TLP_START, (uint64_t)master->substreamid, instance)) {
+      val_print(ACS_PRINT_ERR, "\n       Exerciser %x PASID TLP Prefix enable error", instance);
+      val_smmu_unmap(*master);
+      val_pgt_destroy(*pgt_desc);
+      val_smmu_disable(master->smmu_index);
+      return 1;
+  }
+
+  return 0;
+}
+
+static
+void
+bench_mode_teardown(bench_smmu_mode_t mode, uint32_t instance,
+                    smmu_master_attributes_t *master, pgt_descriptor_t *pgt_desc)
+{
+  if (mode == BENCH_SMMU_BYPASS)
+      return;
+
+  if (mode == BENCH_SMMU_PASID)
+      val_exerciser_ops(PASID_TLP_STOP, (uint64_t)master->substreamid, instance);
+
+  val_smmu_unmap(*master);
+  val_pgt_destroy(*pgt_desc);
+  val_smmu_disable(master->smmu_index);
+}
+
+static
+void
+payload(void)
+{
+  uint32_t pe_index;
+  uint32_t instance;
+  uint32_t e_bdf;
+  uint32_t mode;
+  uint32_t status;
+  uint64_t freq;
+  uint64_t dma_addr;
+  void *buf_virt;
+  void *buf_phys;
+  smmu_master_attributes_t master;
+  pgt_descriptor_t pgt_desc;
+
+  pe_index = val_pe_get_index_mpid(val_pe_get_mpid());
+
+  freq = val_timer_get_info(TIMER_INFO_CNTFREQ, 0);
+  if (freq == 0) {
+      val_print(ACS_PRINT_ERR, "\n       Invalid counter frequency", 0);
+      val_set_status(pe_index, RESULT_SKIP(TEST_NUM, 1));
+      return;
+  }
+
+  status = 0;
+  instance = val_exerciser_get_info(EXERCISER_NUM_CARDS, 0);
+
+  while (instance-- != 0) {
+
+    /* if init fail moves to next exerciser */
+    if (val_exerciser_init(instance))
+        continue;
+
+    e_bdf = val_exerciser_get_bdf(instance);
+
+    /* Get a WB, outer shareable buffer large enough for the biggest transfer */
+    buf_virt = val_memory_alloc_cacheable(e_bdf, BENCH_BUF_SIZE, &buf_phys);
+    if (!buf_virt) {
+        val_print(ACS_PRINT_ERR, "\n       WB and OSH mem alloc failure %x", 2);
+        status = 1;
+        break;
+    }
+
+    /* The data is checked on completion, make sure no dirty lines are left behind */
+    val_memory_set(buf_virt, BENCH_BUF_SIZE, BENCH_DATA);
+    val_pe_cache_clean_range((uint64_t)buf_virt, BENCH_BUF_SIZE);
+
+    val_print(ACS_PRINT_TEST, "\n       Exerciser %d", instance);
+    val_print(ACS_PRINT_TEST, " BDF 0x%x", e_bdf);
+
+    for (mode = BENCH_SMMU_BYPASS; mode < BENCH_SMMU_MODES; mode++) {
+
+        if (bench_mode_setup(mode, instance, e_bdf, &master, &pgt_desc,
+                             buf_virt, buf_phys, &dma_addr)) {
+            val_print(ACS_PRINT_TEST, bench_mode_str[mode], 0);
+            val_print(ACS_PRINT_TEST, " : not supported, skipped", 0);
+            continue;
+        }
+
+        val_print(ACS_PRINT_TEST, bench_mode_str[mode], 0);
+        status |= bench_run_config(instance, buf_virt, dma_addr, freq);
+
+        bench_mode_teardown(mode, instance, &master, &pgt_desc);
+    }
+
+    val_memory_free_cacheable(e_bdf, BENCH_BUF_SIZE, buf_virt, buf_phys);
+  }
+
+  if (status)
+      val_set_status(pe_index, RESULT_FAIL(TEST_NUM, 2));
+  else
+      val_set_status(pe_index, RESULT_PASS(TEST_NUM, 1));
+}
+
+uint32_t
+os_e016_entry(void)
+{
+  uint32_t num_pe = 1;
+  uint32_t status = ACS_STATUS_FAIL;
+
+  status = val_initialize_test(TEST_NUM, TEST_DESC, num_pe);
+  if (status != ACS_STATUS_SKIP)
+      val_run_test_payload(TEST_NUM, num_pe, payload, 0);
+
+  /* Get the result from all PE and check for failure */
+  status = val_check_for_error(TEST_NUM, num_pe, TEST_RULE);
+
+  val_report_status(0, BSA_ACS_END(TEST_NUM), NULL);
+
+  return status;
+}
@@ -0,0 +1,214 @@
+/** @file
+ * Copyright (c) 2021, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+/* Concurrent exerciser traffic. Only run with -traffic <ms>.
+ *
+ * Every exerciser is given its own PE and all of them start issuing DMA at
+ * the same counter value for the requested duration:
+ *   - P2P stream    : reads of a peer exerciser BAR below another root port,
+ *                     when the hierarchy supports P2P
+ *   - Memory stream : alternating reads and writes of a WB buffer otherwise
+ * The test fails if a stream is still blocked in a DMA a second after the
+ * end, or if a memory stream reports DMA errors. P2P errors are expected on
+ * hierarchies that reject the requests and are only reported.
+ */
+
+#include "val/include/bsa_acs_val.h"
+#include "val/include/val_interface.h"
+
+#include "val/include/bsa_acs_pcie.h"
+#include "val/include/bsa_acs_memory.h"
+#include "val/include/bsa_acs_pcie_enumeration.h"
+#include "val/include/bsa_acs_exerciser.h"
+
+#define TEST_NUM   (ACS_EXERCISER_TEST_NUM_BASE + 17)
+#define TEST_RULE  "PCI_PP_02"
+#define TEST_DESC  "Concurrent traffic should not deadlock"
+
+#define TRAFFIC_BUF_SIZE   (4 * 1024)
+#define TRAFFIC_P2P_LEN    64
+
+static exerciser_traffic_t streams[MAX_EXERCISER_CARDS];
+static void *buf_virt[MAX_EXERCISER_CARDS];
+static void *buf_phys[MAX_EXERCISER_CARDS];
+static uint32_t buf_bdf[MAX_EXERCISER_CARDS];
+
+/* Find the BAR of an exerciser below a root port other than req_rp_bdf */
+static
+uint64_t
+get_peer_bar(uint32_t req_instance, uint32_t req_rp_bdf)
+{
+  uint32_t instance;
+  uint32_t e_bdf;
+  uint32_t rp_bdf;
+  uint64_t bar_base;
+
+  instance = val_exerciser_get_info(EXERCISER_NUM_CARDS, 0);
+
+  while (instance-- != 0) {
+      if ((instance == req_instance) || val_exerciser_init(instance))
+          continue;
+
+      e_bdf = val_exerciser_get_bdf(instance);
+      if (val_pcie_get_rootport(e_bdf, &rp_bdf) || (rp_bdf == req_rp_bdf))
+          continue;
+
+      bar_base = 0;
+      val_pcie_get_mmio_bar(e_bdf, &bar_base);
+      if (bar_base == 0)
+          continue;
+
+      val_pcie_enable_bme(e_bdf);
+      val_pcie_enable_msa(e_bdf);
+      return bar_base;
+  }
+
+  return 0;
+}
+
+static
+void
+payload(void)
+{
+  uint32_t pe_index;
+  uint32_t instance;
+  uint32_t num_streams;
+  uint32_t num_instances;
+  uint32_t p2p;
+  uint32_t e_bdf;
+  uint32_t rp_bdf;
+  uint32_t status;
+  uint32_t hung;
+  uint32_t i;
+  uint64_t bar_base;
+
+  pe_index = val_pe_get_index_mpid(val_pe_get_mpid());
+  status = 0;
+
+  if (val_pe_get_num() < 2) {
+      val_print(ACS_PRINT_DEBUG, "\n       Needs more than one PE, Skipping Test", 0);
+      val_set_status(pe_index, RESULT_SKIP(TEST_NUM, 1));
+      return;
+  }
+
+  /* val_pcie_p2p_support returns 0 when P2P is supported */
+  p2p = (val_pcie_p2p_support() == 0);
+
+  num_streams = 0;
+  num_instances = val_exerciser_get_info(EXERCISER_NUM_CARDS, 0);
+
+  for (instance = 0; instance < num_instances; instance++) {
+
+      /* if init fail moves to next exerciser */
+      if (val_exerciser_init(instance))
+          continue;
+
+      e_bdf = val_exerciser_get_bdf(instance);
+      streams[num_streams].instance = instance;
+      buf_virt[num_streams] = NULL;
+
+      bar_base = 0;
+      if (p2p && (val_pcie_get_rootport(e_bdf, &rp_bdf) == 0))
+          bar_base = get_peer_bar(instance, rp_bdf);
+
+      if (bar_base) {
+          streams[num_streams].type = TRAFFIC_DMA_TO_DEVICE;
+          streams[num_streams].addr = bar_base;
+          streams[num_streams].len = TRAFFIC_P2P_LEN;
+          num_streams++;
+          continue;
+      }
+
+      /* Get a WB, outer shareable DDR Buffer of size TRAFFIC_BUF_SIZE */
+      buf_virt[num_streams] = val_memory_alloc_cacheable(e_bdf, TRAFFIC_BUF_SIZE,
+                                                         &buf_phys[num_streams]);
+      if (!buf_virt[num_streams]) {
+          val_print(ACS_PRINT_ERR, "\n       WB and OSH mem alloc failure %x", 2);
+          status = 1;
+          goto exit;
+      }
+
+      buf_bdf[num_streams] = e_bdf;
+      val_memory_set(buf_virt[num_streams], TRAFFIC_BUF_SIZE, 0);
+      val_data_cache_ops_by_range((addr_t)buf_virt[num_streams], TRAFFIC_BUF_SIZE,
+                                  CLEAN_AND_INVALIDATE);
+
+      streams[num_streams].type = TRAFFIC_DMA_LOOPBACK;
+      streams[num_streams].addr = (uint64_t)buf_phys[num_streams];
+      streams[num_streams].len = TRAFFIC_BUF_SIZE;
+      num_streams++;
+  }
+
+  if (num_streams < 2) {
+      val_print(ACS_PRINT_DEBUG, "\n       Needs more than one exerciser, Skipping Test", 0);
+      status = 2;
+      goto exit;
+  }
+
+  val_print(ACS_PRINT_DEBUG, "\n       Running %d concurrent streams", num_streams);
+  hung = val_exerciser_traffic_run(TEST_NUM, streams, num_streams, g_traffic_duration_ms);
+  val_exerciser_traffic_report(ACS_PRINT_TEST, streams, num_streams);
+
+  if (hung) {
+      val_print(ACS_PRINT_ERR, "\n       %d streams did not complete", hung);
+      status = 1;
+  }
+
+  for (i = 0; i < num_streams; i++) {
+      if (buf_virt[i] && streams[i].errors) {
+          val_print(ACS_PRINT_ERR, "\n       DMA errors on exerciser %d", streams[i].instance);
+          status = 1;
+      }
+
+      /* Clear Error Status Bits */
+      e_bdf = val_exerciser_get_bdf(streams[i].instance);
+      if (val_pcie_get_rootport(e_bdf, &rp_bdf) == 0) {
+          val_pcie_clear_device_status_error(rp_bdf);
+          val_pcie_clear_sig_target_abort(rp_bdf);
+      }
+  }
+
+exit:
+  for (i = 0; i < num_streams; i++)
+      if (buf_virt[i])
+          val_memory_free_cacheable(buf_bdf[i], TRAFFIC_BUF_SIZE, buf_virt[i], buf_phys[i]);
+
+  if (status == 2)
+      val_set_status(pe_index, RESULT_SKIP(TEST_NUM, 2));
+  else if (status)
+      val_set_status(pe_index, RESULT_FAIL(TEST_NUM, 1));
+  else
+      val_set_status(pe_index, RESULT_PASS(TEST_NUM, 1));
+}
+
+uint32_t
+os_e017_entry(void)
+{
+  uint32_t num_pe = 1;
+  uint32_t status = ACS_STATUS_FAIL;
+
+  status = val_initialize_test(TEST_NUM, TEST_DESC, num_pe);
+  if (status != ACS_STATUS_SKIP)
+      val_run_test_payload(TEST_NUM, num_pe, payload, 0);
+
+  /* Get the result from all PE and check for failure */
+  status = val_check_for_error(TEST_NUM, num_pe, TEST_RULE);
+
+  val_report_status(0, BSA_ACS_END(TEST_NUM), NULL);
+
+  return status;
+}
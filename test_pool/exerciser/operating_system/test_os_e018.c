@@ -0,0 +1,311 @@
+/** @file
+ * Copyright (c) 2016-2018, 2021, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+/* Exerciser MSI-X sweep - not a compliance check. Only run with -perf.
+ *
+ * Maps every MSI-X vector of every exerciser to its own LPI, fires all
+ * the vectors back to back and records in a bitmap which LPIs arrived.
+ * Fails if a vector raises no interrupt or more than one, and reports how
+ * many vectors per second make the round trip from the trigger to the
+ * handler.
+ */
+
+#include "val/include/bsa_acs_val.h"
+#include "val/include/val_interface.h"
+
+#include "val/include/bsa_acs_pcie.h"
+#include "val/include/bsa_acs_gic.h"
+#include "val/include/bsa_acs_memory.h"
+#include "val/include/bsa_acs_iovirt.h"
+#include "val/include/bsa_acs_smmu.h"
+#include "val/include/bsa_acs_pcie_enumeration.h"
+#include "val/include/bsa_acs_exerciser.h"
+
+#define TEST_NUM   (ACS_EXERCISER_TEST_NUM_BASE + 18)
+#define TEST_RULE  ""
+#define TEST_DESC  "Exerciser MSI-X vector sweep rate     "
+
+typedef struct {
+  uint32_t instance;
+  uint32_t bdf;
+  uint32_t device_id;
+  uint32_t its_id;
+  uint32_t int_id_base;
+  uint32_t num_vectors;
+} msi_sweep_t;
+
+static uint32_t lpi_int_id = 0x204C;
+static uint32_t num_lpis;
+static volatile uint32_t *arrived_map;   /* One bit per LPI of the sweep */
+static volatile uint32_t num_arrived;
+static volatile uint32_t num_repeated;
+static volatile uint32_t num_stray;
+
+static
+void
+intr_handler(uint32_t int_id)
+{
+  uint32_t bit = int_id - lpi_int_id;
+
+  if ((int_id < lpi_int_id) || (bit >= num_lpis))
+      num_stray++;
+  else if (arrived_map[bit >> 5] & (1U << (bit & 0x1F)))
+      num_repeated++;
+  else {
+      arrived_map[bit >> 5] |= (1U << (bit & 0x1F));
+      num_arrived++;
+  }
+
+  val_print(ACS_PRINT_DEBUG, "\n       Received MSI interrupt %x       ", int_id);
+  val_gic_end_of_interrupt(int_id);
+  return;
+}
+
+static
+void
+free_sweep(msi_sweep_t *sweep, uint32_t num_mapped)
+{
+  uint32_t i;
+
+  for (i = 0; i < num_mapped; i++)
+    val_gic_free_msi_range(sweep[i].bdf, sweep[i].device_id, sweep[i].its_id,
+                           sweep[i].int_id_base, sweep[i].num_vectors);
+
+  if (arrived_map) {
+    val_memory_free((void *)arrived_map);
+    arrived_map = NULL;
+  }
+
+  val_memory_free(sweep);
+}
+
+static
+void
+payload (void)
+{
+
+  uint32_t index;
+  uint32_t e_bdf = 0;
+  uint32_t timeout;
+  uint32_t status;
+  uint32_t num_cards;
+  uint32_t num_smmus;
+  uint32_t num_mapped = 0;
+  uint32_t instance;
+  uint32_t vector;
+  uint32_t int_id;
+  uint32_t bit;
+  uint32_t map_size;
+  uint32_t msi_cap_offset = 0;
+  uint32_t i;
+
+  uint32_t device_id = 0;
+  uint32_t stream_id = 0;
+  uint32_t its_id = 0;
+  uint64_t start_cnt, end_cnt, freq;
+  msi_sweep_t *sweep;
+
+  index = val_pe_get_index_mpid(val_pe_get_mpid());
+
+  if (val_gic_get_info(GIC_INFO_NUM_ITS) == 0) {
+      val_print(ACS_PRINT_DEBUG, "\n       No ITS, Skipping Test.\n", 0);
+      val_set_status(index, RESULT_SKIP(TEST_NUM, 1));
+      return;
+  }
+
+  /* Read the number of excerciser cards */
+  num_cards = val_exerciser_get_info(EXERCISER_NUM_CARDS, 0);
+
+  sweep = val_memory_alloc(sizeof(msi_sweep_t) * (num_cards ? num_cards : 1));
+  if (sweep == NULL) {
+      val_print(ACS_PRINT_ERR, "\n       Memory allocation failed", 0);
+      val_set_status(index, RESULT_FAIL(TEST_NUM, 6));
+      return;
+  }
+
+  /* Disable all SMMUs */
+  num_smmus = val_iovirt_get_smmu_info(SMMU_NUM_CTRL, 0);
+  for (instance = 0; instance < num_smmus; ++instance)
+     val_smmu_disable(instance);
+
+  /* Collect every MSI-X vector of every exerciser, LPIs are allocated contiguously */
+  num_lpis = 0;
+  for (instance = 0; instance < num_cards; instance++)
+  {
+
+    /* if init fail moves to next exerciser */
+    if (val_exerciser_init(instance))
+        continue;
+
+    /* Get the exerciser BDF */
+    e_bdf = val_exerciser_get_bdf(instance);
+
+    /* Search for MSI-X Capability */
+    if (val_pcie_find_capability(e_bdf, PCIE_CAP, CID_MSIX, &msi_cap_offset)) {
+      val_print(ACS_PRINT_INFO, "\n       No MSI-X Capability, Skipping for 0x%x", e_bdf);
+      continue;
+    }
+
+    /* Get DeviceID & ITS_ID for this device */
+    status = val_iovirt_get_device_info(PCIE_CREATE_BDF_PACKED(e_bdf),
+                                        PCIE_EXTRACT_BDF_SEG(e_bdf), &device_id,
+                                        &stream_id, &its_id);
+    if (status) {
+        val_print(ACS_PRINT_ERR,
+            "\n       Could not get device info for BDF : 0x%x", e_bdf);
+        val_set_status(index, RESULT_FAIL(TEST_NUM, 1));
+        val_memory_free(sweep);
+        return;
+    }
+
+    sweep[num_mapped].instance = instance;
+    sweep[num_mapped].bdf = e_bdf;
+    sweep[num_mapped].device_id = device_id;
+    sweep[num_mapped].its_id = its_id;
+    sweep[num_mapped].int_id_base = lpi_int_id + num_lpis;
+    sweep[num_mapped].num_vectors = val_pcie_get_msix_table_size(e_bdf);
+    val_print(ACS_PRINT_INFO, "\n       MSI-X vectors : %d", sweep[num_mapped].num_vectors);
+    val_print(ACS_PRINT_INFO, " for BDF : 0x%x", e_bdf);
+
+    num_lpis += sweep[num_mapped].num_vectors;
+    num_mapped++;
+  }
+
+  if (num_mapped == 0) {
+    val_memory_free(sweep);
+    val_set_status(index, RESULT_SKIP(TEST_NUM, 2));
+    return;
+  }
+
+  map_size = ((num_lpis + 31) / 32) * sizeof(uint32_t);
+  arrived_map = val_memory_alloc(map_size);
+  if (arrived_map == NULL) {
+      val_print(ACS_PRINT_ERR, "\n       Memory allocation failed", 0);
+      val_set_status(index, RESULT_FAIL(TEST_NUM, 6));
+      val_memory_free(sweep);
+      return;
+  }
+
+  val_memory_set((void *)arrived_map, map_size, 0);
+  num_arrived = 0;
+  num_repeated = 0;
+  num_stray = 0;
+
+  /* Map all vectors of each exerciser with one ITS command queue submission */
+  for (i = 0; i < num_mapped; i++)
+  {
+    status = val_gic_request_msi_range(sweep[i].bdf, sweep[i].device_id, sweep[i].its_id,
+                                       sweep[i].int_id_base, sweep[i].num_vectors);
+    if (status) {
+        val_print(ACS_PRINT_ERR,
+            "\n       MSI Assignment failed for bdf : 0x%x", sweep[i].bdf);
+        val_set_status(index, RESULT_FAIL(TEST_NUM, 2));
+        free_sweep(sweep, i);
+        return;
+    }
+
+    for (vector = 0; vector < sweep[i].num_vectors; vector++) {
+      status = val_gic_install_isr(sweep[i].int_id_base + vector,
+                                   (void (*)(void))intr_handler);
+      if (status) {
+          val_print(ACS_PRINT_ERR,
+              "\n       Intr handler registration failed Interrupt : 0x%x",
+              sweep[i].int_id_base + vector);
+          val_set_status(index, RESULT_FAIL(TEST_NUM, 3));
+          free_sweep(sweep, i + 1);
+          return;
+      }
+    }
+  }
+
+  /* Trigger every vector of every Exerciser back to back */
+  start_cnt = val_timer_get_counter();
+  for (i = 0; i < num_mapped; i++)
+  {
+    for (vector = 0; vector < sweep[i].num_vectors; vector++)
+      val_exerciser_ops(GENERATE_MSI, vector, sweep[i].instance);
+  }
+
+  timeout = TIMEOUT_LARGE;
+  while ((--timeout > 0) && (num_arrived < num_lpis))
+      {};
+  end_cnt = val_timer_get_counter();
+
+  /* Give late or repeated interrupts the time to show up */
+  timeout = TIMEOUT_MEDIUM;
+  while (--timeout > 0)
+      {};
+
+  /* Every vector must have raised its own LPI, once */
+  if (num_arrived != num_lpis) {
+      for (i = 0; i < num_mapped; i++) {
+        for (vector = 0; vector < sweep[i].num_vectors; vector++) {
+          int_id = sweep[i].int_id_base + vector;
+          bit = int_id - lpi_int_id;
+          if (!(arrived_map[bit >> 5] & (1U << (bit & 0x1F)))) {
+              val_print(ACS_PRINT_ERR,
+                  "\n       Interrupt trigger failed for : 0x%x, ", int_id);
+              val_print(ACS_PRINT_ERR, "BDF : 0x%x   ", sweep[i].bdf);
+          }
+        }
+      }
+      val_set_status(index, RESULT_FAIL(TEST_NUM, 4));
+      free_sweep(sweep, num_mapped);
+      return;
+  }
+
+  if (num_repeated || num_stray) {
+      val_print(ACS_PRINT_ERR, "\n       Repeated MSI count : %d", num_repeated);
+      val_print(ACS_PRINT_ERR, ", stray MSI count : %d", num_stray);
+      val_set_status(index, RESULT_FAIL(TEST_NUM, 5));
+      free_sweep(sweep, num_mapped);
+      return;
+  }
+
+  freq = val_timer_get_info(TIMER_INFO_CNTFREQ, 0);
+  val_print(ACS_PRINT_TEST, "\n       MSI-X vectors swept : %d", num_lpis);
+  if (freq && (end_cnt > start_cnt)) {
+      val_print(ACS_PRINT_TEST, "\n       MSI round trip rate : %d interrupts/s",
+                ((uint64_t)num_lpis * freq) / (end_cnt - start_cnt));
+  }
+
+  /* Clear Interrupt and Mappings */
+  free_sweep(sweep, num_mapped);
+
+  /* Pass Test */
+  val_set_status(index, RESULT_PASS(TEST_NUM, 1));
+
+}
+
+uint32_t
+os_e018_entry(void)
+{
+
+  uint32_t status = ACS_STATUS_FAIL;
+
+  uint32_t num_pe = 1;  //This test is run on single processor
+
+  status = val_initialize_test(TEST_NUM, TEST_DESC, num_pe);
+  if (status != ACS_STATUS_SKIP)
+      val_run_test_payload(TEST_NUM, num_pe, payload, 0);
+
+  /* get the result from all PE and check for failure */
+  status = val_check_for_error(TEST_NUM, num_pe, TEST_RULE);
+
+  val_report_status(0, BSA_ACS_END(TEST_NUM), NULL);
+
+  return status;
+}
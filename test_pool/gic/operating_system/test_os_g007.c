@@ -0,0 +1,467 @@
+/** @file
+ * Copyright (c) 2021, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+/* Interrupt delivery latency benchmark - not a compliance check. Only run with -perf.
+ *
+ * The latency of each interrupt is measured from the trigger to the first
+ * instruction of the handler, both timestamped with the generic counter.
+ * Sources measured on the PE running the test, through the installed ISR:
+ *   - SGI        : ICC_SGI1R_EL1 / GICD_SGIR write targeting this PE
+ *   - PPI (PMU)  : PMOVSSET_EL0 write with the overflow interrupt enabled
+ *   - PPI (timer): EL1 physical timer, measured from the programmed expiry
+ *   - SPI        : memory mapped system timer, measured from the programmed expiry
+ *   - LPI        : exerciser MSI write to GITS_TRANSLATER
+ * With GICv3, SGI latency is also measured to every other PE. Those PEs run
+ * with interrupts masked and poll their CPU interface, so the figure is the
+ * time to the interrupt being acknowledged at the target.
+ * Each source reports min/median/p99/max over BENCH_ITERATIONS samples.
+ */
+
+#include "val/include/bsa_acs_val.h"
+#include "val/include/val_interface.h"
+
+#include "val/include/bsa_acs_gic.h"
+#include "val/include/bsa_acs_pe.h"
+#include "val/include/bsa_acs_pcie.h"
+#include "val/include/bsa_acs_pcie_enumeration.h"
+#include "val/include/bsa_acs_iovirt.h"
+#include "val/include/bsa_acs_smmu.h"
+#include "val/include/bsa_acs_exerciser.h"
+
+#define TEST_NUM   (ACS_GIC_TEST_NUM_BASE + 7)
+#define TEST_RULE  ""
+#define TEST_DESC  "Interrupt delivery latency            "
+
+#define BENCH_ITERATIONS    1000
+#define BENCH_SGI_ID        1
+#define BENCH_LPI_ID        0x2060
+#define BENCH_TIMER_TICKS   100
+#define BENCH_TARGET_READY  0xB00DB00Dull
+
+#define NS_PER_SEC          1000000000ull
+
+typedef enum {
+  BENCH_SRC_SGI = 0,
+  BENCH_SRC_PMU,
+  BENCH_SRC_PE_TIMER,
+  BENCH_SRC_SYS_TIMER,
+  BENCH_SRC_MSI
+} bench_source_t;
+
+static volatile uint32_t irq_received;
+static volatile uint64_t isr_timestamp;
+static uint32_t bench_source;
+static uint32_t bench_intid;
+static uint64_t cnt_base_n;
+static uint32_t e_instance;
+static uint64_t freq;
+static uint64_t samples[BENCH_ITERATIONS];
+
+static
+void
+isr(void)
+{
+  isr_timestamp = val_timer_get_counter();
+
+  /* Quiesce the source before completing the interrupt */
+  if (bench_source == BENCH_SRC_PMU)
+      val_pe_reg_write(PMOVSCLR_EL0, 0x1);
+  else if (bench_source == BENCH_SRC_PE_TIMER)
+      val_timer_set_phy_el1(0);
+  else if (bench_source == BENCH_SRC_SYS_TIMER)
+      val_timer_disable_system_timer((addr_t)cnt_base_n);
+
+  irq_received = 1;
+  val_gic_end_of_interrupt(bench_intid);
+}
+
+/* Fire the current source and return the counter value it was raised at */
+static
+uint64_t
+trigger(void)
+{
+  uint64_t t0;
+
+  t0 = val_timer_get_counter();
+
+  switch (bench_source) {
+  case BENCH_SRC_SGI:
+      val_gic_generate_sgi(bench_intid, val_pe_get_mpid());
+      return t0;
+  case BENCH_SRC_PMU:
+      val_pe_reg_write(PMOVSSET_EL0, 0x1);
+      return t0;
+  case BENCH_SRC_PE_TIMER:
+      val_timer_set_phy_el1(BENCH_TIMER_TICKS);
+      return t0 + BENCH_TIMER_TICKS;
+  case BENCH_SRC_SYS_TIMER:
+      val_timer_set_system_timer((addr_t)cnt_base_n, BENCH_TIMER_TICKS);
+      return t0 + BENCH_TIMER_TICKS;
+  case BENCH_SRC_MSI:
+      val_exerciser_ops(GENERATE_MSI, 0, e_instance);
+      return t0;
+  default:
+      return t0;
+  }
+}
+
+static
+void
+report(char8_t *name, uint32_t count)
+{
+  perf_stats_t stats;
+
+  val_perf_get_stats(samples, count, &stats);
+
+  val_print(ACS_PRINT_TEST, name, 0);
+  val_print(ACS_PRINT_TEST, " %8d", (stats.min * NS_PER_SEC) / freq);
+  val_print(ACS_PRINT_TEST, " %8d", (stats.median * NS_PER_SEC) / freq);
+  val_print(ACS_PRINT_TEST, " %8d", (stats.p99 * NS_PER_SEC) / freq);
+  val_print(ACS_PRINT_TEST, " %8d", (stats.max * NS_PER_SEC) / freq);
+}
+
+/* Collect BENCH_ITERATIONS samples for a source whose ISR is installed */
+static
+uint32_t
+measure_local(char8_t *name)
+{
+  uint32_t iter;
+  uint64_t t_trigger, deadline;
+
+  for (iter = 0; iter < BENCH_ITERATIONS; iter++) {
+      irq_received = 0;
+      t_trigger = trigger();
+
+      /* Allow 10ms for delivery */
+      deadline = t_trigger + (freq / 100);
+      while (!irq_received && (val_timer_get_counter() < deadline))
+          ;
+
+      if (!irq_received) {
+          val_print(ACS_PRINT_ERR, name, 0);
+          val_print(ACS_PRINT_ERR, " : interrupt %d not received", bench_intid);
+          return 1;
+      }
+
+      samples[iter] = (isr_timestamp > t_trigger) ? (isr_timestamp - t_trigger) : 0;
+  }
+
+  report(name, BENCH_ITERATIONS);
+  return 0;
+}
+
+static
+uint32_t
+bench_sgi(void)
+{
+  bench_source = BENCH_SRC_SGI;
+  bench_intid = BENCH_SGI_ID;
+
+  if (val_gic_install_isr(bench_intid, isr))
+      return 1;
+
+  return measure_local("\n       SGI (self)       ");
+}
+
+static
+uint32_t
+bench_pmu(uint32_t index)
+{
+  uint32_t data;
+  uint32_t status;
+
+  /* Check ID_AA64DFR0_EL1[11:8] for PMUver */
+  data = VAL_EXTRACT_BITS(val_pe_reg_read(ID_AA64DFR0_EL1), 8, 11);
+  bench_intid = val_pe_get_pmu_gsiv(index);
+  if ((data == 0x0) || (data == 0xF) || (bench_intid == 0)) {
+      val_print(ACS_PRINT_TEST, "\n       PPI (PMU)        : not available, skipped", 0);
+      return 0;
+  }
+
+  bench_source = BENCH_SRC_PMU;
+  if (val_gic_install_isr(bench_intid, isr))
+      return 1;
+
+  val_pe_reg_write(PMINTENCLR_EL1, 0xFFFFFFFF);
+  val_pe_reg_write(PMOVSCLR_EL0, 0xFFFFFFFF);
+  val_pe_reg_write(PMCR_EL0, val_pe_reg_read(PMCR_EL0) | 0x1);
+  val_pe_reg_write(PMINTENSET_EL1, 0x1);
+
+  status = measure_local("\n       PPI (PMU)        ");
+
+  val_pe_reg_write(PMINTENCLR_EL1, 0x1);
+  val_pe_reg_write(PMOVSCLR_EL0, 0x1);
+  return status;
+}
+
+static
+uint32_t
+bench_pe_timer(void)
+{
+  bench_source = BENCH_SRC_PE_TIMER;
+  bench_intid = val_timer_get_info(TIMER_INFO_PHY_EL1_INTID, 0);
+  if (bench_intid == 0) {
+      val_print(ACS_PRINT_TEST, "\n       PPI (EL1 timer)  : not available, skipped", 0);
+      return 0;
+  }
+
+  if (val_gic_install_isr(bench_intid, isr))
+      return 1;
+
+  return measure_local("\n       PPI (EL1 timer)  ");
+}
+
+static
+uint32_t
+bench_sys_timer(void)
+{
+  uint64_t timer_num;
+
+  timer_num = val_timer_get_info(TIMER_INFO_NUM_PLATFORM_TIMERS, 0);
+  while (timer_num--) {
+      if (val_timer_get_info(TIMER_INFO_IS_PLATFORM_TIMER_SECURE, timer_num))
+          continue;
+      if (val_timer_skip_if_cntbase_access_not_allowed(timer_num) == ACS_STATUS_SKIP)
+          continue;
+
+      cnt_base_n = val_timer_get_info(TIMER_INFO_SYS_CNT_BASE_N, timer_num);
+      if (cnt_base_n == 0)
+          continue;
+
+      bench_source = BENCH_SRC_SYS_TIMER;
+      bench_intid = val_timer_get_info(TIMER_INFO_SYS_INTID, timer_num);
+      if (val_gic_install_isr(bench_intid, isr))
+          return 1;
+
+      return measure_local("\n       SPI (sys timer)  ");
+  }
+
+  val_print(ACS_PRINT_TEST, "\n       SPI (sys timer)  : not available, skipped", 0);
+  return 0;
+}
+
+static
+uint32_t
+bench_msi(void)
+{
+  uint32_t num_cards;
+  uint32_t e_bdf;
+  uint32_t msi_cap_offset;
+  uint32_t device_id, stream_id, its_id;
+  uint32_t smmu_index;
+  uint32_t status;
+
+  if ((val_gic_get_info(GIC_INFO_NUM_ITS) == 0) || pal_target_is_dt()) {
+      val_print(ACS_PRINT_TEST, "\n       LPI (MSI)        : no ITS, skipped", 0);
+      return 0;
+  }
+
+  num_cards = val_exerciser_get_info(EXERCISER_NUM_CARDS, 0);
+  for (e_instance = 0; e_instance < num_cards; e_instance++) {
+
+      if (val_exerciser_init(e_instance))
+          continue;
+
+      e_bdf = val_exerciser_get_bdf(e_instance);
+      if (val_pcie_find_capability(e_bdf, PCIE_CAP, CID_MSIX, &msi_cap_offset))
+          continue;
+
+      if (val_iovirt_get_device_info(PCIE_CREATE_BDF_PACKED(e_bdf),
+                                     PCIE_EXTRACT_BDF_SEG(e_bdf), &device_id,
+                                     &stream_id, &its_id))
+          continue;
+
+      /* MSI writes must reach the ITS untranslated */
+      smmu_index = val_iovirt_get_rc_smmu_index(PCIE_EXTRACT_BDF_SEG(e_bdf),
+                                                PCIE_CREATE_BDF_PACKED(e_bdf));
+      if (smmu_index != ACS_INVALID_INDEX)
+          val_smmu_disable(smmu_index);
+
+      bench_source = BENCH_SRC_MSI;
+      bench_intid = BENCH_LPI_ID;
+      if (val_gic_request_msi(e_bdf, device_id, its_id, bench_intid, 0))
+          return 1;
+
+      if (val_gic_install_isr(bench_intid, isr)) {
+          val_gic_free_msi(e_bdf, device_id, its_id, bench_intid, 0);
+          return 1;
+      }
+
+      status = measure_local("\n       LPI (MSI)        ");
+      val_gic_free_msi(e_bdf, device_id, its_id, bench_intid, 0);
+      return status;
+  }
+
+  val_print(ACS_PRINT_TEST, "\n       LPI (MSI)        : no MSI-X exerciser, skipped", 0);
+  return 0;
+}
+
+/* Runs on the target PE with interrupts masked. Each SGI is acknowledged by
+ * polling and its timestamp handed back through the PE's shared data slot.
+ */
+static
+void
+sgi_target_payload(void)
+{
+  uint32_t index = val_pe_get_index_mpid(val_pe_get_mpid());
+  uint32_t iter, int_id;
+  uint64_t ts, deadline, tick_hz;
+
+  tick_hz = val_timer_get_info(TIMER_INFO_CNTFREQ, 0);
+
+  val_gic_poll_enable(BENCH_SGI_ID);
+  val_gic_cpuif_init();
+  val_set_test_data(index, BENCH_TARGET_READY, 0);
+
+  for (iter = 0; iter < BENCH_ITERATIONS; iter++) {
+      deadline = val_timer_get_counter() + tick_hz;
+      do {
+          int_id = val_gic_poll_acknowledge();
+          ts = val_timer_get_counter();
+          if (int_id == BENCH_SGI_ID)
+              break;
+          if (int_id < 1020)
+              val_gic_poll_end_of_interrupt(int_id);
+      } while (ts < deadline);
+
+      if (int_id != BENCH_SGI_ID) {
+          val_set_status(index, RESULT_FAIL(TEST_NUM, 3));
+          return;
+      }
+
+      val_gic_poll_end_of_interrupt(int_id);
+      val_set_test_data(index, iter + 1, ts);
+  }
+
+  val_set_status(index, RESULT_PASS(TEST_NUM, 1));
+}
+
+static
+uint32_t
+bench_sgi_remote(uint32_t my_index)
+{
+  uint32_t num_pe, target, iter;
+  uint64_t t_trigger, deadline;
+  uint64_t data0, data1;
+  uint32_t status = 0;
+
+  if (val_gic_get_info(GIC_INFO_VERSION) < 3) {
+      val_print(ACS_PRINT_TEST, "\n       SGI to other PEs : needs GICv3, skipped", 0);
+      return 0;
+  }
+
+  num_pe = val_pe_get_num();
+  for (target = 0; target < num_pe; target++) {
+      if (target == my_index)
+          continue;
+
+      val_set_status(target, RESULT_PENDING(TEST_NUM));
+      val_execute_on_pe(target, sgi_target_payload, 0);
+
+      /* Wait for the target to enable its CPU interface */
+      deadline = val_timer_get_counter() + freq;
+      do {
+          val_get_test_data(target, &data0, &data1);
+      } while ((data0 != BENCH_TARGET_READY) && (val_timer_get_counter() < deadline));
+
+      if (data0 != BENCH_TARGET_READY) {
+          val_print(ACS_PRINT_ERR, "\n       PE %d did not come up", target);
+          status = 1;
+          continue;
+      }
+
+      for (iter = 0; iter < BENCH_ITERATIONS; iter++) {
+          t_trigger = val_timer_get_counter();
+          val_gic_generate_sgi(BENCH_SGI_ID, val_pe_get_mpid_index(target));
+
+          deadline = t_trigger + (freq / 100);
+          do {
+              val_get_test_data(target, &data0, &data1);
+          } while ((data0 != iter + 1) && (val_timer_get_counter() < deadline));
+
+          if (data0 != iter + 1)
+              break;
+
+          samples[iter] = (data1 > t_trigger) ? (data1 - t_trigger) : 0;
+      }
+
+      if (iter != BENCH_ITERATIONS) {
+          val_print(ACS_PRINT_ERR, "\n       SGI not acknowledged by PE %d", target);
+          status = 1;
+      } else {
+          val_print(ACS_PRINT_TEST, "\n       SGI to PE %4d   ", target);
+          report("", BENCH_ITERATIONS);
+      }
+
+      /* Let the target power itself off before moving on */
+      deadline = val_timer_get_counter() + freq;
+      while (IS_RESULT_PENDING(val_get_status(target)) && (val_timer_get_counter() < deadline))
+          ;
+  }
+
+  return status;
+}
+
+static
+void
+payload(void)
+{
+  uint32_t index = val_pe_get_index_mpid(val_pe_get_mpid());
+  uint32_t status = 0;
+
+  freq = val_timer_get_info(TIMER_INFO_CNTFREQ, 0);
+  if (freq == 0) {
+      val_print(ACS_PRINT_ERR, "\n       Invalid counter frequency", 0);
+      val_set_status(index, RESULT_SKIP(TEST_NUM, 1));
+      return;
+  }
+
+  val_print(ACS_PRINT_TEST, "\n       Source             min(ns)  p50(ns)  p99(ns)  max(ns)", 0);
+
+  status |= bench_sgi();
+  status |= bench_pmu(index);
+  status |= bench_pe_timer();
+  status |= bench_sys_timer();
+  status |= bench_msi();
+  status |= bench_sgi_remote(index);
+
+  if (status)
+      val_set_status(index, RESULT_FAIL(TEST_NUM, 2));
+  else
+      val_set_status(index, RESULT_PASS(TEST_NUM, 1));
+}
+
+uint32_t
+os_g007_entry(uint32_t num_pe)
+{
+
+  uint32_t status = ACS_STATUS_FAIL;
+
+  num_pe = 1;  //Secondary PEs are driven from the payload
+
+  status = val_initialize_test(TEST_NUM, TEST_DESC, num_pe);
+
+  if (status != ACS_STATUS_SKIP)
+      val_run_test_payload(TEST_NUM, num_pe, payload, 0);
+
+  /* get the result from all PE and check for failure */
+  status = val_check_for_error(TEST_NUM, num_pe, TEST_RULE);
+
+  val_report_status(0, BSA_ACS_END(TEST_NUM), NULL);
+
+  return status;
+}
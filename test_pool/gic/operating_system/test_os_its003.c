@@ -17,6 +17,7 @@
 #include "val/include/val_interface.h"
 #include "val/include/bsa_acs_iovirt.h"
 #include "val/include/bsa_acs_pcie.h"
+#include "val/include/bsa_acs_memory.h"
 
 #define TEST_NUM   (ACS_GIC_ITS_TEST_NUM_BASE + 3)
 #define TEST_RULE  "ITS_DEV_2"
@@ -33,16 +34,27 @@ payload()
   uint32_t pe_index;
   uint32_t tbl_index;
   uint32_t dev_index = 0;
-  uint32_t device_id, req_id;
   uint32_t stream_id, its_id;
   uint32_t cap_base;
   uint32_t test_skip = 1;
   pcie_device_bdf_table *bdf_tbl_ptr;
+  iovirt_device_info_t *info = NULL;
   int32_t prev_its_id = -1, i, j;
 
   pe_index = val_pe_get_index_mpid(val_pe_get_mpid());
   bdf_tbl_ptr = val_pcie_bdf_table_ptr();
 
+  /* Resolve the IDs of every function in one pass over the iovirt index */
+  if (bdf_tbl_ptr->num_entries) {
+      info = val_memory_alloc(bdf_tbl_ptr->num_entries * sizeof(iovirt_device_info_t));
+      if (info == NULL) {
+          val_print(ACS_PRINT_ERR, "\n       Memory allocation failed", 0);
+          val_set_status(pe_index, RESULT_FAIL(TEST_NUM, 3));
+          return;
+      }
+      val_iovirt_get_bdf_table_device_info(info, bdf_tbl_ptr->num_entries);
+  }
+
   /* Check for all the function present in bdf table */
   for (tbl_index = 0; tbl_index < bdf_tbl_ptr->num_entries; tbl_index++)
   {
@@ -57,17 +69,14 @@ payload()
     test_skip = 0;
 
     /* If MSI Supported then Check for Valid DeviceID */
-    req_id = GET_DEVICE_ID(PCIE_EXTRACT_BDF_BUS(bdf),
-                           PCIE_EXTRACT_BDF_DEV(bdf),
-                           PCIE_EXTRACT_BDF_FUNC(bdf));
-
-    status = val_iovirt_get_device_info(req_id, PCIE_EXTRACT_BDF_SEG(bdf), &device_id,
-                                        &stream_id, &its_id);
+    status    = info[tbl_index].status;
+    stream_id = info[tbl_index].stream_id;
+    its_id    = info[tbl_index].its_id;
     if (status) {
         val_print(ACS_PRINT_DEBUG,
             "\n       Could not get device info for BDF : 0x%x", bdf);
         val_set_status(pe_index, RESULT_FAIL(TEST_NUM, 1));
-        return;
+        goto exit;
     }
 
     /* Update ITS id for first group */
@@ -88,7 +97,7 @@ payload()
                 val_print(ACS_PRINT_DEBUG,
                         "\n       Stream ID is not unique for bdf : 0x%x", bdf);
                 val_set_status(pe_index, RESULT_FAIL(TEST_NUM, 2));
-                return;
+                goto exit;
             }
           }
       }
@@ -108,6 +117,10 @@ payload()
       val_set_status(pe_index, RESULT_SKIP(TEST_NUM, 1));
   else
       val_set_status(pe_index, RESULT_PASS(TEST_NUM, 1));
+
+exit:
+  if (info != NULL)
+      val_memory_free(info);
 }
 
 uint32_t
@@ -17,6 +17,7 @@
 #include "val/include/val_interface.h"
 #include "val/include/bsa_acs_iovirt.h"
 #include "val/include/bsa_acs_pcie.h"
+#include "val/include/bsa_acs_memory.h"
 
 #define TEST_NUM   (ACS_GIC_ITS_TEST_NUM_BASE + 4)
 #define TEST_RULE  "ITS_DEV_7,ITS_DEV_8"
@@ -37,10 +38,22 @@ payload()
   uint32_t curr_grp_did_cons, curr_grp_sid_cons;
   uint32_t curr_grp_its_id = -1;
   pcie_device_bdf_table *bdf_tbl_ptr;
+  iovirt_device_info_t *info = NULL;
 
   pe_index = val_pe_get_index_mpid(val_pe_get_mpid());
   bdf_tbl_ptr = val_pcie_bdf_table_ptr();
 
+  /* Resolve the IDs of every function in one pass over the iovirt index */
+  if (bdf_tbl_ptr->num_entries) {
+      info = val_memory_alloc(bdf_tbl_ptr->num_entries * sizeof(iovirt_device_info_t));
+      if (info == NULL) {
+          val_print(ACS_PRINT_ERR, "\n       Memory allocation failed", 0);
+          val_set_status(pe_index, RESULT_FAIL(TEST_NUM, 5));
+          return;
+      }
+      val_iovirt_get_bdf_table_device_info(info, bdf_tbl_ptr->num_entries);
+  }
+
   /* Check for all the function present in bdf table */
   for (tbl_index = 0; tbl_index < bdf_tbl_ptr->num_entries; tbl_index++)
   {
@@ -57,13 +70,14 @@ payload()
     /* If MSI Supported then Check for Valid DeviceID */
     req_id = PCIE_CREATE_BDF_PACKED(bdf);
 
-    status = val_iovirt_get_device_info(PCIE_CREATE_BDF_PACKED(bdf),
-                                        PCIE_EXTRACT_BDF_SEG(bdf), &device_id,
-                                        &stream_id, &its_id);
+    status    = info[tbl_index].status;
+    device_id = info[tbl_index].device_id;
+    stream_id = info[tbl_index].stream_id;
+    its_id    = info[tbl_index].its_id;
     if (status) {
         val_print(ACS_PRINT_DEBUG, "\n       Could not get device info for BDF : 0x%x", bdf);
         val_set_status(pe_index, RESULT_FAIL(TEST_NUM, 1));
-        return;
+        goto exit;
     }
 
     /* Store the Current group SID Constant offset & Dev ID Constant offset using first device */
@@ -90,7 +104,7 @@ payload()
         val_print(ACS_PRINT_DEBUG,
                   "\n       ReqID-DeviceID Association Fail for Bdf : %x", bdf);
         val_set_status(pe_index, RESULT_FAIL(TEST_NUM, 2));
-        return;
+        goto exit;
       }
     } else {
       /* Check for stream_id & device_id */
@@ -98,7 +112,7 @@ payload()
         /* StreamID Constant Base Failure */
         val_print(ACS_PRINT_DEBUG, "\n       ReqID-StreamID Association Fail for Bdf : %x", bdf);
         val_set_status(pe_index, RESULT_FAIL(TEST_NUM, 3));
-        return;
+        goto exit;
       }
 
       if (curr_grp_did_cons != (device_id - stream_id)) {
@@ -106,7 +120,7 @@ payload()
         val_print(ACS_PRINT_DEBUG,
                   "\n       StreamID-DeviceID Association Fail for Bdf : %x", bdf);
         val_set_status(pe_index, RESULT_FAIL(TEST_NUM, 4));
-        return;
+        goto exit;
       }
     }
   }
@@ -115,6 +129,10 @@ payload()
       val_set_status(pe_index, RESULT_SKIP(TEST_NUM, 1));
   else
       val_set_status(pe_index, RESULT_PASS(TEST_NUM, 1));
+
+exit:
+  if (info != NULL)
+      val_memory_free(info);
 }
 
 uint32_t
@@ -24,15 +24,14 @@
 
 static
 void
-payload()
+payload(uint32_t index)
 {
   uint64_t data = 0;
-  uint32_t index = val_pe_get_index_mpid(val_pe_get_mpid());
   uint8_t Gran4_2, Gran4;
   uint8_t Gran16_2, Gran16;
   uint8_t Gran64_2, Gran64;
 
-  data = val_pe_reg_read(ID_AA64MMFR0_EL1);
+  data = val_pe_feat_reg(index, ID_AA64MMFR0_EL1);
 
   /* TGran4_2: Stage 2 4KB Granularity support, bits [43:40] */
   Gran4_2 = VAL_EXTRACT_BITS(data, 40, 43);
@@ -108,7 +107,7 @@ hyp_c003_entry(uint32_t num_pe)
 
   status = val_initialize_test(TEST_NUM, TEST_DESC, num_pe);
   if (status != ACS_STATUS_SKIP)
-      val_run_test_payload(TEST_NUM, num_pe, payload, 0);
+      val_pe_run_feat_payload(TEST_NUM, num_pe, payload);
 
   /* get the result from all PE and check for failure */
   status = val_check_for_error(TEST_NUM, num_pe, TEST_RULE);
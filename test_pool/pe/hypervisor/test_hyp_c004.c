@@ -24,12 +24,11 @@
 
 static
 void
-payload()
+payload(uint32_t index)
 {
   uint64_t data = 0;
-  uint32_t index = val_pe_get_index_mpid(val_pe_get_mpid());
 
-  data = val_pe_reg_read(PMCR_EL0);
+  data = val_pe_feat_reg(index, PMCR_EL0);
   if (((data & 0x0F800) >> 11) > 1) //bits 15:11 for Number of counters.
       val_set_status(index, RESULT_PASS(TEST_NUM, 1));
   else
@@ -47,7 +46,7 @@ hyp_c004_entry(uint32_t num_pe)
 
   if (status != ACS_STATUS_SKIP)
       /* execute payload on present PE and then execute on other PE */
-      val_run_test_payload(TEST_NUM, num_pe, payload, 0);
+      val_pe_run_feat_payload(TEST_NUM, num_pe, payload);
 
   /* get the result from all PE and check for failure */
   status = val_check_for_error(TEST_NUM, num_pe, TEST_RULE);
@@ -17,18 +17,12 @@
 
 #include "val/include/bsa_acs_val.h"
 #include "val/include/bsa_acs_pe.h"
+#include "val/include/bsa_acs_memory.h"
 
 #define TEST_NUM   (ACS_PE_TEST_NUM_BASE  +  1)
 #define TEST_RULE  "B_PE_01"
 #define TEST_DESC  "Check Arch symmetry across PE         "
 
-#define NUM_OF_REGISTERS  32
-
-#define RAS               1
-#define SPE               2
-#define LOR               3
-#define AA32              4
-
 #define MASK_AA64MMFR0    0xF
 #define MASK_MIDR         0x00F0FFFF
 #define MASK_MPIDR        0xFF3FFFFFFF
@@ -36,153 +30,140 @@
 #define MASK_CCSIDR       0xFFFFFF8
 #define MASK_PMCR         0xFFFF
 
-#define MAX_CACHE_LEVEL   7
-
-uint64_t rd_data_array[NUM_OF_REGISTERS];
-uint64_t cache_list[MAX_CACHE_LEVEL];
+/* Snapshots of the PEs missing from the feature database, one PE_ID_REGS_STRIDE entry per PE index */
+static void *snapshot;
 
 typedef struct{
-    uint32_t reg_name;
+    uint32_t reg_id;
     uint64_t reg_mask;
     char     reg_desc[30];
-    uint8_t  dependency;
 }reg_details;
 
+/* Registers compared across PEs. Fields set in reg_mask may differ. The
+   optional feature and AArch32 registers read as 0 when not implemented. */
 reg_details reg_list[] = {
-    {CCSIDR_EL1,       MASK_CCSIDR,    "CCSIDR_EL1"      , 0x0 },
-    {ID_AA64PFR0_EL1,  0x0,            "ID_AA64PFR0_EL1" , 0x0 },
-    {ID_AA64PFR1_EL1,  0x0,            "ID_AA64PFR1_EL1" , 0x0 },
-    {ID_AA64DFR0_EL1,  0x0,            "ID_AA64DFR0_EL1" , 0x0 },
-    {ID_AA64DFR1_EL1,  0x0,            "ID_AA64DFR1_EL1" , 0x0 },
-    {ID_AA64MMFR0_EL1, MASK_AA64MMFR0, "ID_AA64MMFR0_EL1", 0x0 },
-    {ID_AA64MMFR1_EL1, 0x0,            "ID_AA64MMFR1_EL1", 0x0 },
-    //{ID_AA64MMFR2_EL1, 0x0,            "ID_AA64MMFR2_EL1", 0x0 },
-    {CTR_EL0,          MASK_CTR,       "CTR_EL0"         , 0x0 },
-    {ID_AA64ISAR0_EL1, 0x0,            "ID_AA64ISAR0_EL1", 0x0 },
-    {ID_AA64ISAR1_EL1, 0x0,            "ID_AA64ISAR1_EL1", 0x0 },
-    {MPIDR_EL1,        MASK_MPIDR,     "MPIDR_EL1"       , 0x0 },
-    {MIDR_EL1,         MASK_MIDR,      "MIDR_EL1"        , 0x0 },
-    {ID_DFR0_EL1,      0x0,            "ID_DFR0_EL1"     , AA32},
-    {ID_ISAR0_EL1,     0x0,            "ID_ISAR0_EL1"    , AA32},
-    {ID_ISAR1_EL1,     0x0,            "ID_ISAR1_EL1"    , AA32},
-    {ID_ISAR2_EL1,     0x0,            "ID_ISAR2_EL1"    , AA32},
-    {ID_ISAR3_EL1,     0x0,            "ID_ISAR3_EL1"    , AA32},
-    {ID_ISAR4_EL1,     0x0,            "ID_ISAR4_EL1"    , AA32},
-    {ID_ISAR5_EL1,     0x0,            "ID_ISAR5_EL1"    , AA32},
-    {ID_MMFR0_EL1,     0x0,            "ID_MMFR0_EL1"    , AA32},
-    {ID_MMFR1_EL1,     0x0,            "ID_MMFR1_EL1"    , AA32},
-    {ID_MMFR2_EL1,     0x0,            "ID_MMFR2_EL1"    , AA32},
-    {ID_MMFR3_EL1,     0x0,            "ID_MMFR3_EL1"    , AA32},
-    {ID_MMFR4_EL1,     0x0,            "ID_MMFR4_EL1"    , AA32},
-    {ID_PFR0_EL1,      0x0,            "ID_PFR0_EL1"     , AA32},
-    {ID_PFR1_EL1,      0x0,            "ID_PFR1_EL1"     , AA32},
-    {MVFR0_EL1,        0x0,            "MVFR0_EL1"       , AA32},
-    {MVFR1_EL1,        0x0,            "MVFR1_EL1"       , AA32},
-    {MVFR2_EL1,        0x0,            "MVFR2_EL1"       , AA32},
-    {PMCEID0_EL0,      0x0,            "PMCEID0_EL0"     , 0x0 },
-    {PMCEID1_EL0,      0x0,            "PMCEID1_EL0"     , 0x0 },
-    {PMCR_EL0,         MASK_PMCR,      "PMCR_EL0"        , 0x0 },
-    {PMBIDR_EL1,       0x0,            "PMBIDR_EL1"      , SPE },
-    {PMSIDR_EL1,       0x0,            "PMSIDR_EL1"      , SPE },
-    {ERRIDR_EL1,       0x0,            "ERRIDR_EL1"      , RAS },
-    {ERR0FR_EL1,       0x0,            "ERR0FR_EL1"      , RAS },
-    {ERR1FR_EL1,       0x0,            "ERR1FR_EL1"      , RAS },
-    {ERR2FR_EL1,       0x0,            "ERR2FR_EL1"      , RAS },
-    {ERR3FR_EL1,       0x0,            "ERR3FR_EL1"      , RAS },
-    {LORID_EL1,        0x0,            "LORID_EL1"       , LOR }
+    {PE_ID_AA64PFR0,  0x0,            "ID_AA64PFR0_EL1" },
+    {PE_ID_AA64PFR1,  0x0,            "ID_AA64PFR1_EL1" },
+    {PE_ID_AA64DFR0,  0x0,            "ID_AA64DFR0_EL1" },
+    {PE_ID_AA64DFR1,  0x0,            "ID_AA64DFR1_EL1" },
+    {PE_ID_AA64MMFR0, MASK_AA64MMFR0, "ID_AA64MMFR0_EL1"},
+    {PE_ID_AA64MMFR1, 0x0,            "ID_AA64MMFR1_EL1"},
+    {PE_ID_CTR,       MASK_CTR,       "CTR_EL0"         },
+    {PE_ID_AA64ISAR0, 0x0,            "ID_AA64ISAR0_EL1"},
+    {PE_ID_AA64ISAR1, 0x0,            "ID_AA64ISAR1_EL1"},
+    {PE_ID_MPIDR,     MASK_MPIDR,     "MPIDR_EL1"       },
+    {PE_ID_MIDR,      MASK_MIDR,      "MIDR_EL1"        },
+    {PE_ID_DFR0,      0x0,            "ID_DFR0_EL1"     },
+    {PE_ID_ISAR0,     0x0,            "ID_ISAR0_EL1"    },
+    {PE_ID_ISAR1,     0x0,            "ID_ISAR1_EL1"    },
+    {PE_ID_ISAR2,     0x0,            "ID_ISAR2_EL1"    },
+    {PE_ID_ISAR3,     0x0,            "ID_ISAR3_EL1"    },
+    {PE_ID_ISAR4,     0x0,            "ID_ISAR4_EL1"    },
+    {PE_ID_ISAR5,     0x0,            "ID_ISAR5_EL1"    },
+    {PE_ID_MMFR0,     0x0,            "ID_MMFR0_EL1"    },
+    {PE_ID_MMFR1,     0x0,            "ID_MMFR1_EL1"    },
+    {PE_ID_MMFR2,     0x0,            "ID_MMFR2_EL1"    },
+    {PE_ID_MMFR3,     0x0,            "ID_MMFR3_EL1"    },
+    {PE_ID_MMFR4,     0x0,            "ID_MMFR4_EL1"    },
+    {PE_ID_PFR0,      0x0,            "ID_PFR0_EL1"     },
+    {PE_ID_PFR1,      0x0,            "ID_PFR1_EL1"     },
+    {PE_ID_MVFR0,     0x0,            "MVFR0_EL1"       },
+    {PE_ID_MVFR1,     0x0,            "MVFR1_EL1"       },
+    {PE_ID_MVFR2,     0x0,            "MVFR2_EL1"       },
+    {PE_ID_PMCEID0,   0x0,            "PMCEID0_EL0"     },
+    {PE_ID_PMCEID1,   0x0,            "PMCEID1_EL0"     },
+    {PE_ID_PMCR,      MASK_PMCR,      "PMCR_EL0"        },
+    {PE_ID_PMBIDR,    0x0,            "PMBIDR_EL1"      },
+    {PE_ID_PMSIDR,    0x0,            "PMSIDR_EL1"      },
+    {PE_ID_ERRIDR,    0x0,            "ERRIDR_EL1"      },
+    {PE_ID_ERR0FR,    0x0,            "ERR0FR_EL1"      },
+    {PE_ID_ERR1FR,    0x0,            "ERR1FR_EL1"      },
+    {PE_ID_ERR2FR,    0x0,            "ERR2FR_EL1"      },
+    {PE_ID_ERR3FR,    0x0,            "ERR3FR_EL1"      },
+    {PE_ID_LORID,     0x0,            "LORID_EL1"       }
 };
 
-uint64_t
-return_reg_value(uint32_t reg, uint8_t dependency)
+#define NUM_OF_REGISTERS  (sizeof(reg_list) / sizeof(reg_list[0]))
+
+/* Bits compared for each snapshot register, 0 for registers not compared */
+static uint64_t cmp_mask[PE_ID_REG_NUM];
+
+static
+void
+id_regs_capture(void)
 {
-  uint64_t temp=0;
-
-  if(dependency == 0)
-      return val_pe_reg_read(reg);
-
-  switch(dependency)
-  {
-    case RAS: // If RAS is not supported, then skip register check
-        temp = val_pe_reg_read(ID_AA64PFR0_EL1);
-        temp = (temp >> 28) & 0xf;
-        if(temp == 1)
-            return val_pe_reg_read(reg);
-        else
-            return 0;
-        break;
-
-    case SPE: // If Statistical Profiling Extension is not supported, then skip register check
-        temp = val_pe_reg_read(ID_AA64DFR0_EL1);
-        temp = (temp >> 32) & 0xf;
-        if(temp == 1)
-            return val_pe_reg_read(reg);
-        else
-            return 0;
-        break;
-
-    case LOR: // If Limited Ordering Region is not supported, then skip register check
-        temp = val_pe_reg_read(ID_AA64MMFR1_EL1);
-        temp = (temp >> 16) & 0xf;
-        if(temp == 1)
-            return val_pe_reg_read(reg);
-        else
-            return 0;
-        break;
-
-    case AA32: // If the register is UNK in pure AArch64 implementation, then skip register check
-        temp = val_pe_reg_read(ID_AA64PFR0_EL1);
-        temp = (temp & 1);
-        if(temp == 0)
-            return val_pe_reg_read(reg);
-        else
-            return 0;
-        break;
-
-    default:
-        val_print(ACS_PRINT_ERR, "\n Unknown dependency = %d ", dependency);
-        return 0x0;
-  }
+  uint32_t index = val_pe_get_index_mpid(val_pe_get_mpid());
+  pe_id_regs_t *regs;
 
+  val_data_cache_ops_by_range((addr_t)&snapshot, sizeof(snapshot), INVALIDATE);
+  regs = PE_ID_REGS_ENTRY(snapshot, index);
+
+  val_pe_id_regs_snapshot(regs);
+  val_data_cache_ops_by_range((addr_t)regs, sizeof(pe_id_regs_t), CLEAN_AND_INVALIDATE);
+
+  val_set_status(index, RESULT_PASS(TEST_NUM, 1));
 }
 
+/* Print the 4-bit ID fields that differ between two register values */
+static
 void
-id_regs_check(void)
+print_diff_fields(uint64_t diff)
 {
-  uint64_t reg_read_data;
-  uint32_t index = val_pe_get_index_mpid(val_pe_get_mpid());
-  uint32_t i = 0;
-
-  /* Loop CLIDR to check if a cache level is implemented before comparing */
-  while (i < MAX_CACHE_LEVEL) {
-      reg_read_data = val_pe_reg_read(CLIDR_EL1);
-      if (reg_read_data & ((0x7) << (i * 3))) {
-          /* Select the correct cache in csselr register */
-          val_pe_reg_write(CSSELR_EL1, i << 1);
-          reg_read_data = return_reg_value(reg_list[0].reg_name, reg_list[0].dependency);
-
-          if ((reg_read_data & (~reg_list[0].reg_mask)) != (cache_list[i] & (~reg_list[0].reg_mask))) {
-              val_set_test_data(index, (reg_read_data & (~reg_list[0].reg_mask)), 0);
-              val_set_status(index, RESULT_FAIL(TEST_NUM, 1));
-              return;
-          }
+  uint32_t field;
+
+  val_print(ACS_PRINT_ERR, "\n         Differing fields:", 0);
+  for (field = 0; field < 64; field += 4) {
+      if ((diff >> field) & 0xF) {
+          val_print(ACS_PRINT_ERR, " [%d", field + 3);
+          val_print(ACS_PRINT_ERR, ":%d]", field);
       }
-      i++;
   }
+}
 
-  for (i = 1; i < NUM_OF_REGISTERS; i++) {
-      reg_read_data = return_reg_value(reg_list[i].reg_name, reg_list[i].dependency);
+/* Compare one PE against the primary, report every differing register */
+static
+uint32_t
+compare_pe(uint32_t index, pe_id_regs_t *ref, pe_id_regs_t *regs)
+{
+  uint64_t diff = 0;
+  uint64_t reg_diff;
+  uint32_t i;
 
-      if((reg_read_data & (~reg_list[i].reg_mask)) != (rd_data_array[i] & (~reg_list[i].reg_mask)))
-      {
-          val_set_test_data(index, (reg_read_data & (~reg_list[i].reg_mask)), i);
-          val_set_status(index, RESULT_FAIL(TEST_NUM, 1));
-          return;
-      }
-      reg_read_data = 0;
+  for (i = 0; i < PE_ID_REG_NUM; i++)
+      diff |= (regs->reg[i] ^ ref->reg[i]) & cmp_mask[i];
+
+  for (i = 0; i < PE_MAX_CACHE_LEVEL; i++)
+      diff |= (regs->ccsidr[i] ^ ref->ccsidr[i]) & ~MASK_CCSIDR;
+
+  if (diff == 0)
+      return 0;
+
+  for (i = 0; i < NUM_OF_REGISTERS; i++) {
+      reg_diff = (regs->reg[reg_list[i].reg_id] ^ ref->reg[reg_list[i].reg_id]) &
+                 cmp_mask[reg_list[i].reg_id];
+      if (reg_diff == 0)
+          continue;
+
+      val_print(ACS_PRINT_ERR, "\n       Reg compare failed for PE index=%d for Register: ", index);
+      val_print(ACS_PRINT_ERR, reg_list[i].reg_desc, 0);
+      val_print(ACS_PRINT_ERR, "\n       Current PE value = 0x%llx",
+                ref->reg[reg_list[i].reg_id] & cmp_mask[reg_list[i].reg_id]);
+      val_print(ACS_PRINT_ERR, "         Other PE value = 0x%llx",
+                regs->reg[reg_list[i].reg_id] & cmp_mask[reg_list[i].reg_id]);
+      print_diff_fields(reg_diff);
   }
-  val_set_status(index, RESULT_PASS(TEST_NUM, 1));
 
-  return;
+  for (i = 0; i < PE_MAX_CACHE_LEVEL; i++) {
+      if (((regs->ccsidr[i] ^ ref->ccsidr[i]) & ~MASK_CCSIDR) == 0)
+          continue;
+
+      val_print(ACS_PRINT_ERR, "\n       Reg compare failed for PE index=%d for Register: ", index);
+      val_print(ACS_PRINT_ERR, "CCSIDR_EL1 of cache level %d", i + 1);
+      val_print(ACS_PRINT_ERR, "\n       Current PE value = 0x%llx", ref->ccsidr[i] & ~MASK_CCSIDR);
+      val_print(ACS_PRINT_ERR, "         Other PE value = 0x%llx", regs->ccsidr[i] & ~MASK_CCSIDR);
+  }
+
+  return 1;
 }
 
 static
@@ -192,7 +173,10 @@ payload(uint32_t num_pe)
   uint32_t my_index = val_pe_get_index_mpid(val_pe_get_mpid());
   uint32_t i;
   uint32_t timeout;
-  uint64_t reg_read_data, debug_data=0, array_index=0;
+  uint32_t status = 0;
+  pe_id_regs_t *ref;
+  pe_id_regs_t *regs;
+  void *mem;
 
   if (num_pe == 1) {
       val_print(ACS_PRINT_DEBUG, "\n       Skipping as num of PE is 1    ", 0);
@@ -200,48 +184,71 @@ payload(uint32_t num_pe)
       return;
   }
 
-  /* Loop CLIDR to check if a cache level is implemented */
-  i = 0;
-  while (i < MAX_CACHE_LEVEL) {
-      reg_read_data = val_pe_reg_read(CLIDR_EL1);
-      if (reg_read_data & ((0x7) << (i * 3))) {
-         /* Select the correct cache level in csselr register */
-         val_pe_reg_write(CSSELR_EL1, i << 1);
-         cache_list[i] = return_reg_value(reg_list[0].reg_name, reg_list[0].dependency);
-         val_data_cache_ops_by_va((addr_t)(cache_list + i), CLEAN_AND_INVALIDATE);
-         val_print(ACS_PRINT_INFO, "\n       cache size read is %x ", cache_list[i]);
-      }
-      i++;
+  /* Snapshots of PEs missing from the feature database. Cache line
+     aligned entries so each PE writes back only its own lines */
+  mem = val_memory_alloc(num_pe * PE_ID_REGS_STRIDE + 64);
+  if (mem == NULL) {
+      val_print(ACS_PRINT_ERR, "\n       Allocation for PE snapshots failed", 0);
+      val_set_status(my_index, RESULT_FAIL(TEST_NUM, 3));
+      return;
+  }
+
+  snapshot = (void *)(((addr_t)mem + 63) & ~(addr_t)63);
+  val_data_cache_ops_by_range((addr_t)&snapshot, sizeof(snapshot), CLEAN_AND_INVALIDATE);
+
+  for (i = 0; i < NUM_OF_REGISTERS; i++)
+      cmp_mask[reg_list[i].reg_id] = ~reg_list[i].reg_mask;
+
+  ref = val_pe_feat_db_get(my_index);
+  if (ref == NULL) {
+      ref = PE_ID_REGS_ENTRY(snapshot, my_index);
+      val_pe_id_regs_snapshot(ref);
   }
 
-  for (i = 1; i < NUM_OF_REGISTERS; i++) {
-      rd_data_array[i] = return_reg_value(reg_list[i].reg_name, reg_list[i].dependency);
-      val_data_cache_ops_by_va((addr_t)(rd_data_array + i), CLEAN_AND_INVALIDATE);
+  for (i = 0; i < PE_MAX_CACHE_LEVEL; i++)
+      if (ref->ccsidr[i])
+          val_print(ACS_PRINT_INFO, "\n       cache size read is %x ", ref->ccsidr[i]);
+
+  /* PEs missing from the feature database capture their registers now,
+     all in a single dispatch round */
+  for (i = 0; i < num_pe; i++) {
+      if ((i != my_index) && (val_pe_feat_db_get(i) == NULL))
+          val_execute_on_pe(i, id_regs_capture, 0);
   }
 
   for (i = 0; i < num_pe; i++) {
-      if (i != my_index) {
-          timeout=TIMEOUT_LARGE;
-          val_execute_on_pe(i, id_regs_check, 0);
+      if (i == my_index)
+          continue;
+
+      regs = val_pe_feat_db_get(i);
+      if (regs == NULL) {
+          timeout = TIMEOUT_LARGE;
           while ((--timeout) && (IS_RESULT_PENDING(val_get_status(i))));
 
-          if(timeout == 0) {
+          if (timeout == 0) {
               val_print(ACS_PRINT_ERR, "\n       **Timed out** for PE index = %d", i);
               val_set_status(i, RESULT_FAIL(TEST_NUM, 2));
-              return;
+              status = 1;
+              continue;
           }
 
-          if(IS_TEST_FAIL(val_get_status(i))) {
-              val_get_test_data(i, &debug_data, &array_index);
-              val_print(ACS_PRINT_ERR, "\n       Reg compare failed for PE index=%d for Register: ", i);
-              val_print(ACS_PRINT_ERR, reg_list[array_index].reg_desc, 0);
-              val_print(ACS_PRINT_ERR, "\n       Current PE value = 0x%llx", rd_data_array[array_index] & (~reg_list[array_index].reg_mask));
-              val_print(ACS_PRINT_ERR, "         Other PE value = 0x%llx", debug_data);
-              return;
-          }
+          regs = PE_ID_REGS_ENTRY(snapshot, i);
+          val_data_cache_ops_by_range((addr_t)regs, sizeof(pe_id_regs_t), INVALIDATE);
+      }
+
+      if (compare_pe(i, ref, regs)) {
+          val_set_status(i, RESULT_FAIL(TEST_NUM, 1));
+          status = 1;
+      } else {
+          val_set_status(i, RESULT_PASS(TEST_NUM, 1));
       }
   }
 
+  val_memory_free(mem);
+
+  if (status == 0)
+      val_set_status(my_index, RESULT_PASS(TEST_NUM, 1));
+
   return;
 
 }
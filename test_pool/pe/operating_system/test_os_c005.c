@@ -24,13 +24,12 @@
 
 static
 void
-payload()
+payload(uint32_t index)
 {
   uint64_t data = 0;
   uint64_t pfr0, a32_support;
-  uint32_t index = val_pe_get_index_mpid(val_pe_get_mpid());
 
-  pfr0 = val_pe_reg_read(ID_AA64PFR0_EL1);
+  pfr0 = val_pe_feat_reg(index, ID_AA64PFR0_EL1);
   a32_support = ((pfr0 & 0xf000) == 0x2000) ? 1:((pfr0 & 0xf00) == 0x200) ? \
                 1:((pfr0 & 0xf0) == 0x20) ? 1:((pfr0 & 0xf) == 0x2) ? 1:0;
 
@@ -39,7 +38,7 @@ payload()
       return;
   }
 
-  data = val_pe_reg_read(ID_MMFR0_EL1);
+  data = val_pe_feat_reg(index, ID_MMFR0_EL1);
 
   if ((((data >> 28) & 0xF) == 1) && (((data >> 12) & 0xF) == 1)) //bits 31:28 and 15:12 should be 1
       val_set_status(index, RESULT_PASS(TEST_NUM, 1));
@@ -58,7 +57,7 @@ os_c005_entry(uint32_t num_pe)
 
   status = val_initialize_test(TEST_NUM, TEST_DESC, num_pe);
   if (status != ACS_STATUS_SKIP)
-      val_run_test_payload(TEST_NUM, num_pe, payload, 0);
+      val_pe_run_feat_payload(TEST_NUM, num_pe, payload);
 
   /* get the result from all PE and check for failure */
   status = val_check_for_error(TEST_NUM, num_pe, TEST_RULE);
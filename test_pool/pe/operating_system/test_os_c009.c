@@ -24,17 +24,16 @@
 
 static
 void
-payload()
+payload(uint32_t index)
 {
   uint64_t data = 0;
-  uint32_t index = val_pe_get_index_mpid(val_pe_get_mpid());
 
   /* Check ID_AA64DFR0_EL1[11:8] for PMUver */
-  data = VAL_EXTRACT_BITS(val_pe_reg_read(ID_AA64DFR0_EL1), 8, 11);
+  data = VAL_EXTRACT_BITS(val_pe_feat_reg(index, ID_AA64DFR0_EL1), 8, 11);
 
   if ((data != 0x0) && (data != 0xF)) {
     /* PMCR_EL0 Bits 15:11 for Number of counters. */
-    data = VAL_EXTRACT_BITS(val_pe_reg_read(PMCR_EL0), 11, 15);
+    data = VAL_EXTRACT_BITS(val_pe_feat_reg(index, PMCR_EL0), 11, 15);
     if (data > 3)
         val_set_status(index, RESULT_PASS(TEST_NUM, 1));
     else
@@ -58,7 +57,7 @@ os_c009_entry(uint32_t num_pe)
 
   if (status != ACS_STATUS_SKIP)
       /* execute payload on present PE and then execute on other PE */
-      val_run_test_payload(TEST_NUM, num_pe, payload, 0);
+      val_pe_run_feat_payload(TEST_NUM, num_pe, payload);
 
   /* get the result from all PE and check for failure */
   status = val_check_for_error(TEST_NUM, num_pe, TEST_RULE);
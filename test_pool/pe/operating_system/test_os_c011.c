@@ -24,14 +24,13 @@
 
 static
 void
-payload()
+payload(uint32_t pe_index)
 {
   uint64_t data = 0;
   int32_t  breakpointcount;
   uint32_t context_aware_breakpoints = 0;
-  uint32_t pe_index = val_pe_get_index_mpid(val_pe_get_mpid());
 
-  data = val_pe_reg_read(ID_AA64DFR0_EL1);
+  data = val_pe_feat_reg(pe_index, ID_AA64DFR0_EL1);
 
   /* bits 15:12 for Number of breakpoints - 1 */
   breakpointcount = VAL_EXTRACT_BITS(data, 12, 15) + 1;
@@ -62,7 +61,7 @@ os_c011_entry(uint32_t num_pe)
   status = val_initialize_test(TEST_NUM, TEST_DESC, num_pe);
   if (status != ACS_STATUS_SKIP)
       /* execute payload on present PE and then execute on other PE */
-      val_run_test_payload(TEST_NUM, num_pe, payload, 0);
+      val_pe_run_feat_payload(TEST_NUM, num_pe, payload);
 
   /* get the result from all PE and check for failure */
   status = val_check_for_error(TEST_NUM, num_pe, TEST_RULE);
@@ -24,12 +24,11 @@
 
 static
 void
-payload()
+payload(uint32_t index)
 {
   uint64_t data = 0;
-  uint32_t index = val_pe_get_index_mpid(val_pe_get_mpid());
 
-  data = val_pe_reg_read(ID_AA64ISAR0_EL1);
+  data = val_pe_feat_reg(index, ID_AA64ISAR0_EL1);
 
   if ((data >> 16) & 0xF) //bits 19:16 are CRC32 and should not be zero
         val_set_status(index, RESULT_PASS(TEST_NUM, 1));
@@ -49,7 +48,7 @@ os_c013_entry(uint32_t num_pe)
   status = val_initialize_test(TEST_NUM, TEST_DESC, num_pe);
 
   if (status != ACS_STATUS_SKIP)
-      val_run_test_payload(TEST_NUM, num_pe, payload, 0);
+      val_pe_run_feat_payload(TEST_NUM, num_pe, payload);
 
   /* get the result from all PE and check for failure */
   status = val_check_for_error(TEST_NUM, num_pe, TEST_RULE);
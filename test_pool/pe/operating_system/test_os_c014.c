@@ -40,10 +40,9 @@ static void check_pauth_algorithm(uint32_t index, uint64_t data)
 
 static
 void
-payload()
+payload(uint32_t index)
 {
-    uint64_t data = val_pe_reg_read(ID_AA64ISAR1_EL1);
-    uint32_t index = val_pe_get_index_mpid(val_pe_get_mpid());
+    uint64_t data = val_pe_feat_reg(index, ID_AA64ISAR1_EL1);
 
 
     /* Pointer signing is optional, Check if Pointer signing is implemented */
@@ -67,7 +66,7 @@ os_c014_entry(uint32_t num_pe)
     status = val_initialize_test(TEST_NUM, TEST_DESC, num_pe);
     /* This check is when user is forcing us to skip this test */
     if (status != ACS_STATUS_SKIP)
-        val_run_test_payload(TEST_NUM, num_pe, payload, 0);
+        val_pe_run_feat_payload(TEST_NUM, num_pe, payload);
 
     /* get the result from all PE and check for failure */
     status = val_check_for_error(TEST_NUM, num_pe, TEST_RULE);
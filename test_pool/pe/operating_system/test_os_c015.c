@@ -25,14 +25,13 @@
 
 static
 void
-payload()
+payload(uint32_t index)
 {
     uint64_t data = 0;
-    uint32_t index = val_pe_get_index_mpid(val_pe_get_mpid());
 
 
     /* Read ID_AA64PFR0_EL1.SVE[35:32] = 0b0001 for SVE */
-    data = VAL_EXTRACT_BITS(val_pe_reg_read(ID_AA64PFR0_EL1), 32, 35);
+    data = VAL_EXTRACT_BITS(val_pe_feat_reg(index, ID_AA64PFR0_EL1), 32, 35);
 
     if (data == 0) {
        /* SVE Not Implemented Skip the test */
@@ -41,7 +40,7 @@ payload()
     }
 
     /* Read ID_AA64DFR0_EL1.PMSVer[35:32] = 0b0010 */
-    data = VAL_EXTRACT_BITS(val_pe_reg_read(ID_AA64DFR0_EL1), 32, 35);
+    data = VAL_EXTRACT_BITS(val_pe_feat_reg(index, ID_AA64DFR0_EL1), 32, 35);
 
     if (data == 0) {
         /*SPE Not Implemented Skip the test */
@@ -63,7 +62,7 @@ os_c015_entry(uint32_t num_pe)
     status = val_initialize_test(TEST_NUM, TEST_DESC, num_pe);
     /* This check is when user is forcing us to skip this test */
     if (status != ACS_STATUS_SKIP)
-        val_run_test_payload(TEST_NUM, num_pe, payload, 0);
+        val_pe_run_feat_payload(TEST_NUM, num_pe, payload);
 
     /* get the result from all PE and check for failure */
     status = val_check_for_error(TEST_NUM, num_pe, TEST_RULE);
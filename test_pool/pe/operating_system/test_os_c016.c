@@ -25,16 +25,15 @@
 
 static
 void
-payload()
+payload(uint32_t index)
 {
     uint64_t data_csv2 = 0;
     uint64_t data_csv3 = 0;
-    uint32_t index = val_pe_get_index_mpid(val_pe_get_mpid());
 
     /* ID_AA64PFR0_EL1.CSV2[59:56] = 0b0010 Speculative use of Out of Ctxt Branch Targets */
     /* ID_AA64PFR0_EL1.CSV3[63:60] = 0b0001 Speculative use of Faulting data */
-    data_csv2 = VAL_EXTRACT_BITS(val_pe_reg_read(ID_AA64PFR0_EL1), 56, 59);
-    data_csv3 = VAL_EXTRACT_BITS(val_pe_reg_read(ID_AA64PFR0_EL1), 60, 63);
+    data_csv2 = VAL_EXTRACT_BITS(val_pe_feat_reg(index, ID_AA64PFR0_EL1), 56, 59);
+    data_csv3 = VAL_EXTRACT_BITS(val_pe_feat_reg(index, ID_AA64PFR0_EL1), 60, 63);
 
     if (data_csv2 != 2)
         val_set_status(index, RESULT_FAIL(TEST_NUM, 1));
@@ -52,7 +51,7 @@ os_c016_entry(uint32_t num_pe)
     status = val_initialize_test(TEST_NUM, TEST_DESC, num_pe);
     /* This check is when user is forcing us to skip this test */
     if (status != ACS_STATUS_SKIP)
-        val_run_test_payload(TEST_NUM, num_pe, payload, 0);
+        val_pe_run_feat_payload(TEST_NUM, num_pe, payload);
 
     /* get the result from all PE and check for failure */
     status = val_check_for_error(TEST_NUM, num_pe, TEST_RULE);
@@ -25,13 +25,12 @@
 
 static
 void
-payload()
+payload(uint32_t index)
 {
     uint64_t data = 0;
-    uint32_t index = val_pe_get_index_mpid(val_pe_get_mpid());
 
     /* Read ID_AA64PFR1_EL1[7:4] != 0 For CSDB, SSBB and PSSBB barriers  */
-    data = VAL_EXTRACT_BITS(val_pe_reg_read(ID_AA64PFR1_EL1), 4, 7);
+    data = VAL_EXTRACT_BITS(val_pe_feat_reg(index, ID_AA64PFR1_EL1), 4, 7);
 
     if (data == 0)
         val_set_status(index, RESULT_FAIL(TEST_NUM, 1));
@@ -47,7 +46,7 @@ os_c018_entry(uint32_t num_pe)
     status = val_initialize_test(TEST_NUM, TEST_DESC, num_pe);
     /* This check is when user is forcing us to skip this test */
     if (status != ACS_STATUS_SKIP)
-        val_run_test_payload(TEST_NUM, num_pe, payload, 0);
+        val_pe_run_feat_payload(TEST_NUM, num_pe, payload);
 
     /* get the result from all PE and check for failure */
     status = val_check_for_error(TEST_NUM, num_pe, TEST_RULE);
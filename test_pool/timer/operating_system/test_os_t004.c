@@ -25,32 +25,28 @@
 #define TEST_RULE  "B_TIME_08"
 #define TEST_DESC  "Generate Mem Mapped SYS Timer Intr    "
 
-static uint32_t intid;
-static uint64_t cnt_base_n;
+#define SYS_TIMER_MAX_WAIT  16
 
 static
 void
-isr()
+stop_sys_timer(uint64_t cnt_base_n)
 {
-  uint32_t index = val_pe_get_index_mpid(val_pe_get_mpid());
-
-  val_print(ACS_PRINT_INFO, "\n       Received interrupt   ", 0);
   val_timer_disable_system_timer((addr_t)cnt_base_n);
-  val_set_status(index, RESULT_PASS(TEST_NUM, 1));
-  val_gic_end_of_interrupt(intid);
 }
 
-
 static
 void
 payload()
 {
 
-  volatile uint32_t timeout;
   uint32_t timer_expire_val = TIMEOUT_MEDIUM;
-  uint32_t status, ns_timer = 0;
+  uint32_t status, intid, ns_timer = 0;
+  uint32_t slot[SYS_TIMER_MAX_WAIT];
+  uint32_t timer_intid[SYS_TIMER_MAX_WAIT];
   uint32_t index = val_pe_get_index_mpid(val_pe_get_mpid());
   uint64_t timer_num = val_timer_get_info(TIMER_INFO_NUM_PLATFORM_TIMERS, 0);
+  uint64_t cnt_base_n, start, latency_ns;
+  uint32_t i;
 
   if (!timer_num) {
       val_print(ACS_PRINT_DEBUG, "\n       No System timers are defined  ", 0);
@@ -58,21 +54,24 @@ payload()
       return;
   }
 
+  val_intr_wait_init();
+
+  /* Start all non-secure system timers and wait for them together */
   while (timer_num) {
       timer_num--;  //array index starts from 0, so subtract 1 from count
 
       if (val_timer_get_info(TIMER_INFO_IS_PLATFORM_TIMER_SECURE, timer_num))
           continue;    //Skip Secure Timer
 
-      ns_timer++;
-      timeout = TIMEOUT_LARGE;
-      val_set_status(index, RESULT_PENDING(TEST_NUM));     // Set the initial result to pending
+      if (ns_timer == SYS_TIMER_MAX_WAIT)
+          break;
 
       //Read CNTACR to determine whether access permission from NS state is permitted
       status = val_timer_skip_if_cntbase_access_not_allowed(timer_num);
       if (status == ACS_STATUS_SKIP) {
           val_print(ACS_PRINT_WARN,
                     "\n       Security doesn't allow access to timer registers      ", 0);
+          val_intr_wait_cancel();
           val_set_status(index, RESULT_SKIP(TEST_NUM, 2));
           return;
       }
@@ -80,29 +79,26 @@ payload()
       cnt_base_n = val_timer_get_info(TIMER_INFO_SYS_CNT_BASE_N, timer_num);
       if (cnt_base_n == 0) {
           val_print(ACS_PRINT_WARN, "\n       CNT_BASE_N is zero                 ", 0);
+          val_intr_wait_cancel();
           val_set_status(index, RESULT_SKIP(TEST_NUM, 3));
           return;
       }
 
       /* Install ISR */
       intid = val_timer_get_info(TIMER_INFO_SYS_INTID, timer_num);
-      if (val_gic_install_isr(intid, isr)) {
+      slot[ns_timer] = val_intr_wait_add(intid, stop_sys_timer, cnt_base_n);
+      if (slot[ns_timer] == INTR_WAIT_ERR) {
           val_print(ACS_PRINT_ERR, "\n       GIC Install Handler Failed...", 0);
+          val_intr_wait_cancel();
           val_set_status(index, RESULT_FAIL(TEST_NUM, 1));
           return;
       }
 
       /* enable System timer */
+      start = val_timer_get_counter();
       val_timer_set_system_timer((addr_t)cnt_base_n, timer_expire_val);
-
-      while ((--timeout > 0) && (IS_RESULT_PENDING(val_get_status(index))))
-      ;
-
-      if (timeout == 0) {
-          val_print(ACS_PRINT_ERR, "\n       Sys timer interrupt not received on %d   ", intid);
-          val_set_status(index, RESULT_FAIL(TEST_NUM, 2));
-          return;
-      }
+      val_intr_wait_armed(slot[ns_timer], start + timer_expire_val);
+      timer_intid[ns_timer++] = intid;
   }
 
   if (!ns_timer) {
@@ -111,6 +107,30 @@ payload()
       return;
   }
 
+  val_intr_wait(TIMEOUT_LARGE);
+
+  status = RESULT_PASS(TEST_NUM, 1);
+  for (i = 0; i < ns_timer; i++) {
+      switch (val_intr_wait_result(slot[i], &latency_ns)) {
+      case INTR_WAIT_TAKEN:
+          val_print(ACS_PRINT_INFO, "\n       Sys timer interrupt %d latency (ns) : ",
+                    timer_intid[i]);
+          val_print(ACS_PRINT_INFO, "%d", latency_ns);
+          break;
+      case INTR_WAIT_EARLY:
+          val_print(ACS_PRINT_WARN, "\n       Sys timer interrupt %d before expiry, early by (ns) : ",
+                    timer_intid[i]);
+          val_print(ACS_PRINT_WARN, "%d", latency_ns);
+          break;
+      default:
+          val_print(ACS_PRINT_ERR, "\n       Sys timer interrupt not received on %d   ",
+                    timer_intid[i]);
+          status = RESULT_FAIL(TEST_NUM, 2);
+          break;
+      }
+  }
+
+  val_set_status(index, status);
 }
 
 uint32_t
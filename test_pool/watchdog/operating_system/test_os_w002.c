@@ -25,30 +25,29 @@
 #define TEST_RULE  "B_WD_03"
 #define TEST_DESC  "Check Watchdog WS0 interrupt          "
 
-static uint32_t int_id;
-static uint64_t wd_num;
+#define WD_MAX_WAIT     16
+#define WD_WS0_TIMEOUT  1       ///< Seconds to WS0
 
 static
 void
-isr()
+stop_wd(uint64_t wd_index)
 {
-  uint32_t index = val_pe_get_index_mpid(val_pe_get_mpid());
-  val_wd_set_ws0(wd_num, 0);
-  val_print(ACS_PRINT_DEBUG, "\n       Received WS0 interrupt                ", 0);
-  val_set_status(index, RESULT_PASS(TEST_NUM, 1));
-  val_gic_end_of_interrupt(int_id);
+  val_wd_set_ws0((uint32_t)wd_index, 0);
 }
 
-
 static
 void
 payload()
 {
 
-  uint32_t status, timeout, ns_wdg = 0;
-  uint64_t timer_expire_ticks = 1;
+  uint32_t status, int_id, ns_wdg = 0;
+  uint32_t slot[WD_MAX_WAIT];
+  uint32_t wd_index[WD_MAX_WAIT];
   uint32_t index = val_pe_get_index_mpid(val_pe_get_mpid());
-  wd_num = val_wd_get_info(0, WD_INFO_COUNT);
+  uint64_t wd_num = val_wd_get_info(0, WD_INFO_COUNT);
+  uint64_t counter_freq = val_timer_get_info(TIMER_INFO_CNTFREQ, 0);
+  uint64_t start, latency_ns;
+  uint32_t i;
 
   if (wd_num == 0) {
       val_print(ACS_PRINT_DEBUG, "\n       No Watchdogs reported          %d  ", wd_num);
@@ -56,21 +55,25 @@ payload()
       return;
   }
 
+  val_intr_wait_init();
+
+  /* Arm WS0 of all non-secure watchdogs and wait for them together */
   do {
       wd_num--;         //array index starts from 0, so subtract 1 from count
 
       if (val_wd_get_info(wd_num, WD_INFO_ISSECURE))
           continue;    //Skip Secure watchdog
 
-      ns_wdg++;
-      timeout = val_timer_get_info(TIMER_INFO_CNTFREQ, 0) * 2;
-      val_set_status(index, RESULT_PENDING(TEST_NUM));     // Set the initial result to pending
+      if (ns_wdg == WD_MAX_WAIT)
+          break;
 
       int_id       = val_wd_get_info(wd_num, WD_INFO_GSIV);
       val_print(ACS_PRINT_DEBUG, "\n       WS0 Interrupt id  %d        ", int_id);
 
-      if (val_gic_install_isr(int_id, isr)) {
+      slot[ns_wdg] = val_intr_wait_add(int_id, stop_wd, wd_num);
+      if (slot[ns_wdg] == INTR_WAIT_ERR) {
           val_print(ACS_PRINT_ERR, "\n       GIC Install Handler Failed...", 0);
+          val_intr_wait_cancel();
           val_set_status(index, RESULT_FAIL(TEST_NUM, 1));
           return;
       }
@@ -81,20 +84,17 @@ payload()
       else
           val_gic_set_intr_trigger(int_id, INTR_TRIGGER_INFO_LEVEL_HIGH);
 
-      status = val_wd_set_ws0(wd_num, timer_expire_ticks);
+      start = val_timer_get_counter();
+      status = val_wd_set_ws0(wd_num, WD_WS0_TIMEOUT);
       if (status) {
           val_print(ACS_PRINT_ERR, "\n       Setting watchdog timeout failed", 0);
+          val_intr_wait_cancel();
           val_set_status(index, RESULT_FAIL(TEST_NUM, 2));
           return;
       }
 
-      while ((--timeout > 0) && (IS_RESULT_PENDING(val_get_status(index))));
-
-      if (timeout == 0) {
-          val_print(ACS_PRINT_ERR, "\n       WS0 Interrupt not received on %d   ", int_id);
-          val_set_status(index, RESULT_FAIL(TEST_NUM, 2));
-          return;
-      }
+      val_intr_wait_armed(slot[ns_wdg], start + counter_freq * WD_WS0_TIMEOUT);
+      wd_index[ns_wdg++] = wd_num;
 
   } while(wd_num);
 
@@ -104,6 +104,30 @@ payload()
       return;
   }
 
+  /* Allow one more timeout period before declaring the interrupt lost */
+  val_intr_wait(counter_freq * WD_WS0_TIMEOUT);
+
+  status = RESULT_PASS(TEST_NUM, 1);
+  for (i = 0; i < ns_wdg; i++) {
+      int_id = val_wd_get_info(wd_index[i], WD_INFO_GSIV);
+      switch (val_intr_wait_result(slot[i], &latency_ns)) {
+      case INTR_WAIT_TAKEN:
+          val_print(ACS_PRINT_INFO, "\n       WS0 interrupt %d latency (ns) : ", int_id);
+          val_print(ACS_PRINT_INFO, "%d", latency_ns);
+          break;
+      case INTR_WAIT_EARLY:
+          val_print(ACS_PRINT_WARN, "\n       WS0 interrupt %d before timeout, early by (ns) : ",
+                    int_id);
+          val_print(ACS_PRINT_WARN, "%d", latency_ns);
+          break;
+      default:
+          val_print(ACS_PRINT_ERR, "\n       WS0 Interrupt not received on %d   ", int_id);
+          status = RESULT_FAIL(TEST_NUM, 2);
+          break;
+      }
+  }
+
+  val_set_status(index, status);
 }
 
 uint32_t
@@ -33,6 +33,11 @@
 UINT32  g_print_level;
 UINT32  g_sw_view[3] = {1, 1, 1}; //Operating System, Hypervisor, Platform Security
 UINT32  g_skip_test_num[9] = {10000, 10000, 10000, 10000, 10000, 10000, 10000, 10000, 10000};
+UINT32  g_perf_mode;
+UINT32  g_profile_mode;
+UINT32  g_concurrent_mode;
+UINT32  g_traffic_duration_ms;
+UINT32  g_test_timeout_ms;
 UINT32  g_bsa_tests_total;
 UINT32  g_bsa_tests_pass;
 UINT32  g_bsa_tests_fail;
@@ -42,6 +47,8 @@ UINT64  g_ret_addr;
 SHELL_FILE_HANDLE g_bsa_log_file_handle;
 SHELL_FILE_HANDLE g_dtb_log_file_handle;
 
+STATIC VOID       *gSnapshotBuffer;
+
 STATIC VOID FlushImage (VOID)
 {
   EFI_LOADED_IMAGE_PROTOCOL   *ImageInfo;
@@ -99,6 +106,7 @@ createGicInfoTable (
     return Status;
   }
 
+  val_snapshot_register(SNAPSHOT_GIC_INFO, GicInfoTable, GIC_INFO_TBL_SZ);
   Status = val_gic_create_info_table(GicInfoTable);
 
   return Status;
@@ -132,6 +140,7 @@ createTimerInfoTable(
     Print(L"Allocate Pool failed %x \n", Status);
     return Status;
   }
+  val_snapshot_register(SNAPSHOT_TIMER_INFO, TimerInfoTable, TIMER_INFO_TBL_SZ);
   val_timer_create_info_table(TimerInfoTable);
 
   return Status;
@@ -153,6 +162,7 @@ createWatchdogInfoTable(
     Print(L"Allocate Pool failed %x \n", Status);
     return Status;
   }
+  val_snapshot_register(SNAPSHOT_WD_INFO, WdInfoTable, WD_INFO_TBL_SZ);
   val_wd_create_info_table(WdInfoTable);
 
   return Status;
@@ -189,6 +199,7 @@ createPcieVirtInfoTable(
     Print(L"Allocate Pool failed %x \n", Status);
     return Status;
   }
+  val_snapshot_register(SNAPSHOT_IOVIRT_INFO, IoVirtInfoTable, IOVIRT_INFO_TBL_SZ);
   val_iovirt_create_info_table(IoVirtInfoTable);
 
   return Status;
@@ -212,6 +223,7 @@ createPeripheralInfoTable(
     Print(L"Allocate Pool failed %x \n", Status);
     return Status;
   }
+  val_snapshot_register(SNAPSHOT_PERIPHERAL_INFO, PeripheralInfoTable, PERIPHERAL_INFO_TBL_SZ);
   val_peripheral_create_info_table(PeripheralInfoTable);
 
   Status = gBS->AllocatePool (EfiBootServicesData,
@@ -229,6 +241,115 @@ createPeripheralInfoTable(
   return Status;
 }
 
+/**
+  @brief  Read a platform snapshot saved by an earlier run. The info tables
+          created afterwards are restored from it instead of being parsed
+          from ACPI/DT, provided the firmware tables are unchanged.
+
+  @param  FileName  Snapshot file
+
+  @return EFI_SUCCESS if the snapshot will be used
+**/
+EFI_STATUS
+loadPlatformSnapshot (
+  CONST CHAR16 *FileName
+  )
+{
+  SHELL_FILE_HANDLE Handle;
+  EFI_STATUS        Status;
+  UINT64            FileSize;
+  UINTN             ReadSize;
+
+  Status = ShellOpenFileByName(FileName, &Handle, EFI_FILE_MODE_READ, 0x0);
+  if (EFI_ERROR(Status))
+    return Status;
+
+  Status = ShellGetFileSize(Handle, &FileSize);
+  if (EFI_ERROR(Status) || (FileSize == 0) || (FileSize > MAX_UINT32)) {
+    ShellCloseFile(&Handle);
+    return EFI_LOAD_ERROR;
+  }
+
+  Status = gBS->AllocatePool(EfiBootServicesData, (UINTN)FileSize, (VOID **) &gSnapshotBuffer);
+  if (EFI_ERROR(Status)) {
+    ShellCloseFile(&Handle);
+    return Status;
+  }
+
+  ReadSize = (UINTN)FileSize;
+  Status = ShellReadFile(Handle, &ReadSize, gSnapshotBuffer);
+  ShellCloseFile(&Handle);
+
+  if (EFI_ERROR(Status) || (ReadSize != FileSize) ||
+      val_snapshot_load(gSnapshotBuffer, (UINT32)FileSize)) {
+    gBS->FreePool(gSnapshotBuffer);
+    gSnapshotBuffer = NULL;
+    return EFI_LOAD_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  @brief  Write the platform snapshot after the info tables are created,
+          unless every table was restored from the current one.
+
+  @param  FileName  Snapshot file
+
+  @return None
+**/
+VOID
+savePlatformSnapshot (
+  CONST CHAR16 *FileName
+  )
+{
+  SHELL_FILE_HANDLE Handle;
+  EFI_STATUS        Status;
+  VOID              *Buffer;
+  UINTN             Size;
+
+  val_snapshot_release();
+  if (gSnapshotBuffer) {
+    gBS->FreePool(gSnapshotBuffer);
+    gSnapshotBuffer = NULL;
+  }
+
+  if (val_snapshot_is_restored())
+    return;
+
+  Size = val_snapshot_get_size();
+  Status = gBS->AllocatePool(EfiBootServicesData, Size, (VOID **) &Buffer);
+  if (EFI_ERROR(Status)) {
+    Print(L"Allocate Pool failed %x \n", Status);
+    return;
+  }
+
+  if (val_snapshot_save(Buffer, (UINT32)Size)) {
+    Print(L" Platform snapshot not saved\n");
+    gBS->FreePool(Buffer);
+    return;
+  }
+
+  /* Replace any stale snapshot rather than writing over it */
+  if (!EFI_ERROR(ShellOpenFileByName(FileName, &Handle,
+                 EFI_FILE_MODE_WRITE | EFI_FILE_MODE_READ, 0x0)))
+    ShellDeleteFile(&Handle);
+
+  Status = ShellOpenFileByName(FileName, &Handle,
+           EFI_FILE_MODE_WRITE | EFI_FILE_MODE_READ | EFI_FILE_MODE_CREATE, 0x0);
+  if (!EFI_ERROR(Status)) {
+    Status = ShellWriteFile(Handle, &Size, Buffer);
+    ShellCloseFile(&Handle);
+  }
+
+  if (EFI_ERROR(Status))
+    Print(L" Failed to write platform snapshot %s\n", FileName);
+  else
+    Print(L" Platform snapshot saved to %s\n", FileName);
+
+  gBS->FreePool(Buffer);
+}
+
 VOID
 freeBsaAcsMem()
 {
@@ -248,7 +369,7 @@ HelpMsg (
   VOID
   )
 {
-  Print (L"\nUsage: Bsa.efi [-v <n>] | [-f <filename>] | [-skip <n>]\n"
+  Print (L"\nUsage: Bsa.efi [-v <n>] | [-f <filename>] | [-skip <n>] | [-perf] | [-profile] | [-cfgshadow] | [-cache <filename>] | [-traffic <ms>] | [-concurrent] | [-timeout <ms>]\n"
          "Options:\n"
          "-v      Verbosity of the Prints\n"
          "        1 shows all prints, 5 shows Errors\n"
@@ -261,6 +382,17 @@ HelpMsg (
          "-hyp    Enable the execution of hypervisor tests\n"
          "-ps     Enable the execution of platform security tests\n"
          "-dtb    Enable the execution of dtb dump\n"
+         "-perf   Enable the execution of performance benchmarks\n"
+         "-profile Report PMU cycles, IPC and cache miss rates for every test\n"
+         "-cfgshadow Serve read-only PCIe config space registers from a shadow copy\n"
+         "-cache  Platform snapshot file. Reuses the platform information from\n"
+         "        an earlier run while the ACPI/DT tables are unchanged\n"
+         "-traffic Run concurrent exerciser traffic for <ms> milliseconds\n"
+         "        with one PE driving each exerciser\n"
+         "-concurrent Run independent single PE tests in parallel on the\n"
+         "        secondary PEs, results are reported in the usual order\n"
+         "-timeout Fail a test whose payload runs longer than <ms> milliseconds\n"
+         "        and continue with the next test\n"
   );
 }
 
@@ -274,6 +406,13 @@ STATIC CONST SHELL_PARAM_ITEM ParamList[] = {
   {L"-hyp", TypeFlag},   // -hyp  # Binary Flag to enable the execution of hypervisor tests.
   {L"-ps", TypeFlag},    // -ps   # Binary Flag to enable the execution of platform security tests.
   {L"-dtb", TypeValue},  // -dtb  # Binary Flag to enable dtb dump
+  {L"-perf", TypeFlag},  // -perf # Binary Flag to enable performance benchmarks
+  {L"-profile", TypeFlag},// -profile # Binary Flag to enable PMU profiling of tests
+  {L"-cfgshadow", TypeFlag},// -cfgshadow # Binary Flag to enable the config space shadow
+  {L"-cache", TypeValue},// -cache # Platform snapshot file
+  {L"-traffic", TypeValue},// -traffic # Concurrent exerciser traffic duration in ms
+  {L"-concurrent", TypeFlag},// -concurrent # Binary Flag to run independent tests in parallel
+  {L"-timeout", TypeValue},// -timeout # Per test timeout in ms
   {NULL, TypeMax}
   };
 
@@ -295,6 +434,7 @@ ShellAppMain (
 
   LIST_ENTRY         *ParamPackage;
   CONST CHAR16       *CmdLineArg;
+  CONST CHAR16       *SnapshotFile;
   CHAR16             *ProbParam;
   UINT32             Status;
   UINT32             i,j=0;
@@ -386,6 +526,28 @@ ShellAppMain (
   }
 
   // Options with Flags
+  g_perf_mode = ShellCommandLineGetFlag (ParamPackage, L"-perf") ? 1 : 0;
+  g_profile_mode = ShellCommandLineGetFlag (ParamPackage, L"-profile") ? 1 : 0;
+  g_concurrent_mode = ShellCommandLineGetFlag (ParamPackage, L"-concurrent") ? 1 : 0;
+
+  // Options with Values
+  CmdLineArg  = ShellCommandLineGetValue (ParamPackage, L"-traffic");
+  if (CmdLineArg == NULL) {
+    g_traffic_duration_ms = 0;
+  } else {
+    g_traffic_duration_ms = StrDecimalToUintn(CmdLineArg);
+  }
+
+  CmdLineArg  = ShellCommandLineGetValue (ParamPackage, L"-timeout");
+  if (CmdLineArg == NULL) {
+    g_test_timeout_ms = 0;
+  } else {
+    g_test_timeout_ms = StrDecimalToUintn(CmdLineArg);
+  }
+
+  // Options with Values
+  SnapshotFile = ShellCommandLineGetValue (ParamPackage, L"-cache");
+
   if ((ShellCommandLineGetFlag (ParamPackage, L"-help")) || (ShellCommandLineGetFlag (ParamPackage, L"-h"))){
      HelpMsg();
      return 0;
@@ -405,13 +567,18 @@ ShellAppMain (
 
 
   Print(L" Creating Platform Information Tables \n");
+  if (SnapshotFile != NULL)
+    loadPlatformSnapshot(SnapshotFile);
+
   Status = createPeInfoTable();
   if (Status)
     return Status;
 
   Status = createGicInfoTable();
-  if (Status)
+  if (Status) {
+    val_pe_free_info_table();
     return Status;
+  }
 
   /* Initialise exception vector, so any unexpected exception gets handled by default
      BSA exception handler */
@@ -424,6 +591,12 @@ ShellAppMain (
   createPcieVirtInfoTable();
   createPeripheralInfoTable();
 
+  if (ShellCommandLineGetFlag (ParamPackage, L"-cfgshadow"))
+    val_pcie_shadow_enable(1);
+
+  if (SnapshotFile != NULL)
+    savePlatformSnapshot(SnapshotFile);
+
   val_allocate_shared_mem();
 
   FlushImage();
@@ -464,6 +637,11 @@ ShellAppMain (
   Print(L"\n      *** Starting PCIe Exerciser tests ***  ");
   Status |= val_exerciser_execute_tests(g_sw_view);
 
+  if (g_perf_mode) {
+    Print(L"\n      *** Starting Interrupt latency benchmarks ***  ");
+    Status |= val_gic_execute_perf_tests(val_pe_get_num());
+  }
+
 print_test_status:
   val_print(ACS_PRINT_TEST, "\n     ------------------------------------------------------- \n", 0);
   val_print(ACS_PRINT_TEST, "     Total Tests run  = %4d", g_bsa_tests_total);
@@ -471,6 +649,7 @@ print_test_status:
   val_print(ACS_PRINT_TEST, "  Tests Failed = %4d\n", g_bsa_tests_fail);
   val_print(ACS_PRINT_TEST, "     ------------------------------------------------------- \n", 0);
 
+  val_pcie_shadow_report();
   freeBsaAcsMem();
 
   if (g_bsa_log_file_handle) {
@@ -26,6 +26,11 @@
 
 extern uint32_t g_print_level;
 extern uint32_t g_execute_secure;
+extern uint32_t g_perf_mode;
+extern uint32_t g_profile_mode;
+extern uint32_t g_concurrent_mode;
+extern uint32_t g_traffic_duration_ms;
+extern uint32_t g_test_timeout_ms;
 extern uint32_t g_skip_test_num[MAX_TEST_SKIP_NUM];
 extern uint32_t g_bsa_tests_total;
 extern uint32_t g_bsa_tests_pass;
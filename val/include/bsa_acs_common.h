@@ -125,7 +125,34 @@ val_check_for_error(uint32_t test_num, uint32_t num_pe, char8_t *ruleid);
 void
 val_run_test_payload(uint32_t test_num, uint32_t num_pe, void (*payload)(void), uint64_t test_input);
 
+void
+val_wait_for_test_completion(uint32_t test_num, uint32_t num_pe, uint32_t timeout);
+
+typedef enum {
+  SCHED_MODE_OFF = 0,
+  SCHED_MODE_DISPATCH,
+  SCHED_MODE_REPORT
+} SCHED_MODE_e;
+
+uint32_t
+val_test_sched_mode(void);
+
+uint32_t
+val_test_sched_capture(char8_t *string, uint64_t data);
+
+uint32_t
+val_test_sched_payload_hook(uint32_t test_num, uint32_t num_pe, void (*payload)(void));
+
+void
+val_test_watchdog_run(uint32_t test_num, void (*payload)(void));
+
 void
 val_data_cache_ops_by_va(addr_t addr, uint32_t type);
 
+void
+val_data_cache_ops_by_range(addr_t addr, uint64_t len, uint32_t type);
+
+void
+val_data_cache_ops_by_set_way(uint32_t type);
+
 #endif
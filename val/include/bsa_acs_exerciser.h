@@ -18,6 +18,7 @@
 #ifndef __BSA_ACS_EXERCISER_H__
 #define __BSA_ACS_EXERCISER_H__
 
+#include "bsa_acs_memory.h"
 
 #define MAX_EXERCISER_CARDS 20
 #define BUS_MEM_EN_MASK 0x06
@@ -28,6 +29,7 @@
 typedef struct {
     uint32_t bdf;
     uint32_t initialized;
+    EXERCISER_CONTEXT ctx;
 } EXERCISER_INFO_BLOCK;
 
 typedef struct {
@@ -39,6 +41,28 @@ typedef enum {
     EXERCISER_NUM_CARDS = 0x1
 } EXERCISER_INFO_TYPE;
 
+/* Written by a PE to its shared data slot once it waits at the traffic start barrier */
+#define TRAFFIC_PE_READY 0x7EADF00Dull
+
+typedef enum {
+    TRAFFIC_DMA_TO_DEVICE = 0,  ///< Exerciser reads the target
+    TRAFFIC_DMA_FROM_DEVICE,    ///< Exerciser writes the target
+    TRAFFIC_DMA_LOOPBACK        ///< Alternate reads and writes
+} EXERCISER_TRAFFIC_TYPE;
+
+typedef struct {
+    uint32_t instance;          ///< Exerciser issuing the stream
+    uint32_t type;              ///< EXERCISER_TRAFFIC_TYPE
+    uint64_t addr;              ///< Bus address of the target memory or peer BAR
+    uint32_t len;               ///< Bytes per DMA
+    uint32_t pe_index;          ///< PE driving the stream, set by the scheduler
+    uint64_t completions;       ///< DMAs completed
+    uint64_t errors;            ///< DMAs that reported a failure
+    uint64_t bytes;             ///< Bytes moved by the completed DMAs
+    uint64_t ticks;             ///< Counter ticks from the start to the last DMA
+    uint32_t completed;         ///< 1 once the stream stopped at the end time
+} exerciser_traffic_t;
+
 
 void val_exerciser_create_info_table(void);
 uint32_t val_exerciser_init(uint32_t instance);
@@ -51,6 +75,13 @@ uint32_t val_exerciser_ops(EXERCISER_OPS ops, uint64_t param, uint32_t instance)
 uint32_t val_exerciser_get_data(EXERCISER_DATA_TYPE type, exerciser_data_t *data, uint32_t instance);
 uint32_t val_exerciser_execute_tests(uint32_t *g_sw_view);
 uint32_t val_exerciser_get_bdf(uint32_t instance);
+uint32_t val_exerciser_traffic_run(uint32_t test_num, exerciser_traffic_t *streams,
+                                   uint32_t num_streams, uint32_t duration_ms);
+void val_exerciser_traffic_report(uint32_t level, exerciser_traffic_t *streams,
+                                  uint32_t num_streams);
+uint32_t val_exerciser_dma_pattern(uint32_t instance, void *src_virt, void *src_phys,
+                                   void *dst_virt, void *dst_phys, uint32_t len,
+                                   mem_pattern_t *pattern, mem_compare_info_t *info);
 
 uint32_t os_e001_entry(void);
 uint32_t os_e002_entry(void);
@@ -67,5 +98,8 @@ uint32_t os_e012_entry(void);
 uint32_t os_e013_entry(void);
 uint32_t os_e014_entry(void);
 uint32_t os_e015_entry(void);
+uint32_t os_e016_entry(void);
+uint32_t os_e017_entry(void);
+uint32_t os_e018_entry(void);
 
 #endif
@@ -57,6 +57,15 @@
 
 #define GITS_TRANSLATER     0x10040
 
+#define GICD_SGIR                 0xF00
+#define GICD_SGIR_TARGET_SELF     (0x2 << 24)
+
+#define ICC_SGI1R_AFF1_SHIFT      16
+#define ICC_SGI1R_INTID_SHIFT     24
+#define ICC_SGI1R_AFF2_SHIFT      32
+#define ICC_SGI1R_RS_SHIFT        44
+#define ICC_SGI1R_AFF3_SHIFT      48
+
 #define GICD_ICFGR_INTR_STRIDE          16 /* (32/2) Interrupt per Register */
 #define GICD_ICFGR_INTR_CONFIG1(intid)  ((1+int_id*2) % 32) /* Bit Config[2x+1] for config type level/edge */
 
@@ -94,6 +103,8 @@ os_g005_entry(uint32_t num_pe);
 uint32_t
 os_g006_entry(uint32_t num_pe);
 uint32_t
+os_g007_entry(uint32_t num_pe);
+uint32_t
 hyp_g001_entry(uint32_t num_pe);
 
 uint32_t
@@ -25,7 +25,8 @@ typedef enum {
   ICH_MISR_EL2,
   ICC_IGRPEN1_EL1,
   ICC_BPR1_EL1,
-  ICC_PMR_EL1
+  ICC_PMR_EL1,
+  ICC_SGI1R_EL1
 }BSA_ACS_GIC_REGS;
 
 uint64_t val_gic_reg_read(uint32_t reg_id);
@@ -38,6 +39,7 @@ void GicWriteIchHcr(uint64_t write_data);
 void GicWriteIccIgrpen1(uint64_t write_data);
 void GicWriteIccBpr1(uint64_t write_data);
 void GicWriteIccPmr(uint64_t write_data);
+void GicWriteIccSgi1r(uint64_t write_data);
 void GicClearDaif(void);
 void TestExecuteBarrier(void);
 void GicWriteHcr(uint64_t write_data);
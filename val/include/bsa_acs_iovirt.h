@@ -18,11 +18,20 @@
 #ifndef __BSA_ACS_IOVIRT_H__
 #define __BSA_ACS_IOVIRT_H__
 
+typedef struct {
+  uint32_t status;     ///< 0 if the function was resolved
+  uint32_t device_id;
+  uint32_t stream_id;
+  uint32_t its_id;
+} iovirt_device_info_t;
+
 uint64_t val_iovirt_get_smmu_info(SMMU_INFO_e type, uint32_t index);
 uint32_t val_iovirt_check_unique_ctx_intid(uint32_t smmu_index);
 uint32_t val_iovirt_unique_rid_strid_map(uint32_t rc_index);
 int val_iovirt_get_device_info(
   uint32_t rid, uint32_t segment, uint32_t *device_id, uint32_t *stream_id, uint32_t *its_id);
+uint32_t val_iovirt_get_bdf_table_device_info(iovirt_device_info_t *info, uint32_t num_entries);
+uint32_t val_iovirt_get_smmu_sid_range(uint32_t smmu_index, uint32_t *max_sid);
 uint64_t val_iovirt_get_pcie_rc_info(PCIE_RC_INFO_e type, uint32_t index);
 int val_iovirt_get_its_info(
   uint32_t type, uint32_t group_index, uint32_t param, uint32_t *return_value);
@@ -24,8 +24,33 @@ void val_memory_unmap(void *ptr);
 void *val_memory_alloc(uint32_t size);
 void *val_memory_alloc_cacheable(uint32_t bdf, uint32_t size, void **pa);
 void val_memory_free(void *addr);
+typedef struct {
+  uint64_t offset;      ///< Byte offset of the first difference
+  uint64_t expected;    ///< Aligned 64-bit word of the source holding it
+  uint64_t actual;      ///< Same word of the destination
+} mem_compare_info_t;
+
+typedef enum {
+  MEM_PATTERN_ADDRESS = 0,   ///< Each 64-bit word holds its bus address
+  MEM_PATTERN_WALKING_ONES,  ///< A single set bit walking through the words
+  MEM_PATTERN_LFSR,          ///< Pseudo random sequence from the seed
+  MEM_PATTERN_LINE_TAG       ///< Seed and bus line number tag of each 64-byte line
+} MEM_PATTERN_e;
+
+typedef struct {
+  MEM_PATTERN_e type;
+  uint64_t      seed;        ///< Distinguishes transfers of the same buffer
+  uint64_t      base;        ///< Bus address the buffer is transferred from
+} mem_pattern_t;
+
 int val_memory_compare(void *src, void *dest, uint32_t len);
+uint32_t val_memory_compare_info(void *src, void *dest, uint64_t len, mem_compare_info_t *info);
+void val_memory_print_mismatch(uint32_t level, mem_compare_info_t *info);
 void val_memory_set(void *buf, uint32_t size, uint8_t value);
+void *val_memory_copy(void *dest, void *src, uint32_t len);
+void val_memory_pattern_fill(void *buf, uint64_t len, mem_pattern_t *pattern);
+uint32_t val_memory_pattern_verify(void *buf, uint64_t len, mem_pattern_t *pattern,
+                                   mem_compare_info_t *info);
 void val_memory_free_cacheable(uint32_t bdf, uint32_t size, void *va, void *pa);
 void *val_memory_virt_to_phys(void *va);
 void *val_memory_phys_to_virt(uint64_t pa);
@@ -35,6 +60,10 @@ void val_memory_free_pages(void *page_base, uint32_t num_pages);
 addr_t val_memory_get_addr(MEMORY_INFO_e mem_type, uint32_t instance, uint64_t *attr);
 void *val_aligned_alloc(uint32_t alignment, uint32_t size);
 
+void MemCopySimd(void *dest, void *src, uint64_t len);
+void MemSetSimd(void *buf, uint64_t len, uint8_t value);
+uint64_t MemCompareSimd(void *src, void *dest, uint64_t len);
+
 uint32_t os_m001_entry(uint32_t num_pe);
 uint32_t os_m002_entry(uint32_t num_pe);
 uint32_t os_m003_entry(uint32_t num_pe);
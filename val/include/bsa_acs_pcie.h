@@ -146,6 +146,7 @@ typedef struct {
 void     val_pcie_write_cfg(uint32_t bdf, uint32_t offset, uint32_t data);
 void     val_pcie_io_write_cfg(uint32_t bdf, uint32_t offset, uint32_t data);
 uint32_t val_pcie_read_cfg(uint32_t bdf, uint32_t offset, uint32_t *data);
+uint32_t val_pcie_read_cfg_ro(uint32_t bdf, uint32_t offset, uint32_t *data);
 uint32_t val_get_msi_vectors (uint32_t bdf, PERIPHERAL_VECTOR_LIST **mvector);
 uint64_t val_pcie_get_bdf_config_addr(uint32_t bdf);
 
@@ -192,6 +193,9 @@ val_pcie_get_rp_transaction_frwd_support(uint32_t bdf);
 uint32_t
 val_pcie_get_atomicop_requester_capable(uint32_t bdf);
 
+uint32_t
+val_pcie_get_msix_table_size(uint32_t bdf);
+
 uint32_t
 val_pcie_is_cache_present(uint32_t bdf);
 
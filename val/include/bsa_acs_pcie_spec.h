@@ -198,7 +198,8 @@
 #define DCTLR_OFFSET   8
 #define LCAPR_OFFSET   0xC
 #define LCTLR_OFFSET   0x10
-#define DCAP2R_OFFSET  24
+#define SCAPR_OFFSET   0x14
+#define DCAP2R_OFFSET  0x24
 #define DCTL2R_OFFSET  28
 #define LCAP2R_OFFSET  0x2C
 #define LCTL2R_OFFSET  0x30
@@ -301,6 +302,8 @@
 
 /* MSI-X Capabilities */
 #define MSI_X_ENABLE_SHIFT          31
+#define MSI_X_TABLE_SIZE_SHIFT      16
+#define MSI_X_TABLE_SIZE_MASK       0x7FF
 
 #define MSI_X_TOR_OFFSET            0x4
 
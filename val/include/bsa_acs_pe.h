@@ -20,6 +20,11 @@
 
 #define MPIDR_AFF_MASK           (0xFF00FFFFFF)
 
+/* PE index cached in TPIDR_EL1, tagged so a reset value is not taken as an index */
+#define PE_INDEX_CACHE_TAG       (0xB5A0ull << 48)
+#define PE_INDEX_CACHE_TAG_MASK  (0xFFFFull << 48)
+#define PE_INDEX_CACHE_MASK      0xFFFFFFFF
+
 //
 //  AARCH64 processor exception types.
 //
@@ -149,6 +154,77 @@ typedef enum {
   DBGBCR15_EL1
 } BSA_ACS_PE_REGS;
 
+/* ID registers captured by val_pe_id_regs_snapshot. PeIdRegSnapshot stores
+   the registers up to PE_ID_CLIDR in this order, the optional feature
+   registers after it are read only when the feature is implemented. */
+typedef enum {
+  PE_ID_AA64PFR0 = 0,
+  PE_ID_AA64PFR1,
+  PE_ID_AA64DFR0,
+  PE_ID_AA64DFR1,
+  PE_ID_AA64MMFR0,
+  PE_ID_AA64MMFR1,
+  PE_ID_CTR,
+  PE_ID_AA64ISAR0,
+  PE_ID_AA64ISAR1,
+  PE_ID_MPIDR,
+  PE_ID_MIDR,
+  PE_ID_DFR0,
+  PE_ID_ISAR0,
+  PE_ID_ISAR1,
+  PE_ID_ISAR2,
+  PE_ID_ISAR3,
+  PE_ID_ISAR4,
+  PE_ID_ISAR5,
+  PE_ID_MMFR0,
+  PE_ID_MMFR1,
+  PE_ID_MMFR2,
+  PE_ID_MMFR3,
+  PE_ID_MMFR4,
+  PE_ID_PFR0,
+  PE_ID_PFR1,
+  PE_ID_MVFR0,
+  PE_ID_MVFR1,
+  PE_ID_MVFR2,
+  PE_ID_PMCEID0,
+  PE_ID_PMCEID1,
+  PE_ID_PMCR,
+  PE_ID_CLIDR,
+  PE_ID_PMBIDR,
+  PE_ID_PMSIDR,
+  PE_ID_ERRIDR,
+  PE_ID_ERR0FR,
+  PE_ID_ERR1FR,
+  PE_ID_ERR2FR,
+  PE_ID_ERR3FR,
+  PE_ID_LORID,
+  PE_ID_REG_NUM
+} PE_ID_REG_e;
+
+#define PE_MAX_CACHE_LEVEL  7
+
+typedef struct {
+  uint64_t reg[PE_ID_REG_NUM];          ///< Indexed by PE_ID_REG_e
+  uint64_t ccsidr[PE_MAX_CACHE_LEVEL];  ///< CCSIDR of each implemented cache level, else 0
+  uint64_t valid;                       ///< PE_ID_REGS_VALID once captured
+} pe_id_regs_t;
+
+#define PE_ID_REGS_VALID    0x5045494452454753ull
+
+/* Size of one PE's entry in an array of snapshots, a whole number of
+   cache lines so PEs writing their own entry do not share lines */
+#define PE_ID_REGS_STRIDE   ((sizeof(pe_id_regs_t) + 63) & ~63ull)
+#define PE_ID_REGS_ENTRY(base, index) \
+        ((pe_id_regs_t *)((uint8_t *)(base) + ((index) * PE_ID_REGS_STRIDE)))
+
+void PeIdRegSnapshot(uint64_t *regs);
+void val_pe_id_regs_snapshot(pe_id_regs_t *regs);
+uint32_t val_pe_feat_db_create(void);
+void val_pe_feat_db_free(void);
+pe_id_regs_t *val_pe_feat_db_get(uint32_t index);
+uint64_t val_pe_feat_reg(uint32_t index, uint32_t reg_id);
+void val_pe_run_feat_payload(uint32_t test_num, uint32_t num_pe, void (*payload)(uint32_t index));
+
 uint64_t ArmReadMpidr(void);
 
 uint64_t ArmReadIdPfr0(void);
@@ -187,6 +263,10 @@ uint64_t AA64ReadMdcr2(void);
 
 void AA64WriteMdcr2(uint64_t write_data);
 
+uint64_t AA64ReadTpidr1(void);
+
+void AA64WriteTpidr1(uint64_t write_data);
+
 uint64_t AA64ReadVbar2(void);
 
 void AA64WriteVbar2(uint64_t write_data);
@@ -201,6 +281,18 @@ void AA64WritePmintenset(uint64_t write_data);
 
 void AA64WritePmintenclr(uint64_t write_data);
 
+void AA64WritePmselr(uint64_t write_data);
+
+void AA64WritePmxevtyper(uint64_t write_data);
+
+void AA64WritePmccfiltr(uint64_t write_data);
+
+void AA64WritePmcntenset(uint64_t write_data);
+
+void AA64WritePmcntenclr(uint64_t write_data);
+
+void PmuReadCounters(uint64_t *regs, uint32_t num);
+
 uint64_t AA64ReadCcsidr(void);
 
 uint64_t AA64ReadCsselr(void);
@@ -339,10 +431,16 @@ uint64_t AA64ReadDbgbcr15El1(void);
 
 void ArmCallWFI(void);
 
+void PeWaitForInterrupt(volatile uint32_t *busy);
+
 void SpeProgramUnderProfiling(uint64_t interval, uint64_t address);
 
 void DisableSpe(void);
 
+uint32_t PeSaveRecoveryPoint(uint64_t *regs) __attribute__((returns_twice));
+
+void PeResumeRecoveryPoint(void);
+
 void val_pe_update_elr(void *context, uint64_t offset);
 
 uint64_t val_pe_get_esr(void *context);
@@ -354,6 +452,8 @@ void val_pe_spe_program_under_profiling(uint64_t interval, addr_t address);
 void val_pe_spe_disable(void);
 
 void val_pe_context_save(uint64_t sp, uint64_t elr);
+uint64_t val_pe_get_index_hash(void);
+uint32_t val_pe_get_index_hash_mask(void);
 void val_pe_initialize_default_exception_handler(void (*esr)(uint64_t, void *));
 void val_pe_context_restore(uint64_t sp);
 void val_pe_default_esr(uint64_t interrupt_type, void *context);
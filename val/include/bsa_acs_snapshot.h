@@ -0,0 +1,42 @@
+/** @file
+ * Copyright (c) 2021 Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+#ifndef __BSA_ACS_SNAPSHOT_H__
+#define __BSA_ACS_SNAPSHOT_H__
+
+/* "BSASNAPS" in little endian byte order */
+#define SNAPSHOT_MAGIC    0x5350414E53415342ULL
+
+/* Bump when the snapshot layout or the meaning of any info table field changes */
+#define SNAPSHOT_VERSION  3
+
+typedef struct {
+  uint32_t offset;          ///< Offset of the record from the start of the snapshot
+  uint32_t size;            ///< Size of the record, 0 if the table was not captured
+} snapshot_record_t;
+
+typedef struct {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t layout;          ///< Hash of the info table entry sizes of the writer
+  uint64_t platform_hash;   ///< Hash of the ACPI tables or DT blob the tables came from
+  uint32_t total_size;
+  uint32_t num_records;
+  snapshot_record_t record[SNAPSHOT_NUM_RECORDS];
+} snapshot_header_t;
+
+#endif
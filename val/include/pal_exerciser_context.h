@@ -0,0 +1,48 @@
+/** @file
+ * Copyright (c) 2021 Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+#ifndef __PAL_EXERCISER_CONTEXT_H__
+#define __PAL_EXERCISER_CONTEXT_H__
+
+/* The UEFI PALs only know the UEFI base types, the Linux VAL only the fixed
+   width ones */
+#ifdef TARGET_LINUX
+#define EXERCISER_CTX_UINT32  uint32_t
+#define EXERCISER_CTX_UINT64  uint64_t
+#else
+#define EXERCISER_CTX_UINT32  UINT32
+#define EXERCISER_CTX_UINT64  UINT64
+#endif
+
+/**
+  @brief Per-instance exerciser context, filled once by pal_exerciser_create_context
+         and used by every later exerciser operation. Shared by the VAL and the
+         UEFI PALs.
+**/
+typedef struct exerciser_context {
+    EXERCISER_CTX_UINT32 bdf;
+    EXERCISER_CTX_UINT64 ecam;          ///< ECAM base of the exerciser segment
+    EXERCISER_CTX_UINT64 cfg_va;        ///< Config space address of the exerciser function
+    EXERCISER_CTX_UINT64 bar0_base;     ///< Exerciser register frame
+    EXERCISER_CTX_UINT32 pasid_cap;     ///< PASID extended capability offset, 0 if absent
+    EXERCISER_CTX_UINT64 dma_ctl;       ///< DMA control register 1 address
+    EXERCISER_CTX_UINT64 dma_bus_addr;  ///< DMA bus address register address
+    EXERCISER_CTX_UINT64 dma_len;       ///< DMA length register address
+    EXERCISER_CTX_UINT64 dma_status;    ///< DMA status register address
+} EXERCISER_CONTEXT;
+
+#endif
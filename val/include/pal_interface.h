@@ -50,6 +50,7 @@
 #define PCIE_UNKNOWN_RESPONSE   0xFFFFFFFF  /* Function not found or UR response from completer */
 
 void pal_dump_dtb(void);
+uint64_t pal_get_platform_hash(void);
 
 /**  PE Test related Definitions **/
 
@@ -463,6 +464,7 @@ typedef struct {
   uint32_t         baud_rate;
   uint32_t         interface_type;
   uint32_t         platform_type;
+  uint32_t         access_width;  ///< GAS access size of the registers, 0 if not known
 }PERIPHERAL_INFO_BLOCK;
 
 #define PLATFORM_TYPE_ACPI   0x0
@@ -597,6 +599,8 @@ uint64_t pal_memory_get_unpopulated_addr(uint64_t *addr, uint32_t instance);
 /* Common Definitions */
 void     pal_print(char8_t *string, uint64_t data);
 void     pal_print_raw(uint64_t addr, char8_t *string, uint64_t data);
+void     pal_uart_print_raw(uint64_t addr, uint32_t uart_type, uint32_t access_width,
+                            char8_t *string, uint64_t data);
 uint32_t pal_strncmp(char8_t *str1, char8_t *str2, uint32_t len);
 void    *pal_memcpy(void *dest_buffer, void *src_buffer, uint32_t len);
 void    *pal_mem_alloc(uint32_t size);
@@ -633,11 +637,17 @@ void     pal_pe_update_elr(void *context, uint64_t offset);
 uint64_t pal_pe_get_esr(void *context);
 uint64_t pal_pe_get_far(void *context);
 void     pal_pe_data_cache_ops_by_va(uint64_t addr, uint32_t type);
+void     pal_pe_data_cache_ops_by_range(uint64_t addr, uint64_t len, uint32_t type);
+void     pal_pe_data_cache_ops_by_set_way(uint32_t type);
+uint32_t pal_pe_secondary_stack_overflow(uint32_t index);
 
 #define CLEAN_AND_INVALIDATE  0x1
 #define CLEAN                 0x2
 #define INVALIDATE            0x3
 
+/* Conservative line stride when the PAL only maintains one line per call */
+#define CACHE_LINE_MIN_SIZE   16
+
 /* Exerciser definitions */
 #define MAX_ARRAY_SIZE 32
 #define TEST_REG_COUNT 10
@@ -761,18 +771,20 @@ typedef enum {
     EXERCISER_DATA_BAR0_SPACE = 0x2,
 } EXERCISER_DATA_TYPE;
 
+#include "pal_exerciser_context.h"
+
 uint32_t pal_is_bdf_exerciser(uint32_t bdf);
+uint32_t pal_exerciser_create_context(uint32_t bdf, uint64_t ecam, EXERCISER_CONTEXT *ctx);
 uint32_t pal_exerciser_set_param(EXERCISER_PARAM_TYPE type, uint64_t value1,
-                                 uint64_t value2, uint32_t bdf, uint64_t ecam);
+                                 uint64_t value2, EXERCISER_CONTEXT *ctx);
 uint32_t pal_exerciser_get_param(EXERCISER_PARAM_TYPE type, uint64_t *value1,
-                                uint64_t *value2, uint32_t bdf, uint64_t ecam);
+                                uint64_t *value2, EXERCISER_CONTEXT *ctx);
 uint32_t pal_exerciser_set_state(EXERCISER_STATE state, uint64_t *value,
                                                                  uint32_t bdf);
 uint32_t pal_exerciser_get_state(EXERCISER_STATE *state, uint32_t bdf);
-uint32_t pal_exerciser_ops(EXERCISER_OPS ops, uint64_t param,
-                                             uint32_t instance, uint64_t ecam);
+uint32_t pal_exerciser_ops(EXERCISER_OPS ops, uint64_t param, EXERCISER_CONTEXT *ctx);
 uint32_t pal_exerciser_get_data(EXERCISER_DATA_TYPE type,
-                          exerciser_data_t *data, uint32_t bdf, uint64_t ecam);
+                          exerciser_data_t *data, EXERCISER_CONTEXT *ctx);
 
 #endif
 
@@ -50,6 +50,49 @@ void    *val_memcpy(void *dest_buffer, void *src_buffer, uint32_t len);
 void val_dump_dtb(void);
 uint64_t val_time_delay_ms(uint64_t time_ms);
 
+typedef struct {
+  uint64_t min;
+  uint64_t median;
+  uint64_t p99;
+  uint64_t max;
+  uint64_t total;
+} perf_stats_t;
+
+void val_perf_get_stats(uint64_t *samples, uint32_t count, perf_stats_t *stats);
+
+/* PMU profiling of tests and VAL hot paths */
+typedef enum {
+  PROFILE_REGION_CFG_READ = 0,
+  PROFILE_REGION_CACHE_OP,
+  PROFILE_REGION_ITS_CMD,
+  PROFILE_REGION_SMMU_CMD,
+  PROFILE_NUM_REGIONS
+} PROFILE_REGION_e;
+
+void val_profile_start(uint32_t test_num);
+void val_profile_stop(uint32_t test_num);
+void val_profile_region_enter(PROFILE_REGION_e region);
+void val_profile_region_exit(PROFILE_REGION_e region);
+
+/* Concurrent execution of single PE tests. A test may run alongside another
+   one unless either of them owns hardware the other uses or owns. */
+#define TEST_RES_PCIE     (1 << 0)
+#define TEST_RES_GIC      (1 << 1)
+#define TEST_RES_TIMER    (1 << 2)
+#define TEST_RES_SMMU     (1 << 3)
+#define TEST_RES_UART     (1 << 4)
+#define TEST_RES_WD       (1 << 5)
+#define TEST_RES_MEMORY   (1 << 6)
+#define TEST_RES_PRIMARY  (1U << 31)  ///< Needs UEFI services or exceptions, runs on the primary PE
+
+typedef struct {
+  uint32_t (*entry)(uint32_t num_pe); ///< Only the payload may touch hardware
+  uint32_t uses;                      ///< Hardware the test only reads
+  uint32_t owns;                      ///< Hardware the test changes
+} val_sched_test_t;
+
+uint32_t val_test_sched_run(val_sched_test_t *tests, uint32_t num_tests, uint32_t num_pe);
+
 /* VAL PE APIs */
 uint32_t val_pe_execute_tests(uint32_t num_pe, uint32_t *g_sw_view);
 uint32_t val_pe_create_info_table(uint64_t *pe_info_table);
@@ -60,6 +103,9 @@ uint32_t val_pe_get_pmu_gsiv(uint32_t index);
 uint32_t val_pe_get_gmain_gsiv(uint32_t index);
 uint64_t val_pe_get_mpid(void);
 uint32_t val_pe_get_index_mpid(uint64_t mpid);
+uint32_t val_pe_get_index(void);
+void     val_pe_set_lost(uint32_t index);
+uint32_t val_pe_is_lost(uint32_t index);
 uint32_t val_pe_install_esr(uint32_t exception_type, void (*esr)(uint64_t, void *));
 
 void     val_execute_on_pe(uint32_t index, void (*payload)(void), uint64_t args);
@@ -87,6 +133,7 @@ uint32_t
 val_gic_get_info(GIC_INFO_e type);
 void     val_gic_free_info_table(void);
 uint32_t val_gic_execute_tests(uint32_t num_pe, uint32_t *g_sw_view);
+uint32_t val_gic_execute_perf_tests(uint32_t num_pe);
 uint32_t val_gic_install_isr(uint32_t int_id, void (*isr)(void));
 uint32_t val_gic_end_of_interrupt(uint32_t int_id);
 uint32_t val_gic_route_interrupt_to_pe(uint32_t int_id, uint64_t mpidr);
@@ -105,6 +152,14 @@ uint32_t val_gic_request_msi(uint32_t bdf, uint32_t device_id, uint32_t its_id,
                              uint32_t int_id, uint32_t msi_index);
 void val_gic_free_msi(uint32_t bdf, uint32_t device_id, uint32_t its_id,
                       uint32_t int_id, uint32_t msi_index);
+uint32_t val_gic_request_msi_range(uint32_t bdf, uint32_t device_id, uint32_t its_id,
+                                   uint32_t int_id_base, uint32_t num_msi);
+void val_gic_free_msi_range(uint32_t bdf, uint32_t device_id, uint32_t its_id,
+                            uint32_t int_id_base, uint32_t num_msi);
+uint32_t val_gic_generate_sgi(uint32_t int_id, uint64_t mpidr);
+void     val_gic_poll_enable(uint32_t int_id);
+uint32_t val_gic_poll_acknowledge(void);
+void     val_gic_poll_end_of_interrupt(uint32_t int_id);
 
 /* GICv2m APIs */
 typedef enum {
@@ -144,6 +199,7 @@ void     val_timer_create_info_table(uint64_t *timer_info_table);
 void     val_timer_free_info_table(void);
 uint32_t val_timer_execute_tests(uint32_t num_pe, uint32_t *g_sw_view);
 uint64_t val_timer_get_info(TIMER_INFO_e info_type, uint64_t instance);
+uint64_t val_timer_get_counter(void);
 void     val_timer_set_phy_el1(uint64_t timeout);
 void     val_timer_set_vir_el1(uint64_t timeout);
 void     val_timer_set_phy_el2(uint64_t timeout);
@@ -155,6 +211,22 @@ void val_platform_timer_get_entry_index(uint64_t instance, uint32_t *block, uint
 uint64_t val_get_phy_el2_timer_count(void);
 uint64_t val_get_phy_el1_timer_count(void);
 
+/* Interrupt wait APIs, for tests of interrupt sources */
+#define INTR_WAIT_ERR     0xFFFFFFFF
+
+typedef enum {
+  INTR_WAIT_TAKEN = 0,
+  INTR_WAIT_EARLY,          ///< Taken before the programmed expiry
+  INTR_WAIT_MISSED
+} INTR_WAIT_RESULT_e;
+
+void     val_intr_wait_init(void);
+uint32_t val_intr_wait_add(uint32_t intid, void (*stop)(uint64_t arg), uint64_t arg);
+void     val_intr_wait_armed(uint32_t slot, uint64_t expiry);
+uint32_t val_intr_wait(uint64_t margin);
+void     val_intr_wait_cancel(void);
+uint32_t val_intr_wait_result(uint32_t slot, uint64_t *latency_ns);
+
 /* Watchdog VAL APIs */
 typedef enum {
   WD_INFO_COUNT = 1,
@@ -179,6 +251,13 @@ uint32_t val_pcie_create_device_bdf_table(void);
 addr_t val_pcie_get_ecam_base(uint32_t rp_bdf);
 void *val_pcie_bdf_table_ptr(void);
 void     val_pcie_free_info_table(void);
+
+#define PCIE_SHADOW_ALL  0xFFFFFFFF
+void     val_pcie_shadow_enable(uint32_t enable);
+void     val_pcie_shadow_invalidate(uint32_t bdf);
+uint32_t val_pcie_shadow_suspend(void);
+void     val_pcie_shadow_resume(uint32_t enabled);
+void     val_pcie_shadow_report(void);
 uint32_t val_pcie_execute_tests(uint32_t num_pe, uint32_t *g_sw_view);
 uint32_t val_pcie_is_devicedma_64bit(uint32_t bdf);
 uint32_t val_pcie_scan_bridge_devices_and_check_memtype(uint32_t bdf);
@@ -321,6 +400,7 @@ typedef enum {
   UART_FLAGS,
   UART_BAUDRATE,
   UART_INTERFACE_TYPE,
+  UART_ACCESS_WIDTH,
   ANY_FLAGS,
   ANY_GSIV,
   ANY_BDF,
@@ -332,6 +412,8 @@ void     val_peripheral_free_info_table(void);
 uint32_t val_peripheral_execute_tests(uint32_t num_pe, uint32_t *g_sw_view);
 uint64_t val_peripheral_get_info(PERIPHERAL_INFO_e info_type, uint32_t index);
 uint32_t val_peripheral_is_pcie(uint32_t bdf);
+uint32_t val_peripheral_uart_type(uint64_t base);
+uint32_t val_peripheral_uart_access_width(uint64_t base);
 
 /* Memory Tests APIs */
 typedef enum {
@@ -361,4 +443,24 @@ uint64_t val_get_max_memory(void);
 
 /* PCIe Exerciser tests */
 uint32_t val_exerciser_execute_tests(uint32_t *g_sw_view);
+
+/* Platform information snapshot APIs */
+typedef enum {
+  SNAPSHOT_GIC_INFO = 0,
+  SNAPSHOT_TIMER_INFO,
+  SNAPSHOT_WD_INFO,
+  SNAPSHOT_IOVIRT_INFO,
+  SNAPSHOT_PERIPHERAL_INFO,
+  SNAPSHOT_PCIE_BDF,
+  SNAPSHOT_NUM_RECORDS
+}SNAPSHOT_RECORD_e;
+
+void     val_snapshot_register(SNAPSHOT_RECORD_e id, void *table, uint32_t size);
+uint32_t val_snapshot_restore(SNAPSHOT_RECORD_e id, void *table);
+void     val_snapshot_invalidate(SNAPSHOT_RECORD_e id);
+uint32_t val_snapshot_load(void *buffer, uint32_t size);
+void     val_snapshot_release(void);
+uint32_t val_snapshot_is_restored(void);
+uint32_t val_snapshot_get_size(void);
+uint32_t val_snapshot_save(void *buffer, uint32_t size);
 #endif
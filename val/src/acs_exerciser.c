@@ -19,6 +19,7 @@
 #include "include/bsa_acs_exerciser.h"
 #include "include/bsa_acs_pcie.h"
 #include "include/bsa_acs_smmu.h"
+#include "include/bsa_acs_memory.h"
 
 EXERCISER_INFO_TABLE g_exercier_info_table;
 /**
@@ -59,6 +60,7 @@ void val_exerciser_create_info_table(void)
       if (pal_is_bdf_exerciser(Bdf))
       {
           g_exercier_info_table.e_info[g_exercier_info_table.num_exerciser].bdf = Bdf;
+          g_exercier_info_table.e_info[g_exercier_info_table.num_exerciser].ctx.cfg_va = 0;
           g_exercier_info_table.e_info[g_exercier_info_table.num_exerciser++].initialized = 0;
           val_print(ACS_PRINT_INFO, "\n       exerciser Bdf %x", Bdf);
       }
@@ -84,6 +86,24 @@ uint32_t val_exerciser_get_info(EXERCISER_INFO_TYPE type, uint32_t instance)
     }
 }
 
+/**
+  @brief   This API returns the context cached for the PCIe stimulus generation hardware
+           by val_exerciser_init. The context is created here for an instance that is
+           accessed before it is initialized.
+  @param   instance     - Stimulus hardware instance number
+  @return  ctx          - Exerciser context of the instance
+**/
+static EXERCISER_CONTEXT *val_exerciser_get_context(uint32_t instance)
+{
+    EXERCISER_INFO_BLOCK *e_info = &g_exercier_info_table.e_info[instance];
+
+    if (e_info->ctx.cfg_va == 0)
+        pal_exerciser_create_context(e_info->bdf, val_pcie_get_ecam_base(e_info->bdf),
+                                     &e_info->ctx);
+
+    return &e_info->ctx;
+}
+
 /**
   @brief   This API writes the configuration parameters of the PCIe stimulus generation hardware
   @param   type         - Parameter type that needs to be set in the stimulus hadrware
@@ -95,10 +115,7 @@ uint32_t val_exerciser_get_info(EXERCISER_INFO_TYPE type, uint32_t instance)
 uint32_t val_exerciser_set_param(EXERCISER_PARAM_TYPE type, uint64_t value1,
                                            uint64_t value2, uint32_t instance)
 {
-    uint32_t bdf = g_exercier_info_table.e_info[instance].bdf;
-    uint64_t ecam = val_pcie_get_ecam_base(bdf);
-
-    return pal_exerciser_set_param(type, value1, value2, bdf, ecam);
+    return pal_exerciser_set_param(type, value1, value2, val_exerciser_get_context(instance));
 }
 
 /**
@@ -121,11 +138,7 @@ uint32_t val_exerciser_get_bdf(uint32_t instance)
 uint32_t val_exerciser_get_param(EXERCISER_PARAM_TYPE type, uint64_t *value1,
                                         uint64_t *value2, uint32_t instance)
 {
-    uint32_t bdf = g_exercier_info_table.e_info[instance].bdf;
-    uint64_t ecam = val_pcie_get_ecam_base(bdf);
-
-    return pal_exerciser_get_param(type, value1, value2, bdf, ecam);
-
+    return pal_exerciser_get_param(type, value1, value2, val_exerciser_get_context(instance));
 }
 
 /**
@@ -160,7 +173,7 @@ uint32_t val_exerciser_init(uint32_t instance)
 {
   uint32_t Bdf;
   uint64_t Ecam;
-  uint64_t cfg_addr;
+  EXERCISER_CONTEXT *ctx;
   EXERCISER_STATE state;
 
   if (!g_exercier_info_table.e_info[instance].initialized)
@@ -171,16 +184,19 @@ uint32_t val_exerciser_init(uint32_t instance)
           return 1;
       }
 
-      // setting command register for Memory Space Enable and Bus Master Enable
+      /* Cache config space address, BAR0, capability offsets and DMA registers
+       * so that later operations go straight to the exerciser registers
+       */
       Ecam = val_pcie_get_ecam_base(Bdf);
+      ctx = &g_exercier_info_table.e_info[instance].ctx;
+      if (pal_exerciser_create_context(Bdf, Ecam, ctx)) {
+          val_print(ACS_PRINT_ERR, "\n   Exerciser Bdf %lx context not created", Bdf);
+          return 1;
+      }
 
-      /* There are 8 functions / device, 32 devices / Bus and each has a 4KB config space */
-      cfg_addr = (PCIE_EXTRACT_BDF_BUS(Bdf) * PCIE_MAX_DEV * PCIE_MAX_FUNC * 4096) + \
-                 (PCIE_EXTRACT_BDF_DEV(Bdf) * PCIE_MAX_FUNC * 4096) + \
-                 (PCIE_EXTRACT_BDF_FUNC(Bdf) * 4096);
-
-      pal_mmio_write((Ecam + cfg_addr + COMMAND_REG_OFFSET),
-                  (pal_mmio_read((Ecam + cfg_addr) + COMMAND_REG_OFFSET) | BUS_MEM_EN_MASK));
+      // setting command register for Memory Space Enable and Bus Master Enable
+      pal_mmio_write(ctx->cfg_va + COMMAND_REG_OFFSET,
+                     (pal_mmio_read(ctx->cfg_va + COMMAND_REG_OFFSET) | BUS_MEM_EN_MASK));
 
       g_exercier_info_table.e_info[instance].initialized = 1;
   }
@@ -198,10 +214,7 @@ uint32_t val_exerciser_init(uint32_t instance)
 **/
 uint32_t val_exerciser_ops(EXERCISER_OPS ops, uint64_t param, uint32_t instance)
 {
-    uint32_t bdf = g_exercier_info_table.e_info[instance].bdf;
-    uint64_t ecam = val_pcie_get_ecam_base(bdf);
-
-    return pal_exerciser_ops(ops, param, bdf, ecam);
+    return pal_exerciser_ops(ops, param, val_exerciser_get_context(instance));
 }
 
 /**
@@ -214,10 +227,297 @@ uint32_t val_exerciser_ops(EXERCISER_OPS ops, uint64_t param, uint32_t instance)
 uint32_t val_exerciser_get_data(EXERCISER_DATA_TYPE type, exerciser_data_t *data,
                                 uint32_t instance)
 {
-    uint32_t bdf = g_exercier_info_table.e_info[instance].bdf;
-    uint64_t ecam = val_pcie_get_ecam_base(bdf);
+    return pal_exerciser_get_data(type, data, val_exerciser_get_context(instance));
+}
+
+/**
+  @brief   Send a data pattern through the exerciser memory. The source
+           buffer is filled with the pattern and cleaned to memory, written
+           out by DMA and read back by DMA into the destination buffer,
+           which is then invalidated and checked against the pattern.
+           The source and destination may be the same buffer.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_exerciser_init
+  @param   instance  - Stimulus hardware instance number
+  @param   src_virt  - Virtual address of the buffer sent to the exerciser
+  @param   src_phys  - Bus address of the buffer sent to the exerciser
+  @param   dst_virt  - Virtual address of the buffer read back into
+  @param   dst_phys  - Bus address of the buffer read back into
+  @param   len       - Length of the transfer in bytes
+  @param   pattern   - Data pattern to transfer
+  @param   info      - First difference of the read back data
+  @return  0 if the pattern came back intact, 1 on DMA failure, 2 on mismatch
+**/
+uint32_t val_exerciser_dma_pattern(uint32_t instance, void *src_virt, void *src_phys,
+                                   void *dst_virt, void *dst_phys, uint32_t len,
+                                   mem_pattern_t *pattern, mem_compare_info_t *info)
+{
+    val_memory_pattern_fill(src_virt, len, pattern);
+    val_data_cache_ops_by_range((addr_t)src_virt, len, CLEAN_AND_INVALIDATE);
+
+    val_exerciser_set_param(DMA_ATTRIBUTES, (uint64_t)src_phys, len, instance);
+    if (val_exerciser_ops(START_DMA, EDMA_TO_DEVICE, instance)) {
+        val_print(ACS_PRINT_ERR, "\n       DMA write failure to exerciser %4x", instance);
+        return 1;
+    }
 
-    return pal_exerciser_get_data(type, data, bdf, ecam);
+    val_exerciser_set_param(DMA_ATTRIBUTES, (uint64_t)dst_phys, len, instance);
+    if (val_exerciser_ops(START_DMA, EDMA_FROM_DEVICE, instance)) {
+        val_print(ACS_PRINT_ERR, "\n       DMA read failure from exerciser %4x", instance);
+        return 1;
+    }
+
+    val_data_cache_ops_by_range((addr_t)dst_virt, len, INVALIDATE);
+
+    if (val_memory_pattern_verify(dst_virt, len, pattern, info))
+        return 2;
+
+    return 0;
+}
+
+/* Concurrent traffic. Each stream is driven by its own secondary PE. The PEs
+   report ready through their shared data slot, then wait for the main PE to
+   publish a start time and all begin issuing DMA at that counter value, so
+   the exercisers load the fabric at the same time. The generic counter is
+   system wide, which makes the start and end times common to all PEs. */
+
+typedef struct {
+  uint64_t start;       ///< Counter value the streams start at, 0 until released
+  uint64_t end;         ///< Counter value the streams stop issuing DMA at
+  uint32_t test_num;    ///< Test the stream status is reported under
+} exerciser_traffic_ctrl_t;
+
+static volatile exerciser_traffic_ctrl_t g_traffic_ctrl;
+static exerciser_traffic_t *g_traffic_streams;
+
+/**
+  @brief   Stream payload run on a secondary PE. The stream index is passed
+           as the payload input.
+           1. Caller       -  val_exerciser_traffic_run, through val_execute_on_pe
+  @param   None
+  @return  None
+**/
+static
+void
+val_exerciser_traffic_payload(void)
+{
+  uint32_t index = val_pe_get_index();
+  exerciser_traffic_t *stream;
+  uint64_t data0, data1;
+  uint64_t start, end;
+  uint32_t direction;
+
+  val_get_test_data(index, &data0, &data1);
+  val_data_cache_ops_by_range((addr_t)&g_traffic_ctrl, sizeof(g_traffic_ctrl), INVALIDATE);
+  val_data_cache_ops_by_range((addr_t)&g_traffic_streams, sizeof(g_traffic_streams), INVALIDATE);
+
+  stream = &g_traffic_streams[data1];
+  val_data_cache_ops_by_range((addr_t)stream, sizeof(exerciser_traffic_t), INVALIDATE);
+
+  /* Wait at the start barrier. The main PE always releases it once every
+     PE was brought up, so the wait is bounded by the release, not by when
+     this PE came up. */
+  val_set_test_data(index, TRAFFIC_PE_READY, 0);
+  val_data_cache_ops_by_range((addr_t)&g_traffic_ctrl, sizeof(g_traffic_ctrl), INVALIDATE);
+  start = g_traffic_ctrl.start;
+
+  /* Released before this PE arrived, the main PE has already given up on it */
+  if (start != 0) {
+      val_set_status(index, RESULT_FAIL(g_traffic_ctrl.test_num, 1));
+      return;
+  }
+
+  do {
+      val_data_cache_ops_by_range((addr_t)&g_traffic_ctrl, sizeof(g_traffic_ctrl), INVALIDATE);
+      start = g_traffic_ctrl.start;
+  } while (start == 0);
+
+  end = g_traffic_ctrl.end;
+  while (val_timer_get_counter() < start)
+      ;
+
+  direction = (stream->type == TRAFFIC_DMA_FROM_DEVICE) ? EDMA_FROM_DEVICE : EDMA_TO_DEVICE;
+  while (val_timer_get_counter() < end) {
+      val_exerciser_set_param(DMA_ATTRIBUTES, stream->addr, stream->len, stream->instance);
+      if (val_exerciser_ops(START_DMA, direction, stream->instance)) {
+          stream->errors++;
+      } else {
+          stream->completions++;
+          stream->bytes += stream->len;
+      }
+
+      if (stream->type == TRAFFIC_DMA_LOOPBACK)
+          direction = (direction == EDMA_TO_DEVICE) ? EDMA_FROM_DEVICE : EDMA_TO_DEVICE;
+  }
+
+  stream->ticks = val_timer_get_counter() - start;
+  stream->completed = 1;
+  val_data_cache_ops_by_range((addr_t)stream, sizeof(exerciser_traffic_t), CLEAN_AND_INVALIDATE);
+
+  val_set_status(index, RESULT_PASS(g_traffic_ctrl.test_num, 1));
+}
+
+/**
+  @brief   Run DMA streams on several exercisers at once, one secondary PE
+           per stream, for the given duration. A stream that has not
+           completed shortly after the duration is left with completed = 0,
+           which points at a hung transaction. So is a stream whose PE did
+           not reach the start barrier before the release. The PEs of such
+           streams are marked lost. Streams beyond the number of available
+           secondary PEs are not run and keep pe_index = ACS_INVALID_INDEX.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_exerciser_init for every instance used
+  @param   test_num     - Test the secondary PE status is reported under
+  @param   streams      - Streams to run, counters are filled on return
+  @param   num_streams  - Number of streams
+  @param   duration_ms  - Time each stream keeps issuing DMA
+  @return  Number of streams that did not complete
+**/
+uint32_t val_exerciser_traffic_run(uint32_t test_num, exerciser_traffic_t *streams,
+                                   uint32_t num_streams, uint32_t duration_ms)
+{
+    uint32_t my_index = val_pe_get_index();
+    uint32_t num_pe = val_pe_get_num();
+    uint32_t pe_index, i;
+    uint32_t failed, not_run;
+    uint64_t freq, deadline;
+    uint64_t data0, data1;
+
+    freq = val_timer_get_info(TIMER_INFO_CNTFREQ, 0);
+    if (freq == 0)
+        return num_streams;
+
+    g_traffic_streams = streams;
+    g_traffic_ctrl.start = 0;
+    g_traffic_ctrl.end = 0;
+    g_traffic_ctrl.test_num = test_num;
+    val_data_cache_ops_by_range((addr_t)&g_traffic_streams, sizeof(g_traffic_streams),
+                                CLEAN_AND_INVALIDATE);
+    val_data_cache_ops_by_range((addr_t)&g_traffic_ctrl, sizeof(g_traffic_ctrl),
+                                CLEAN_AND_INVALIDATE);
+
+    /* Bring up one secondary PE per stream, lost PEs are left out */
+    pe_index = 0;
+    not_run = 0;
+    for (i = 0; i < num_streams; i++) {
+        while ((pe_index < num_pe) && ((pe_index == my_index) || val_pe_is_lost(pe_index)))
+            pe_index++;
+
+        streams[i].completions = 0;
+        streams[i].errors = 0;
+        streams[i].bytes = 0;
+        streams[i].ticks = 0;
+        streams[i].completed = 0;
+
+        if (pe_index >= num_pe) {
+            streams[i].pe_index = ACS_INVALID_INDEX;
+            not_run++;
+            continue;
+        }
+
+        streams[i].pe_index = pe_index++;
+        val_data_cache_ops_by_range((addr_t)&streams[i], sizeof(exerciser_traffic_t),
+                                    CLEAN_AND_INVALIDATE);
+
+        val_set_status(streams[i].pe_index, RESULT_PENDING(test_num));
+        val_set_test_data(streams[i].pe_index, 0, 0);
+        val_execute_on_pe(streams[i].pe_index, val_exerciser_traffic_payload, i);
+    }
+
+    if (not_run)
+        val_print(ACS_PRINT_WARN, "\n       Not enough PEs, %d streams not run", not_run);
+
+    /* Wait for every PE at the barrier, one second after the last bring up */
+    deadline = val_timer_get_counter() + freq;
+    do {
+        for (i = 0; i < num_streams; i++) {
+            if (streams[i].pe_index == ACS_INVALID_INDEX)
+                continue;
+            val_get_test_data(streams[i].pe_index, &data0, &data1);
+            if (data0 != TRAFFIC_PE_READY)
+                break;
+        }
+    } while ((i != num_streams) && (val_timer_get_counter() < deadline));
+
+    /* Release all streams at the same counter value */
+    g_traffic_ctrl.end = val_timer_get_counter() + (freq / 1000) +
+                         ((duration_ms * freq) / 1000);
+    g_traffic_ctrl.start = val_timer_get_counter() + (freq / 1000);
+    val_data_cache_ops_by_range((addr_t)&g_traffic_ctrl, sizeof(g_traffic_ctrl),
+                                CLEAN_AND_INVALIDATE);
+
+    /* A PE that arrives after the release fails itself without issuing DMA,
+       but it may never arrive */
+    for (i = 0; i < num_streams; i++) {
+        if (streams[i].pe_index == ACS_INVALID_INDEX)
+            continue;
+        val_get_test_data(streams[i].pe_index, &data0, &data1);
+        if (data0 != TRAFFIC_PE_READY) {
+            val_print(ACS_PRINT_ERR, "\n       PE %d did not reach the start barrier",
+                                     streams[i].pe_index);
+            val_pe_set_lost(streams[i].pe_index);
+        }
+    }
+
+    /* A stream blocked in a DMA for a second past the end is reported as hung */
+    deadline = g_traffic_ctrl.end + freq;
+    do {
+        for (i = 0; i < num_streams; i++)
+            if ((streams[i].pe_index != ACS_INVALID_INDEX) &&
+                !val_pe_is_lost(streams[i].pe_index) &&
+                IS_RESULT_PENDING(val_get_status(streams[i].pe_index)))
+                break;
+    } while ((i != num_streams) && (val_timer_get_counter() < deadline));
+
+    failed = 0;
+    for (i = 0; i < num_streams; i++) {
+        val_data_cache_ops_by_range((addr_t)&streams[i], sizeof(exerciser_traffic_t),
+                                    INVALIDATE);
+        if ((streams[i].pe_index == ACS_INVALID_INDEX) || streams[i].completed)
+            continue;
+
+        failed++;
+        if (IS_RESULT_PENDING(val_get_status(streams[i].pe_index)))
+            val_pe_set_lost(streams[i].pe_index);
+    }
+
+    return failed;
+}
+
+/**
+  @brief   Print the per stream results of val_exerciser_traffic_run
+  @param   level        - Print level
+  @param   streams      - Streams that were run
+  @param   num_streams  - Number of streams
+  @return  None
+**/
+void val_exerciser_traffic_report(uint32_t level, exerciser_traffic_t *streams,
+                                  uint32_t num_streams)
+{
+    uint64_t freq;
+    uint32_t i;
+
+    freq = val_timer_get_info(TIMER_INFO_CNTFREQ, 0);
+
+    for (i = 0; i < num_streams; i++) {
+        val_print(level, "\n       Exerciser %d", streams[i].instance);
+        if (streams[i].pe_index == ACS_INVALID_INDEX) {
+            val_print(level, " : no PE available, not run", 0);
+            continue;
+        }
+
+        val_print(level, " on PE %d", streams[i].pe_index);
+        if (!streams[i].completed) {
+            val_print(level, " : did not complete", 0);
+            continue;
+        }
+
+        val_print(level, " : %d DMA", streams[i].completions);
+        val_print(level, ", %d errors", streams[i].errors);
+        if (streams[i].ticks)
+            val_print(level, ", %d KB/s",
+                      ((streams[i].bytes * freq) / streams[i].ticks) / 1024);
+    }
 }
 
 /**
@@ -279,6 +579,16 @@ val_exerciser_execute_tests(uint32_t *g_sw_view)
      status |= os_e014_entry();
      status |= os_e015_entry();
 
+     /* Benchmarks are not part of the compliance run */
+     if (g_perf_mode) {
+       status |= os_e016_entry();
+       status |= os_e018_entry();
+     }
+
+     /* Concurrent traffic runs for a user given duration */
+     if (g_traffic_duration_ms)
+       status |= os_e017_entry();
+
   }
 
   if (status != ACS_STATUS_PASS)
@@ -114,6 +114,30 @@ test_done:
 }
 
 
+/**
+  @brief   This API executes the GIC benchmarks. These are not part of the
+           compliance run and are only called when performance mode is enabled.
+           1. Caller       -  Application layer.
+           2. Prerequisite -  val_gic_create_info_table(), val_gic_its_configure()
+  @param   num_pe - the number of PE to run these tests on.
+  @return  Consolidated status of all the tests run.
+**/
+uint32_t
+val_gic_execute_perf_tests(uint32_t num_pe)
+{
+  uint32_t i;
+
+  for (i = 0 ; i < MAX_TEST_SKIP_NUM ; i++) {
+      if (g_skip_test_num[i] == ACS_GIC_TEST_NUM_BASE) {
+          val_print(ACS_PRINT_TEST, "\n       USER Override - Skipping all GIC tests \n", 0);
+          return ACS_STATUS_SKIP;
+      }
+  }
+
+  return os_g007_entry(num_pe);
+}
+
+
 /**
   @brief   This API will call PAL layer to fill in the GIC information
            into the g_gic_info_table pointer.
@@ -134,7 +158,8 @@ val_gic_create_info_table(uint64_t *gic_info_table)
 
   g_gic_info_table = (GIC_INFO_TABLE *)gic_info_table;
 
-  pal_gic_create_info_table(g_gic_info_table);
+  if (val_snapshot_restore(SNAPSHOT_GIC_INFO, g_gic_info_table))
+      pal_gic_create_info_table(g_gic_info_table);
 
   val_print(ACS_PRINT_TEST, " GIC_INFO: Number of GICD             : %4d \n", g_gic_info_table->header.num_gicd);
   val_print(ACS_PRINT_TEST, " GIC_INFO: Number of ITS              : %4d \n", g_gic_info_table->header.num_its);
@@ -50,7 +50,7 @@ val_gic_reg_read(uint32_t reg_id)
       case ICH_MISR_EL2:
           return GicReadIchMisr();
       default:
-           val_report_status(val_pe_get_index_mpid(val_pe_get_mpid()),
+           val_report_status(val_pe_get_index(),
                                                   RESULT_FAIL(0, 0x78), NULL);
   }
 
@@ -86,8 +86,11 @@ val_gic_reg_write(uint32_t reg_id, uint64_t write_data)
       case ICC_PMR_EL1:
           GicWriteIccPmr(write_data);
           break;
+      case ICC_SGI1R_EL1:
+          GicWriteIccSgi1r(write_data);
+          break;
       default:
-           val_report_status(val_pe_get_index_mpid(val_pe_get_mpid()),
+           val_report_status(val_pe_get_index(),
                                                   RESULT_FAIL(0, 0x78), NULL);
   }
 
@@ -122,7 +125,8 @@ val_gic_is_valid_lpi(uint32_t int_id)
            1. Caller       -  Test Suite
            2. Prerequisite -  val_gic_create_info_table
   @param   int_id Interrupt ID to install the ISR
-  @param   isr    Function pointer of the ISR
+  @param   isr    Function pointer of the ISR. The Interrupt ID is passed as
+                  its first argument, so one ISR can serve many interrupts.
   @return  status
 **/
 uint32_t
@@ -197,6 +201,86 @@ uint32_t val_gic_end_of_interrupt(uint32_t int_id)
   return 0;
 }
 
+/**
+  @brief   This function generates a Group 1 SGI targeted at a single PE.
+           GICv2 can only target the calling PE.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_gic_create_info_table
+  @param   int_id SGI number (0 to 15)
+  @param   mpidr  MPIDR_EL1 reg value of the target PE
+  @return  status
+**/
+uint32_t val_gic_generate_sgi(uint32_t int_id, uint64_t mpidr)
+{
+  uint64_t sgi1r;
+  uint32_t aff0;
+
+  if (int_id > 15) {
+      val_print(ACS_PRINT_ERR, "\n    Invalid SGI number %d", int_id);
+      return ACS_STATUS_ERR;
+  }
+
+  if (val_gic_get_info(GIC_INFO_VERSION) >= 3) {
+      aff0  = mpidr & PE_AFF0;
+      sgi1r = ((uint64_t)int_id << ICC_SGI1R_INTID_SHIFT) |
+              (((mpidr & PE_AFF1) >> 8) << ICC_SGI1R_AFF1_SHIFT) |
+              (((mpidr & PE_AFF2) >> 16) << ICC_SGI1R_AFF2_SHIFT) |
+              (((mpidr & PE_AFF3) >> 32) << ICC_SGI1R_AFF3_SHIFT) |
+              ((uint64_t)(aff0 / 16) << ICC_SGI1R_RS_SHIFT) |
+              (1 << (aff0 % 16));
+      val_gic_reg_write(ICC_SGI1R_EL1, sgi1r);
+      return 0;
+  }
+
+  if ((mpidr & (PE_AFF0 | PE_AFF1 | PE_AFF2 | PE_AFF3)) !=
+      (val_pe_get_mpid() & (PE_AFF0 | PE_AFF1 | PE_AFF2 | PE_AFF3)))
+      return ACS_STATUS_ERR;
+
+  val_mmio_write(val_get_gicd_base() + GICD_SGIR, GICD_SGIR_TARGET_SELF | int_id);
+  return 0;
+}
+
+/**
+  @brief   This function enables an interrupt at the distributor, or at the
+           calling PE's redistributor for SGIs and PPIs, without installing a
+           handler. Used by PEs which service interrupts by polling.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_gic_create_info_table
+  @param   int_id Interrupt ID
+  @return  none
+**/
+void val_gic_poll_enable(uint32_t int_id)
+{
+  val_bsa_gic_enableInterruptSource(int_id);
+}
+
+/**
+  @brief   This function acknowledges the highest priority pending interrupt at
+           the calling PE's CPU interface. Works with PSTATE.I set, so a PE can
+           service interrupts by polling.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_gic_cpuif_init
+  @param   none
+  @return  Interrupt ID, 1023 if nothing is pending
+**/
+uint32_t val_gic_poll_acknowledge(void)
+{
+  return val_bsa_gic_acknowledgeInterrupt() & 0xFFFFFF;
+}
+
+/**
+  @brief   This function completes an interrupt acknowledged with
+           val_gic_poll_acknowledge on the calling PE.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_gic_poll_acknowledge
+  @param   int_id Interrupt ID returned by val_gic_poll_acknowledge
+  @return  none
+**/
+void val_gic_poll_end_of_interrupt(uint32_t int_id)
+{
+  val_bsa_gic_endofInterrupt(int_id);
+}
+
 /**
   @brief   This function gets list of ITS in the system and ITS initialization
            1. Caller       -  Application Layer
@@ -457,6 +541,137 @@ uint32_t val_gic_request_msi(uint32_t bdf, uint32_t device_id, uint32_t its_id,
   return status;
 }
 
+/**
+  @brief   This function programs a contiguous range of MSI-X table entries,
+           reading the table location from config space only once.
+           1. Caller       -  val_gic_request_msi_range
+           2. Prerequisite -  val_gic_its_configure
+  @param   bdf BDF of the device
+  @param   msi_index_base First MSI Index in MSI-X table to be programmed
+  @param   num_msi Number of consecutive entries to program
+  @param   msi_addr MSI Address to be programmed
+  @param   msi_data_base MSI Data for the first entry, incremented per entry
+  @return  Status
+**/
+static uint32_t fill_msi_x_table_range(uint32_t bdf, uint32_t msi_index_base, uint32_t num_msi,
+                                       uint32_t msi_addr, uint32_t msi_data_base)
+{
+
+  uint32_t msi_cap_offset, msi_table_bar_index;
+  uint32_t table_offset_reg, table_address, command_data;
+  uint32_t read_value;
+  uint32_t entry;
+
+  /* Enable Memory Space, Bus Master */
+  val_pcie_read_cfg(bdf, TYPE01_CR, &command_data);
+  val_pcie_write_cfg(bdf, TYPE01_CR, (command_data | (1 << CR_MSE_SHIFT) | (1 << CR_BME_SHIFT)));
+
+  /* Get MSI Capability Offset */
+  if (val_pcie_find_capability(bdf, PCIE_CAP, CID_MSIX, &msi_cap_offset))
+    return ACS_STATUS_SKIP;
+
+  /* Read MSI-X Table Address from the BAR Register */
+  val_pcie_read_cfg(bdf, msi_cap_offset + MSI_X_TOR_OFFSET, &table_offset_reg);
+  msi_table_bar_index = table_offset_reg & MSI_X_TABLE_BIR_MASK;
+  val_pcie_read_cfg(bdf, TYPE01_BAR + msi_table_bar_index*4, &table_address);
+
+  /* Fill MSI Table entries before enabling MSI-X, so no entry fires half programmed */
+  for (entry = msi_index_base; entry < msi_index_base + num_msi; entry++) {
+    val_mmio_write(table_address + entry*MSI_X_ENTRY_SIZE + MSI_X_MSG_TBL_ADDR_OFFSET, msi_addr);
+    val_mmio_write(table_address + entry*MSI_X_ENTRY_SIZE + MSI_X_MSG_TBL_DATA_OFFSET,
+                   msi_data_base + (entry - msi_index_base));
+    val_mmio_write(table_address + entry*MSI_X_ENTRY_SIZE + MSI_X_MSG_TBL_MVC_OFFSET, 0x0);
+  }
+
+  /* Enable MSI-X in MSI-X Capability */
+  val_pcie_read_cfg(bdf, msi_cap_offset, &read_value);
+  val_pcie_write_cfg(bdf, msi_cap_offset, read_value | (1 << MSI_X_ENABLE_SHIFT));
+
+  return ACS_STATUS_PASS;
+}
+
+/**
+  @brief   This function creates the MSI mappings for a range of MSI-X vectors
+           with a single ITS command queue submission, and programs the MSI
+           Table. MSI index n of the device is mapped to int_id_base + n.
+
+  @param   bdf          B:D:F for the device
+  @param   device_id    Device ID
+  @param   its_id       ITS ID
+  @param   int_id_base  Interrupt ID for MSI index 0
+  @param   num_msi      Number of MSI-X vectors to map
+
+  @return  status
+**/
+uint32_t val_gic_request_msi_range(uint32_t bdf, uint32_t device_id, uint32_t its_id,
+                                   uint32_t int_id_base, uint32_t num_msi)
+{
+  uint32_t its_index;
+
+  if ((g_gic_its_info == NULL) || (g_gic_its_info->GicNumIts == 0))
+    return ACS_STATUS_ERR;
+
+  its_index = get_its_index(its_id);
+
+  if (its_index >= g_gic_its_info->GicNumIts) {
+    val_print(ACS_PRINT_ERR, "\n       Could not find ITS ID [%x]", its_id);
+    return ACS_STATUS_ERR;
+  }
+
+  if ((g_gic_its_info->GicRdBase == 0) || (g_gic_its_info->GicDBase == 0))
+  {
+    val_print(ACS_PRINT_DEBUG, "\n       GICD/GICRD Base Invalid value", 0);
+    return ACS_STATUS_ERR;
+  }
+
+  if ((num_msi == 0) || ((int_id_base + num_msi - 1) > val_its_get_max_lpi())) {
+    val_print(ACS_PRINT_ERR, "\n       LPI range exceeds max LPI, count : %d", num_msi);
+    return ACS_STATUS_ERR;
+  }
+
+  val_its_create_lpi_map_range(its_index, device_id, int_id_base, num_msi, LPI_PRIORITY1);
+
+  return fill_msi_x_table_range(bdf, 0, num_msi, val_its_get_translater_addr(its_index),
+                                int_id_base);
+}
+
+/**
+  @brief   This function clears the MSI mappings created by
+           val_gic_request_msi_range.
+
+  @param   bdf          B:D:F for the device
+  @param   device_id    Device ID
+  @param   its_id       ITS ID
+  @param   int_id_base  Interrupt ID for MSI index 0
+  @param   num_msi      Number of MSI-X vectors mapped
+
+  @return  none
+**/
+void val_gic_free_msi_range(uint32_t bdf, uint32_t device_id, uint32_t its_id,
+                            uint32_t int_id_base, uint32_t num_msi)
+{
+  uint32_t its_index;
+  uint32_t msi_index;
+
+  its_index = get_its_index(its_id);
+  if (its_index >= g_gic_its_info->GicNumIts)
+  {
+    val_print(ACS_PRINT_ERR, "\n       Could not find ITS ID [%x]", its_id);
+    return;
+  }
+
+  if ((g_gic_its_info->GicRdBase == 0) || (g_gic_its_info->GicDBase == 0))
+  {
+    val_print(ACS_PRINT_ERR, "\n       GICD/GICRD Base Invalid value", 0);
+    return;
+  }
+
+  val_its_clear_lpi_map_range(its_index, device_id, int_id_base, num_msi);
+
+  for (msi_index = 0; msi_index < num_msi; msi_index++)
+    clear_msi_x_table(bdf, msi_index);
+}
+
 /**
   @brief   This function gets the ITS Base for an ITS block with its_id
            1. Caller       -  Validation layer
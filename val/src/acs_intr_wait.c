@@ -0,0 +1,280 @@
+/** @file
+ * Copyright (c) 2021 Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "include/bsa_acs_val.h"
+#include "include/bsa_acs_common.h"
+#include "include/bsa_acs_pe.h"
+#include "include/bsa_acs_memory.h"
+
+/* Waiting for interrupt sources.
+
+   A test adds each source with the function that quiesces it, arms all of
+   them and records the counter value each one is due to fire at. The PE
+   then sleeps in WFI until every source has been taken or the deadline,
+   the latest expiry plus a margin, has passed. The virtual timer of the
+   current EL is programmed to the deadline so that the wait ends even if
+   no source fires.
+
+   The interrupt handler samples the counter on entry, so the result of a
+   source gives the latency from its programmed expiry to its handler. */
+
+#define INTR_WAIT_MAX_SRC        16
+#define INTR_WAIT_MAX_TICKS      0x7FFFFFFF   ///< Largest positive TVAL
+
+typedef struct {
+  uint32_t intid;
+  uint32_t armed;
+  void     (*stop)(uint64_t arg);
+  uint64_t arg;
+  uint64_t expiry;       ///< Counter value the source is due to fire at
+  volatile uint64_t taken;  ///< Counter value at handler entry, 0 until taken
+} intr_wait_src_t;
+
+static intr_wait_src_t g_intr_wait_src[INTR_WAIT_MAX_SRC];
+static uint32_t g_intr_wait_num;
+static volatile uint32_t g_intr_wait_pending;
+
+/**
+  @brief   Interrupt handler of the added sources. Stops the source and
+           records when it was taken.
+
+  @param   int_id   Interrupt ID, passed by the interrupt protocol
+
+  @return  None
+**/
+static void
+val_intr_wait_isr(uint32_t int_id)
+{
+  uint64_t now = val_timer_get_counter();
+  uint32_t i;
+
+  for (i = 0; i < g_intr_wait_num; i++) {
+      if ((g_intr_wait_src[i].intid != int_id) || !g_intr_wait_src[i].armed ||
+          g_intr_wait_src[i].taken)
+          continue;
+
+      g_intr_wait_src[i].stop(g_intr_wait_src[i].arg);
+      g_intr_wait_src[i].taken = now;
+      g_intr_wait_pending--;
+      break;
+  }
+
+  val_gic_end_of_interrupt(int_id);
+}
+
+/**
+  @brief   Interrupt handler of the deadline timer. Only ends the WFI.
+
+  @param   int_id   Interrupt ID, passed by the interrupt protocol
+
+  @return  None
+**/
+static void
+val_intr_wait_timer_isr(uint32_t int_id)
+{
+  val_timer_set_vir_el1(0);
+  val_gic_end_of_interrupt(int_id);
+}
+
+/**
+  @brief   Forget the sources of a previous wait.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  None
+  @param   None
+  @return  None
+**/
+void
+val_intr_wait_init(void)
+{
+  g_intr_wait_num = 0;
+  g_intr_wait_pending = 0;
+  val_memory_set(g_intr_wait_src, sizeof(g_intr_wait_src), 0);
+}
+
+/**
+  @brief   Add an interrupt source and install the handler for its interrupt.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_intr_wait_init, GIC initialized
+  @param   intid  Interrupt ID of the source
+  @param   stop   Function quiescing the source, called from the handler
+  @param   arg    Argument of stop
+  @return  Slot of the source, INTR_WAIT_ERR on failure
+**/
+uint32_t
+val_intr_wait_add(uint32_t intid, void (*stop)(uint64_t arg), uint64_t arg)
+{
+  intr_wait_src_t *src;
+
+  if (g_intr_wait_num >= INTR_WAIT_MAX_SRC)
+      return INTR_WAIT_ERR;
+
+  if (val_gic_install_isr(intid, (void (*)(void))val_intr_wait_isr))
+      return INTR_WAIT_ERR;
+
+  src = &g_intr_wait_src[g_intr_wait_num];
+  src->intid = intid;
+  src->stop  = stop;
+  src->arg   = arg;
+
+  return g_intr_wait_num++;
+}
+
+/**
+  @brief   Record that a source was armed. Read the counter before arming
+           the source and pass that value plus the programmed ticks.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_intr_wait_add
+  @param   slot    Slot returned by val_intr_wait_add
+  @param   expiry  Counter value the source is due to fire at
+  @return  None
+**/
+void
+val_intr_wait_armed(uint32_t slot, uint64_t expiry)
+{
+  if (slot >= g_intr_wait_num)
+      return;
+
+  g_intr_wait_src[slot].expiry = expiry;
+  g_intr_wait_src[slot].armed = 1;
+  g_intr_wait_pending++;
+}
+
+/**
+  @brief   Program the deadline timer for the remaining time, capped to what
+           fits in TVAL.
+
+  @param   deadline  Counter value to wake up at
+
+  @return  None
+**/
+static void
+val_intr_wait_program(uint64_t deadline)
+{
+  uint64_t now = val_timer_get_counter();
+  uint64_t ticks;
+
+  ticks = (deadline > now) ? (deadline - now) : 1;
+  if (ticks > INTR_WAIT_MAX_TICKS)
+      ticks = INTR_WAIT_MAX_TICKS;
+
+  val_timer_set_vir_el1(ticks);
+}
+
+/**
+  @brief   Wait in WFI until all armed sources were taken or until the latest
+           expiry plus margin. Sources not taken by then are stopped.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_intr_wait_armed
+  @param   margin  Counter ticks allowed past the latest expiry
+  @return  Number of armed sources not taken
+**/
+uint32_t
+val_intr_wait(uint64_t margin)
+{
+  uint64_t deadline = 0;
+  uint32_t timer_intid, use_wfi, i;
+
+  for (i = 0; i < g_intr_wait_num; i++)
+      if (g_intr_wait_src[i].armed && (g_intr_wait_src[i].expiry > deadline))
+          deadline = g_intr_wait_src[i].expiry;
+  deadline += margin;
+
+  /* CNTV accesses reach the EL2 virtual timer at EL2 with E2H set */
+  if ((AA64ReadCurrentEL() == AARCH64_EL2) && (ArmReadHcr() & AARCH64_HCR_E2H_MASK))
+      timer_intid = val_timer_get_info(TIMER_INFO_VIR_EL2_INTID, 0);
+  else
+      timer_intid = val_timer_get_info(TIMER_INFO_VIR_EL1_INTID, 0);
+
+  /* Without the deadline timer, poll the counter instead */
+  use_wfi = (timer_intid != 0) &&
+            !val_gic_install_isr(timer_intid,
+                                 (void (*)(void))val_intr_wait_timer_isr);
+
+  while (g_intr_wait_pending && (val_timer_get_counter() < deadline)) {
+      if (use_wfi) {
+          val_intr_wait_program(deadline);
+          PeWaitForInterrupt(&g_intr_wait_pending);
+      }
+  }
+
+  if (use_wfi)
+      val_timer_set_vir_el1(0);
+
+  val_intr_wait_cancel();
+
+  for (i = 0; i < g_intr_wait_num; i++)
+      if (g_intr_wait_src[i].armed && (g_intr_wait_src[i].taken == 0))
+          val_print(ACS_PRINT_DEBUG, "\n       No interrupt from intid %d", g_intr_wait_src[i].intid);
+
+  return g_intr_wait_pending;
+}
+
+/**
+  @brief   Stop the armed sources not taken yet, e.g. when a test gives up
+           after arming some of them.
+           1. Caller       -  Test Suite, val_intr_wait
+           2. Prerequisite -  None
+  @param   None
+  @return  None
+**/
+void
+val_intr_wait_cancel(void)
+{
+  uint32_t i;
+
+  for (i = 0; i < g_intr_wait_num; i++)
+      if (g_intr_wait_src[i].armed && (g_intr_wait_src[i].taken == 0))
+          g_intr_wait_src[i].stop(g_intr_wait_src[i].arg);
+}
+
+/**
+  @brief   Result of a source after val_intr_wait.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_intr_wait
+  @param   slot        Slot returned by val_intr_wait_add
+  @param   latency_ns  Time from the expiry to the handler, or by how much the
+                       handler came early. Not written for a missed source.
+  @return  INTR_WAIT_RESULT_e
+**/
+uint32_t
+val_intr_wait_result(uint32_t slot, uint64_t *latency_ns)
+{
+  intr_wait_src_t *src;
+  uint64_t freq = val_timer_get_info(TIMER_INFO_CNTFREQ, 0);
+  uint64_t ticks;
+  uint32_t result;
+
+  if ((slot >= g_intr_wait_num) || !g_intr_wait_src[slot].armed ||
+      (g_intr_wait_src[slot].taken == 0))
+      return INTR_WAIT_MISSED;
+
+  src = &g_intr_wait_src[slot];
+  if (src->taken < src->expiry) {
+      ticks = src->expiry - src->taken;
+      result = INTR_WAIT_EARLY;
+  } else {
+      ticks = src->taken - src->expiry;
+      result = INTR_WAIT_TAKEN;
+  }
+
+  if (freq)
+      *latency_ns = (ticks * 1000000000) / freq;
+  else
+      *latency_ns = 0;
+
+  return result;
+}
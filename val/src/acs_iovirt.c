@@ -19,9 +19,27 @@
 #include "include/bsa_acs_common.h"
 #include "include/bsa_acs_iovirt.h"
 #include "include/bsa_acs_smmu.h"
+#include "include/bsa_acs_pcie.h"
 
 IOVIRT_INFO_TABLE *g_iovirt_info_table;
 
+/* Root complex ID mappings flattened through any SMMU on the way to the ITS.
+   Each entry resolves a range of RIDs of one segment straight to DeviceIDs,
+   StreamIDs and an ITS. The array is sorted by segment, then RID, and the
+   ranges never overlap, so a lookup is a binary search. */
+typedef struct {
+  uint32_t segment;
+  uint32_t rid_base;
+  uint32_t rid_end;         /* Inclusive */
+  uint32_t device_id_base;
+  uint32_t stream_id_base;  /* ~0 when the RC maps straight to an ITS group */
+  uint32_t its_id;
+  uint32_t valid;
+} iovirt_rid_map_t;
+
+static iovirt_rid_map_t *g_iovirt_rid_map;
+static uint32_t         g_iovirt_rid_map_num;
+
 /**
   @brief   This API is a single point of entry to retrieve
            SMMU information stored in the IoVirt Info table
@@ -247,18 +265,251 @@ val_iovirt_unique_rid_strid_map(uint32_t rc_index)
 }
 
 /**
-  @brief  Calculate the device id and stream id orresponding to the requestor id
+  @brief  Check whether any two ID mappings of a block overlap
+
+  @param  block  iovirt block
+
+  @return 1 if mappings overlap, 0 otherwise
+**/
+static uint32_t
+val_iovirt_maps_overlap(IOVIRT_BLOCK *block)
+{
+  uint32_t i, j;
+  uint64_t end_i, end_j;
+  NODE_DATA_MAP *map = &block->data_map[0];
+
+  for (i = 0; i < block->num_data_map; i++) {
+      end_i = (uint64_t)map[i].map.input_base + map[i].map.id_count;
+      for (j = i + 1; j < block->num_data_map; j++) {
+          end_j = (uint64_t)map[j].map.input_base + map[j].map.id_count;
+          if ((map[i].map.input_base <= end_j) && (map[j].map.input_base <= end_i))
+              return 1;
+      }
+  }
+
+  return 0;
+}
+
+/**
+  @brief   Build the RID index from the root complex nodes of the iovirt table.
+           RIDs not covered by the index, including any whose mappings
+           overlap, are resolved by walking the table as before.
+           1. Caller       -  val_iovirt_create_info_table
+           2. Prerequisite -  g_iovirt_info_table populated
+  @param   None
+  @return  None
+**/
+static void
+val_iovirt_create_rid_index(void)
+{
+  uint32_t i, j, k;
+  uint32_t count = 0;
+  uint32_t owner = 0;
+  uint64_t rc_end, smmu_end, lo, hi;
+  uint64_t max_end = 0;
+  IOVIRT_BLOCK *block, *out, *its;
+  NODE_DATA_MAP *map, *smap;
+  iovirt_rid_map_t *entry, tmp;
+
+  /* One interval per RC mapping into an ITS group, at most one per SMMU mapping otherwise */
+  block = &g_iovirt_info_table->blocks[0];
+  for (i = 0; i < g_iovirt_info_table->num_blocks; i++, block = IOVIRT_NEXT_BLOCK(block))
+  {
+      if (block->type != IOVIRT_NODE_PCI_ROOT_COMPLEX)
+          continue;
+
+      for (j = 0, map = &block->data_map[0]; j < block->num_data_map; j++, map++)
+      {
+          out = (IOVIRT_BLOCK *)((uint8_t *)g_iovirt_info_table + (*map).map.output_ref);
+          if (out->type == IOVIRT_NODE_ITS_GROUP)
+              count++;
+          else if (out->type == IOVIRT_NODE_SMMU || out->type == IOVIRT_NODE_SMMU_V3)
+              count += out->num_data_map;
+      }
+  }
+
+  if (count == 0)
+      return;
+
+  g_iovirt_rid_map = (iovirt_rid_map_t *)pal_mem_alloc(count * sizeof(iovirt_rid_map_t));
+  if (g_iovirt_rid_map == NULL) {
+      val_print(ACS_PRINT_WARN, "\n       RID index allocation failed", 0);
+      return;
+  }
+
+  block = &g_iovirt_info_table->blocks[0];
+  for (i = 0; i < g_iovirt_info_table->num_blocks; i++, block = IOVIRT_NEXT_BLOCK(block))
+  {
+      if (block->type != IOVIRT_NODE_PCI_ROOT_COMPLEX)
+          continue;
+
+      for (j = 0, map = &block->data_map[0]; j < block->num_data_map; j++, map++)
+      {
+          rc_end = (uint64_t)(*map).map.output_base + (*map).map.id_count;
+          out = (IOVIRT_BLOCK *)((uint8_t *)g_iovirt_info_table + (*map).map.output_ref);
+
+          if (out->type == IOVIRT_NODE_ITS_GROUP)
+          {
+              entry = &g_iovirt_rid_map[g_iovirt_rid_map_num++];
+              entry->segment        = block->data.rc.segment;
+              entry->rid_base       = (*map).map.input_base;
+              entry->rid_end        = (*map).map.input_base + (*map).map.id_count;
+              entry->device_id_base = (*map).map.output_base;
+              entry->stream_id_base = ~((uint32_t)0);
+              entry->its_id         = out->data_map[0].id[0];
+              entry->valid          = 1;
+              continue;
+          }
+
+          if ((out->type != IOVIRT_NODE_SMMU && out->type != IOVIRT_NODE_SMMU_V3) ||
+              val_iovirt_maps_overlap(out))
+              continue;
+
+          /* Split the RC range at the SMMU mapping boundaries */
+          for (k = 0, smap = &out->data_map[0]; k < out->num_data_map; k++, smap++)
+          {
+              smmu_end = (uint64_t)(*smap).map.input_base + (*smap).map.id_count;
+              lo = ((*map).map.output_base > (*smap).map.input_base) ?
+                    (*map).map.output_base : (*smap).map.input_base;
+              hi = (rc_end < smmu_end) ? rc_end : smmu_end;
+              if (lo > hi)
+                  continue;
+
+              its = (IOVIRT_BLOCK *)((uint8_t *)g_iovirt_info_table + (*smap).map.output_ref);
+
+              entry = &g_iovirt_rid_map[g_iovirt_rid_map_num++];
+              entry->segment        = block->data.rc.segment;
+              entry->rid_base       = (*map).map.input_base + (lo - (*map).map.output_base);
+              entry->rid_end        = (*map).map.input_base + (hi - (*map).map.output_base);
+              entry->stream_id_base = lo;
+              entry->device_id_base = (*smap).map.output_base + (lo - (*smap).map.input_base);
+              entry->its_id         = (its->type == IOVIRT_NODE_ITS_GROUP) ?
+                                      its->data_map[0].id[0] : 0;
+              entry->valid          = 1;
+          }
+      }
+  }
+
+  /* Sort by segment, then RID */
+  for (i = 1; i < g_iovirt_rid_map_num; i++)
+  {
+      tmp = g_iovirt_rid_map[i];
+      for (j = i; j > 0; j--)
+      {
+          entry = &g_iovirt_rid_map[j - 1];
+          if ((entry->segment < tmp.segment) ||
+              ((entry->segment == tmp.segment) && (entry->rid_base <= tmp.rid_base)))
+              break;
+          g_iovirt_rid_map[j] = *entry;
+      }
+      g_iovirt_rid_map[j] = tmp;
+  }
+
+  /* Leave overlapping ranges to the table walk, which applies the table's own precedence */
+  for (i = 0; i < g_iovirt_rid_map_num; i++)
+  {
+      entry = &g_iovirt_rid_map[i];
+      if ((i > 0) && (entry->segment == g_iovirt_rid_map[owner].segment) &&
+          (entry->rid_base <= max_end))
+      {
+          entry->valid = 0;
+          g_iovirt_rid_map[owner].valid = 0;
+      }
+
+      if ((i == 0) || (entry->segment != g_iovirt_rid_map[owner].segment) ||
+          (entry->rid_end > max_end))
+      {
+          owner = i;
+          max_end = entry->rid_end;
+      }
+  }
+
+  for (i = 0, j = 0; i < g_iovirt_rid_map_num; i++)
+      if (g_iovirt_rid_map[i].valid)
+          g_iovirt_rid_map[j++] = g_iovirt_rid_map[i];
+
+  val_print(ACS_PRINT_INFO, " IOVIRT_INFO: RID index entries : %d\n", j);
+  if (j != g_iovirt_rid_map_num)
+      val_print(ACS_PRINT_DEBUG, "  Overlapping RID ranges left to table walk: %d\n",
+                g_iovirt_rid_map_num - j);
+  g_iovirt_rid_map_num = j;
+}
+
+/**
+  @brief  Find the RID index entry covering a requester ID
+
+  @param  rid      Requester ID
+  @param  segment  PCI segment number
+
+  @return Index entry, NULL if the RID is not indexed
+**/
+static iovirt_rid_map_t *
+val_iovirt_find_rid_map(uint32_t rid, uint32_t segment)
+{
+  uint32_t lo = 0;
+  uint32_t hi = g_iovirt_rid_map_num;
+  uint32_t mid;
+  iovirt_rid_map_t *entry;
+
+  /* Find the last entry starting at or below (segment, rid) */
+  while (lo < hi)
+  {
+      mid = lo + (hi - lo) / 2;
+      entry = &g_iovirt_rid_map[mid];
+      if ((entry->segment < segment) ||
+          ((entry->segment == segment) && (entry->rid_base <= rid)))
+          lo = mid + 1;
+      else
+          hi = mid;
+  }
+
+  if (lo == 0)
+      return NULL;
+
+  entry = &g_iovirt_rid_map[lo - 1];
+  if ((entry->segment != segment) || (rid > entry->rid_end))
+      return NULL;
+
+  return entry;
+}
+
+/**
+  @brief  Resolve a requester ID from an RID index entry
+
+  @param  entry        Index entry covering rid
+  @param  rid          Requester ID
+  @param  *device_id   Pointer to device id
+  @param  *stream_id   Pointer to stream id
+  @param  *its_id      Pointer to its id
+  @return None
+**/
+static void
+val_iovirt_resolve_rid_map(iovirt_rid_map_t *entry, uint32_t rid, uint32_t *device_id,
+                           uint32_t *stream_id, uint32_t *its_id)
+{
+  uint32_t offset = rid - entry->rid_base;
+
+  *device_id = entry->device_id_base + offset;
+  if (stream_id)
+      *stream_id = (entry->stream_id_base == ~((uint32_t)0)) ?
+                   ~((uint32_t)0) : (entry->stream_id_base + offset);
+  if (its_id)
+      *its_id = entry->its_id;
+}
+
+/**
+  @brief  Calculate the device id and stream id by walking the iovirt table
   @param  rid          Requestor ID
   @param  segment      pci_segment_number
   @param  *device_id   Pointer to device id
   @param  *stream_id   Pointer to stream id
   @param  *its_id      Pointer to its id
+  @param  err_level    Print level of the mapping errors
   @return status
 **/
-
-int
-val_iovirt_get_device_info(uint32_t rid, uint32_t segment, uint32_t *device_id,
-                           uint32_t *stream_id, uint32_t *its_id)
+static int
+val_iovirt_walk_device_info(uint32_t rid, uint32_t segment, uint32_t *device_id,
+                            uint32_t *stream_id, uint32_t *its_id, uint32_t err_level)
 {
   uint32_t i, j, id = 0;
   uint32_t sid, did, oref;
@@ -266,15 +517,6 @@ val_iovirt_get_device_info(uint32_t rid, uint32_t segment, uint32_t *device_id,
   uint32_t mapping_found;
   IOVIRT_BLOCK *block;
   NODE_DATA_MAP *map;
-  if (g_iovirt_info_table == NULL)
-  {
-      val_print(ACS_PRINT_ERR, "\n       GET_DEVICE_ID: iovirt info table is not created", 0);
-      return ACS_STATUS_ERR;
-  }
-  if (!device_id) {
-      val_print(ACS_PRINT_ERR, "\n       GET_DEVICE_ID: Invalid parameters", 0);
-      return ACS_STATUS_ERR;
-  }
 
   /* Search for root complex block with same segment number, and in whose id */
   /* mapping range 'rid' falls. Calculate the output id */
@@ -299,7 +541,7 @@ val_iovirt_get_device_info(uint32_t rid, uint32_t segment, uint32_t *device_id,
       }
   }
   if (!mapping_found) {
-      val_print(ACS_PRINT_ERR,
+      val_print(err_level,
              "\n       RID to Stream/Dev ID map not found ", 0);
       return ACS_STATUS_ERR;
   }
@@ -336,12 +578,12 @@ val_iovirt_get_device_info(uint32_t rid, uint32_t segment, uint32_t *device_id,
   }
   else
   {
-    val_print(ACS_PRINT_ERR, "\n       GET_DEVICE_ID: Invalid mapping for RC in IORT", 0);
+    val_print(err_level, "\n       GET_DEVICE_ID: Invalid mapping for RC in IORT", 0);
     return ACS_STATUS_ERR;
   }
   if (!mapping_found)
   {
-    val_print(ACS_PRINT_ERR,
+    val_print(err_level,
                         "\n       GET_DEVICE_ID: Stream ID to Device ID mapping not found", 0);
     return ACS_STATUS_ERR;
   }
@@ -354,6 +596,146 @@ val_iovirt_get_device_info(uint32_t rid, uint32_t segment, uint32_t *device_id,
   return 0;
 }
 
+/**
+  @brief  Calculate the device id and stream id orresponding to the requestor id
+  @param  rid          Requestor ID
+  @param  segment      pci_segment_number
+  @param  *device_id   Pointer to device id
+  @param  *stream_id   Pointer to stream id
+  @param  *its_id      Pointer to its id
+  @return status
+**/
+
+int
+val_iovirt_get_device_info(uint32_t rid, uint32_t segment, uint32_t *device_id,
+                           uint32_t *stream_id, uint32_t *its_id)
+{
+  iovirt_rid_map_t *entry;
+
+  if (g_iovirt_info_table == NULL)
+  {
+      val_print(ACS_PRINT_ERR, "\n       GET_DEVICE_ID: iovirt info table is not created", 0);
+      return ACS_STATUS_ERR;
+  }
+  if (!device_id) {
+      val_print(ACS_PRINT_ERR, "\n       GET_DEVICE_ID: Invalid parameters", 0);
+      return ACS_STATUS_ERR;
+  }
+
+  entry = val_iovirt_find_rid_map(rid, segment);
+  if (entry) {
+      val_iovirt_resolve_rid_map(entry, rid, device_id, stream_id, its_id);
+      return 0;
+  }
+
+  return val_iovirt_walk_device_info(rid, segment, device_id, stream_id, its_id, ACS_PRINT_ERR);
+}
+
+/**
+  @brief   Resolve the device id, stream id and ITS id of every function in
+           the PCIe BDF table in one pass.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_iovirt_create_info_table, val_pcie_create_device_bdf_table
+  @param   info         Output array, one entry per BDF table entry
+  @param   num_entries  Number of entries in info
+  @return  Number of functions that could not be resolved
+**/
+uint32_t
+val_iovirt_get_bdf_table_device_info(iovirt_device_info_t *info, uint32_t num_entries)
+{
+  uint32_t i;
+  uint32_t bdf;
+  uint32_t rid;
+  uint32_t segment;
+  uint32_t failed = 0;
+  iovirt_rid_map_t *entry = NULL;
+  pcie_device_bdf_table *bdf_tbl_ptr;
+
+  bdf_tbl_ptr = val_pcie_bdf_table_ptr();
+  if ((info == NULL) || (bdf_tbl_ptr == NULL) || (g_iovirt_info_table == NULL))
+      return num_entries;
+
+  if (num_entries > bdf_tbl_ptr->num_entries)
+      num_entries = bdf_tbl_ptr->num_entries;
+
+  for (i = 0; i < num_entries; i++)
+  {
+      bdf = bdf_tbl_ptr->device[i].bdf;
+      rid = PCIE_CREATE_BDF_PACKED(bdf);
+      segment = PCIE_EXTRACT_BDF_SEG(bdf);
+
+      /* The BDF table is in bus order, so the previous range usually covers the next RID */
+      if ((entry == NULL) || (entry->segment != segment) ||
+          (rid < entry->rid_base) || (rid > entry->rid_end))
+          entry = val_iovirt_find_rid_map(rid, segment);
+
+      if (entry) {
+          val_iovirt_resolve_rid_map(entry, rid, &info[i].device_id,
+                                     &info[i].stream_id, &info[i].its_id);
+          info[i].status = 0;
+          continue;
+      }
+
+      info[i].status = val_iovirt_walk_device_info(rid, segment, &info[i].device_id,
+                                                   &info[i].stream_id, &info[i].its_id,
+                                                   ACS_PRINT_DEBUG);
+      if (info[i].status)
+          failed++;
+  }
+
+  return failed;
+}
+
+/**
+  @brief   Find the StreamIDs routed to an SMMU by the ID mappings of the
+           root complex and named component nodes in the iovirt table.
+           1. Caller       -  val_smmu_init
+           2. Prerequisite -  val_iovirt_create_info_table
+  @param   smmu_index  smmu index in iovirt table
+  @param   *max_sid    highest StreamID mapped to this SMMU
+  @return  Number of StreamIDs mapped to this SMMU, 0 if none found
+**/
+uint32_t
+val_iovirt_get_smmu_sid_range(uint32_t smmu_index, uint32_t *max_sid)
+{
+  uint32_t i, j;
+  uint32_t num_sids = 0;
+  uint32_t smmu_ref;
+  IOVIRT_BLOCK *block;
+  NODE_DATA_MAP *map;
+
+  if (g_iovirt_info_table == NULL || max_sid == NULL)
+      return 0;
+
+  block = (IOVIRT_BLOCK *)val_iovirt_get_smmu_info(SMMU_IOVIRT_BLOCK, smmu_index);
+  if (block == NULL)
+      return 0;
+
+  smmu_ref = (uint32_t)((uint8_t *)block - (uint8_t *)g_iovirt_info_table);
+  *max_sid = 0;
+
+  block = &g_iovirt_info_table->blocks[0];
+  for (i = 0; i < g_iovirt_info_table->num_blocks; i++, block = IOVIRT_NEXT_BLOCK(block))
+  {
+      if (block->type != IOVIRT_NODE_PCI_ROOT_COMPLEX &&
+          block->type != IOVIRT_NODE_NAMED_COMPONENT)
+          continue;
+
+      for (j = 0, map = &block->data_map[0]; j < block->num_data_map; j++, map++)
+      {
+          if ((*map).map.output_ref != smmu_ref)
+              continue;
+
+          /* id_count is inclusive, as in val_iovirt_get_device_info */
+          num_sids += (*map).map.id_count + 1;
+          if ((*map).map.output_base + (*map).map.id_count > *max_sid)
+              *max_sid = (*map).map.output_base + (*map).map.id_count;
+      }
+  }
+
+  return num_sids;
+}
+
 /**
   @brief   This API will call PAL layer to fill in the IO Virt information
            into the g_iovirt_info_table pointer.
@@ -376,7 +758,10 @@ val_iovirt_create_info_table(uint64_t *iovirt_info_table)
 
   g_iovirt_info_table = (IOVIRT_INFO_TABLE *)iovirt_info_table;
 
-  pal_iovirt_create_info_table(g_iovirt_info_table);
+  if (val_snapshot_restore(SNAPSHOT_IOVIRT_INFO, g_iovirt_info_table))
+      pal_iovirt_create_info_table(g_iovirt_info_table);
+
+  val_iovirt_create_rid_index();
 
   num_smmu = val_iovirt_get_smmu_info(SMMU_NUM_CTRL, 0);
   val_print(ACS_PRINT_TEST,
@@ -420,6 +805,13 @@ void
 val_iovirt_free_info_table()
 {
   val_smmu_stop();
+
+  if (g_iovirt_rid_map != NULL) {
+      pal_mem_free((void *)g_iovirt_rid_map);
+      g_iovirt_rid_map = NULL;
+      g_iovirt_rid_map_num = 0;
+  }
+
   pal_mem_free((void *)g_iovirt_info_table);
 }
 
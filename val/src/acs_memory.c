@@ -19,6 +19,25 @@
 #include "include/bsa_acs_peripherals.h"
 #include "include/bsa_acs_memory.h"
 #include "include/bsa_acs_common.h"
+#include "include/bsa_acs_pe.h"
+
+#define MEM_SIMD_BLOCK      64
+#define MEM_SIMD_ALIGN      16
+#define MEM_ENGINE_UNKNOWN  0
+#define MEM_ENGINE_SIMD     1
+#define MEM_ENGINE_SCALAR   2
+
+#define MEM_PATTERN_LINE_WORDS  8
+#define MEM_PATTERN_LINE_BYTES  (MEM_PATTERN_LINE_WORDS * 8)
+#define MEM_PATTERN_LINE_MIX    0x9E3779B97F4A7C15ULL
+#define MEM_PATTERN_LFSR_SEED   0x2545F4914F6CDD1DULL
+
+typedef struct {
+  mem_pattern_t *pattern;
+  uint64_t      state;
+} mem_pattern_gen_t;
+
+static uint32_t g_mem_engine = MEM_ENGINE_UNKNOWN;
 
 
 MEMORY_INFO_TABLE  *g_memory_info_table;
@@ -36,6 +55,12 @@ val_memory_execute_tests(uint32_t num_pe, uint32_t *g_sw_view)
 {
 
   uint32_t status, i;
+#ifndef TARGET_LINUX
+  val_sched_test_t os_tests[] = {
+    {os_m002_entry, TEST_RES_MEMORY | TEST_RES_PRIMARY, 0},
+    {os_m003_entry, TEST_RES_MEMORY, 0}
+  };
+#endif
 
   for (i = 0 ; i < MAX_TEST_SKIP_NUM ; i++) {
       if (g_skip_test_num[i] == ACS_MEMORY_MAP_TEST_BASE) {
@@ -50,8 +75,7 @@ val_memory_execute_tests(uint32_t num_pe, uint32_t *g_sw_view)
       val_print(ACS_PRINT_ERR, "\nOperating System View:\n", 0);
 #ifndef TARGET_LINUX
 //    status |= os_m001_entry(num_pe);
-      status |= os_m002_entry(num_pe);
-      status |= os_m003_entry(num_pe);
+      status |= val_test_sched_run(os_tests, sizeof(os_tests)/sizeof(os_tests[0]), num_pe);
 #else
       status |= os_m004_entry(num_pe);
 #endif
@@ -299,6 +323,145 @@ val_memory_free(void *addr)
   pal_mem_free(addr);
 }
 
+/**
+  @brief  Check once whether the block routines may use AdvSIMD. The Linux
+          kernel module cannot use FP/SIMD registers freely, so it always
+          uses the scalar routines.
+
+  @param  None
+
+  @return 1 if AdvSIMD is implemented, 0 otherwise
+**/
+static uint32_t
+val_memory_use_simd(void)
+{
+#ifndef TARGET_LINUX
+  if (g_mem_engine == MEM_ENGINE_UNKNOWN) {
+      /* ID_AA64PFR0_EL1.AdvSIMD, 0xF means not implemented */
+      if (VAL_EXTRACT_BITS(val_pe_reg_read(ID_AA64PFR0_EL1), 20, 23) == 0xF)
+          g_mem_engine = MEM_ENGINE_SCALAR;
+      else
+          g_mem_engine = MEM_ENGINE_SIMD;
+  }
+
+  return (g_mem_engine == MEM_ENGINE_SIMD);
+#else
+  return 0;
+#endif
+}
+
+/**
+  @brief  Read the naturally aligned 64-bit word of a buffer that holds the
+          byte at offset. Bytes beyond the end of the buffer read as 0.
+
+  @param  buf     Buffer
+  @param  offset  Byte offset
+  @param  len     Length of the buffer
+
+  @return Word value, little endian
+**/
+static uint64_t
+val_memory_word_at(uint8_t *buf, uint64_t offset, uint64_t len)
+{
+  uint64_t base = offset & ~((uint64_t)7);
+  uint64_t data = 0;
+  uint32_t i;
+
+  for (i = 0; (i < 8) && ((base + i) < len); i++)
+      data |= (uint64_t)buf[base + i] << (i * 8);
+
+  return data;
+}
+
+/**
+  @brief  Compare two buffers and report the first difference. Blocks are
+          compared with AdvSIMD when both buffers share 16-byte alignment,
+          otherwise with 64-bit words where possible.
+          1. Caller       -  Test Suite
+          2. Prerequisite -  None
+  @param  *src  Source (expected) Buffer
+  @param  *dest Destination (actual) Buffer
+  @param  len   Length
+  @param  info  First difference: byte offset and the aligned 64-bit words of
+                src and dest holding it. May be NULL.
+
+  @return 0 If contents are same
+  @return 1 Otherwise
+**/
+uint32_t
+val_memory_compare_info(void *src, void *dest, uint64_t len, mem_compare_info_t *info)
+{
+  uint8_t *s = (uint8_t *)src;
+  uint8_t *d = (uint8_t *)dest;
+  uint64_t offset = 0;
+#ifndef TARGET_LINUX
+  uint64_t end;
+  uint64_t blk;
+
+  if (((((addr_t)s) ^ ((addr_t)d)) & (MEM_SIMD_ALIGN - 1)) == 0) {
+      while ((offset < len) && (((addr_t)(s + offset)) & (MEM_SIMD_ALIGN - 1))) {
+          if (s[offset] != d[offset])
+              goto mismatch;
+          offset++;
+      }
+
+      blk = (len - offset) & ~((uint64_t)MEM_SIMD_BLOCK - 1);
+      if (blk && val_memory_use_simd()) {
+          end = offset + MemCompareSimd(s + offset, d + offset, blk);
+          if (end < (offset + blk)) {
+              /* Find the byte within the first differing block */
+              for (offset = end; s[offset] == d[offset]; offset++)
+                  ;
+              goto mismatch;
+          }
+          offset += blk;
+      }
+  }
+#endif
+
+  if (((((addr_t)s) ^ ((addr_t)d)) & 7) == 0) {
+      while ((offset < len) && (((addr_t)(s + offset)) & 7)) {
+          if (s[offset] != d[offset])
+              goto mismatch;
+          offset++;
+      }
+
+      for (; (offset + 8) <= len; offset += 8)
+          if (*(uint64_t *)(s + offset) != *(uint64_t *)(d + offset))
+              break;
+  }
+
+  for (; offset < len; offset++)
+      if (s[offset] != d[offset])
+          goto mismatch;
+
+  return 0;
+
+mismatch:
+  if (info) {
+      info->offset   = offset;
+      info->expected = val_memory_word_at(s, offset, len);
+      info->actual   = val_memory_word_at(d, offset, len);
+  }
+  return 1;
+}
+
+/**
+  @brief  Print the first difference found by val_memory_compare_info
+
+  @param  level  Print level
+  @param  info   Compare result
+
+  @return None
+**/
+void
+val_memory_print_mismatch(uint32_t level, mem_compare_info_t *info)
+{
+  val_print(level, "\n       First mismatch at offset 0x%llx", info->offset);
+  val_print(level, ", expected 0x%llx", info->expected);
+  val_print(level, ", actual 0x%llx", info->actual);
+}
+
 /**
   @brief  Compare two buffers of length len
 
@@ -312,7 +475,12 @@ val_memory_free(void *addr)
 int
 val_memory_compare(void *src, void *dest, uint32_t len)
 {
-  return pal_mem_compare(src, dest, len);
+  mem_compare_info_t info;
+
+  if (val_memory_compare_info(src, dest, len, &info) == 0)
+      return 0;
+
+  return ((uint8_t *)src)[info.offset] - ((uint8_t *)dest)[info.offset];
 }
 
 /**
@@ -327,7 +495,239 @@ val_memory_compare(void *src, void *dest, uint32_t len)
 void
 val_memory_set(void *buf, uint32_t size, uint8_t value)
 {
+#ifndef TARGET_LINUX
+  uint8_t *b = (uint8_t *)buf;
+  uint64_t len = size;
+  uint64_t pattern = value * 0x0101010101010101ULL;
+  uint64_t blk;
+
+  while (len && (((addr_t)b) & (MEM_SIMD_ALIGN - 1))) {
+      *b++ = value;
+      len--;
+  }
+
+  blk = len & ~((uint64_t)MEM_SIMD_BLOCK - 1);
+  if (blk && val_memory_use_simd()) {
+      MemSetSimd(b, blk, value);
+      b += blk;
+      len -= blk;
+  }
+
+  for (; len >= 8; len -= 8, b += 8)
+      *(uint64_t *)b = pattern;
+
+  while (len--)
+      *b++ = value;
+#else
   pal_mem_set(buf, size, value);
+#endif
+}
+
+/**
+  @brief  Copy len bytes from src to dest. Overlapping buffers are left to
+          the PAL copy, which handles them.
+
+  @param  *dest Destination Buffer
+  @param  *src  Source Buffer
+  @param  len   Length
+
+  @return dest
+**/
+void *
+val_memory_copy(void *dest, void *src, uint32_t len)
+{
+#ifndef TARGET_LINUX
+  uint8_t *d = (uint8_t *)dest;
+  uint8_t *s = (uint8_t *)src;
+  uint64_t blk;
+
+  if (((s < d) && ((s + len) > d)) || ((d < s) && ((d + len) > s)))
+      return pal_memcpy(dest, src, len);
+
+  while (len && (((addr_t)d) & (MEM_SIMD_ALIGN - 1))) {
+      *d++ = *s++;
+      len--;
+  }
+
+  if ((((addr_t)s) & (MEM_SIMD_ALIGN - 1)) == 0) {
+      blk = len & ~((uint64_t)MEM_SIMD_BLOCK - 1);
+      if (blk && val_memory_use_simd()) {
+          MemCopySimd(d, s, blk);
+          d += blk;
+          s += blk;
+          len -= blk;
+      }
+
+      for (; len >= 8; len -= 8, d += 8, s += 8)
+          *(uint64_t *)d = *(uint64_t *)s;
+  }
+
+  while (len--)
+      *d++ = *s++;
+
+  return dest;
+#else
+  return pal_memcpy(dest, src, len);
+#endif
+}
+
+/**
+  @brief  Next 64-bit word of a data pattern. Words are generated in order
+          from the start of the buffer, which the LFSR pattern relies on.
+
+  @param  gen   Generator state
+  @param  word  Index of the word in the buffer
+
+  @return Pattern word
+**/
+static uint64_t
+val_memory_pattern_next(mem_pattern_gen_t *gen, uint64_t word)
+{
+  mem_pattern_t *pattern = gen->pattern;
+  uint64_t x;
+
+  switch (pattern->type) {
+  case MEM_PATTERN_ADDRESS:
+      return (pattern->base + (word << 3)) ^ pattern->seed;
+  case MEM_PATTERN_WALKING_ONES:
+      return 1ULL << ((word + pattern->seed) & 63);
+  case MEM_PATTERN_LFSR:
+      x = gen->state;
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+      gen->state = x;
+      return x;
+  default:
+      /* The tag is the seed and the line number of the bus address, so the
+         same buffer at another address or in another transfer differs. Word
+         0 of each line is the tag itself, the others are derived from it so
+         that a line moved as a whole is still detected */
+      x = (pattern->base / MEM_PATTERN_LINE_BYTES) + (word / MEM_PATTERN_LINE_WORDS);
+      return ((pattern->seed << 32) | (x & 0xFFFFFFFF)) ^
+             ((word % MEM_PATTERN_LINE_WORDS) * MEM_PATTERN_LINE_MIX);
+  }
+}
+
+/**
+  @brief  Start generating a pattern from the first word of the buffer
+
+  @param  gen      Generator state to initialize
+  @param  pattern  Pattern description
+
+  @return None
+**/
+static void
+val_memory_pattern_start(mem_pattern_gen_t *gen, mem_pattern_t *pattern)
+{
+  gen->pattern = pattern;
+  gen->state   = pattern->seed ? pattern->seed : MEM_PATTERN_LFSR_SEED;
+}
+
+/**
+  @brief  Fill a buffer with a data pattern in a single pass. The pattern
+          is defined over 64-bit words from the start of the buffer, a
+          partial last word takes the low bytes of the pattern word.
+          1. Caller       -  Test Suite
+          2. Prerequisite -  None
+  @param  buf      Buffer to fill
+  @param  len      Length in bytes
+  @param  pattern  Pattern description
+
+  @return None
+**/
+void
+val_memory_pattern_fill(void *buf, uint64_t len, mem_pattern_t *pattern)
+{
+  mem_pattern_gen_t gen;
+  uint8_t *b = (uint8_t *)buf;
+  uint64_t value;
+  uint64_t word;
+  uint64_t i;
+  uint32_t aligned;
+
+  val_memory_pattern_start(&gen, pattern);
+  aligned = ((((addr_t)b) & 7) == 0);
+
+  for (word = 0; ((word << 3) + 8) <= len; word++) {
+      value = val_memory_pattern_next(&gen, word);
+      if (aligned) {
+          *(uint64_t *)(b + (word << 3)) = value;
+          continue;
+      }
+
+      for (i = 0; i < 8; i++)
+          b[(word << 3) + i] = (uint8_t)(value >> (i * 8));
+  }
+
+  if ((word << 3) < len) {
+      value = val_memory_pattern_next(&gen, word);
+      for (i = word << 3; i < len; i++)
+          b[i] = (uint8_t)(value >> ((i & 7) * 8));
+  }
+}
+
+/**
+  @brief  Check a buffer against the data pattern it was filled with, in a
+          single pass and without a reference buffer.
+          1. Caller       -  Test Suite
+          2. Prerequisite -  None
+  @param  buf      Buffer to check
+  @param  len      Length in bytes
+  @param  pattern  Pattern the buffer is expected to hold
+  @param  info     Filled with the first difference, expected being the
+                   pattern word and actual the buffer word holding it.
+                   May be NULL.
+
+  @return 0 if the buffer holds the pattern, 1 otherwise
+**/
+uint32_t
+val_memory_pattern_verify(void *buf, uint64_t len, mem_pattern_t *pattern,
+                          mem_compare_info_t *info)
+{
+  mem_pattern_gen_t gen;
+  uint8_t *b = (uint8_t *)buf;
+  uint64_t expected;
+  uint64_t actual;
+  uint64_t word;
+  uint64_t end;
+  uint64_t i;
+  uint32_t aligned;
+
+  val_memory_pattern_start(&gen, pattern);
+  aligned = ((((addr_t)b) & 7) == 0);
+
+  for (word = 0; (word << 3) < len; word++) {
+      expected = val_memory_pattern_next(&gen, word);
+      end = ((word << 3) + 8) <= len ? 8 : (len & 7);
+
+      if (aligned && (end == 8)) {
+          actual = *(uint64_t *)(b + (word << 3));
+      } else {
+          actual = 0;
+          for (i = 0; i < end; i++)
+              actual |= (uint64_t)b[(word << 3) + i] << (i * 8);
+          if (end < 8)
+              expected &= (1ULL << (end * 8)) - 1;
+      }
+
+      if (actual == expected)
+          continue;
+
+      for (i = 0; ((expected ^ actual) >> (i * 8) & 0xFF) == 0; i++)
+          ;
+
+      if (info) {
+          info->offset   = (word << 3) + i;
+          info->expected = expected;
+          info->actual   = actual;
+      }
+      return 1;
+  }
+
+  if (info)
+      info->offset = len;
+  return 0;
 }
 
 /**
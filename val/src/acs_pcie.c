@@ -17,6 +17,7 @@
 
 #include "include/bsa_acs_val.h"
 #include "include/bsa_acs_common.h"
+#include "include/bsa_acs_memory.h"
 
 #include "include/bsa_acs_pcie.h"
 #include "sys_arch_src/pcie/pcie.h"
@@ -28,19 +29,74 @@ pcie_device_bdf_table *g_pcie_bdf_table;
 uint64_t
 pal_get_mcfg_ptr(void);
 
+/* Config space shadow.
+
+   While enabled, every function read through VAL gets a copy of its 4KB
+   config space, filled one dword at a time on first read. A dword is served
+   from the copy only once it is known to be read-only as a whole: the ID,
+   class code and capability pointer dwords of the header, capability
+   headers of the extended list and the capability registers of the PCI
+   Express capability, marked as val_pcie_find_capability walks the lists.
+   Command/status, control/status and every other register keep going to
+   ECAM. val_pcie_read_cfg_ro also lets VAL use the read-only fields of a mixed
+   dword, such as the header type, from the copy. A write drops the dword it
+   touches so the next read returns what the function actually kept. FLR
+   drops the whole function and bus number writes drop every function.
+
+   Only VAL helpers and val_pcie_read_cfg_ro read through the shadow.
+   val_pcie_read_cfg always goes to ECAM, since tests use it to check
+   presence and to generate config transactions. */
+
+#define PCIE_SHADOW_HASH_SIZE   64
+#define PCIE_SHADOW_MAX_FUNC    256
+#define PCIE_CFG_DWORDS         (PCIE_CFG_SIZE / 4)
+#define PCIE_SHADOW_MAP_WORDS   (PCIE_CFG_DWORDS / 32)
+
+#define PCIE_SHADOW_HASH(bdf)   (((bdf) ^ ((bdf) >> 8) ^ ((bdf) >> 16) ^ ((bdf) >> 24)) & \
+                                 (PCIE_SHADOW_HASH_SIZE - 1))
+#define PCIE_SHADOW_TEST(map, dw)  ((map)[(dw) >> 5] & (1U << ((dw) & 0x1F)))
+#define PCIE_SHADOW_SET(map, dw)   ((map)[(dw) >> 5] |= (1U << ((dw) & 0x1F)))
+#define PCIE_SHADOW_CLEAR(map, dw) ((map)[(dw) >> 5] &= ~(1U << ((dw) & 0x1F)))
+
+typedef enum {
+  PCIE_SHADOW_READ = 0,         ///< Serve only dwords known to be read-only
+  PCIE_SHADOW_READ_RO_DWORD,    ///< Caller knows the whole dword is read-only
+  PCIE_SHADOW_READ_RO_FIELDS    ///< Caller only uses read-only fields of the dword
+} PCIE_SHADOW_READ_e;
+
+typedef struct pcie_shadow {
+  struct pcie_shadow *next;
+  uint32_t bdf;
+  uint32_t ro[PCIE_SHADOW_MAP_WORDS];     ///< Dwords read-only as a whole
+  uint32_t valid[PCIE_SHADOW_MAP_WORDS];  ///< Dwords held in data
+  uint32_t data[PCIE_CFG_DWORDS];
+} pcie_shadow_t;
+
+typedef struct {
+  uint64_t hits;
+  uint64_t fills;
+  uint64_t bypass;
+  uint64_t drops;           ///< Dwords dropped by writes
+  uint64_t fill_ticks;      ///< Counter ticks spent in the ECAM reads of fills
+} pcie_shadow_stats_t;
+
+static uint32_t            g_pcie_shadow_enabled;
+static uint32_t            g_pcie_shadow_num;
+static pcie_shadow_t       *g_pcie_shadow[PCIE_SHADOW_HASH_SIZE];
+static pcie_shadow_stats_t g_pcie_shadow_stats;
+
 /**
-  @brief   This API reads 32-bit data from PCIe config space pointed by Bus,
-           Device, Function and register offset.
-           1. Caller       -  Test Suite
-           2. Prerequisite -  val_pcie_create_info_table
+  @brief   Reads 32-bit data from the ECAM of the function, bypassing the
+           config space shadow
+
   @param   bdf    - concatenated Bus(8-bits), device(8-bits) & function(8-bits)
   @param   offset - Register offset within a device PCIe config space
   @param   *data  - 32-bit data read from the config space
 
   @return  success/failure
 **/
-uint32_t
-val_pcie_read_cfg(uint32_t bdf, uint32_t offset, uint32_t *data)
+static uint32_t
+val_pcie_ecam_read_cfg(uint32_t bdf, uint32_t offset, uint32_t *data)
 {
   uint32_t bus     = PCIE_EXTRACT_BDF_BUS(bdf);
   uint32_t dev     = PCIE_EXTRACT_BDF_DEV(bdf);
@@ -61,6 +117,8 @@ val_pcie_read_cfg(uint32_t bdf, uint32_t offset, uint32_t *data)
       return PCIE_NO_MAPPING;
   }
 
+  val_profile_region_enter(PROFILE_REGION_CFG_READ);
+
   while (i < val_pcie_get_info(PCIE_INFO_NUM_ECAM, 0))
   {
 
@@ -76,6 +134,7 @@ val_pcie_read_cfg(uint32_t bdf, uint32_t offset, uint32_t *data)
   if (ecam_base == 0) {
       val_print(ACS_PRINT_ERR, "\n       Read PCIe_CFG: ECAM Base is zero   "
                                                         "   ", 0);
+      val_profile_region_exit(PROFILE_REGION_CFG_READ);
       return PCIE_NO_MAPPING;
   }
 
@@ -87,10 +146,422 @@ val_pcie_read_cfg(uint32_t bdf, uint32_t offset, uint32_t *data)
     "\n       Calculated config address is %lx", ecam_base + cfg_addr + offset);
 
   *data = pal_mmio_read(ecam_base + cfg_addr + offset);
+  val_profile_region_exit(PROFILE_REGION_CFG_READ);
   return 0;
 
 }
 
+/**
+  @brief   Find the shadow of a function
+
+  @param   bdf  - Segment/Bus/Dev/Func in the format of PCIE_CREATE_BDF
+
+  @return  Shadow, NULL if the function has none
+**/
+static pcie_shadow_t *
+val_pcie_shadow_find(uint32_t bdf)
+{
+  pcie_shadow_t *entry;
+
+  for (entry = g_pcie_shadow[PCIE_SHADOW_HASH(bdf)]; entry; entry = entry->next)
+      if (entry->bdf == bdf)
+          return entry;
+
+  return NULL;
+}
+
+/**
+  @brief   Check whether a header dword is read-only as a whole
+
+  @param   offset - Dword aligned offset within the config space
+
+  @return  1 if read-only, 0 otherwise
+**/
+static uint32_t
+val_pcie_shadow_header_ro(uint32_t offset)
+{
+  return (offset == TYPE01_VIDR) || (offset == TYPE01_RIDR) || (offset == TYPE01_CPR);
+}
+
+/**
+  @brief   Create the shadow of a function
+
+  @param   bdf  - Segment/Bus/Dev/Func in the format of PCIE_CREATE_BDF
+
+  @return  Shadow, NULL if it could not be allocated
+**/
+static pcie_shadow_t *
+val_pcie_shadow_create(uint32_t bdf)
+{
+  pcie_shadow_t *entry;
+
+  if (g_pcie_shadow_num >= PCIE_SHADOW_MAX_FUNC)
+      return NULL;
+
+  entry = (pcie_shadow_t *)pal_mem_alloc(sizeof(pcie_shadow_t));
+  if (entry == NULL)
+      return NULL;
+
+  val_memory_set(entry->ro, sizeof(entry->ro), 0);
+  val_memory_set(entry->valid, sizeof(entry->valid), 0);
+  PCIE_SHADOW_SET(entry->ro, TYPE01_VIDR >> 2);
+  PCIE_SHADOW_SET(entry->ro, TYPE01_RIDR >> 2);
+  PCIE_SHADOW_SET(entry->ro, TYPE01_CPR >> 2);
+
+  entry->bdf = bdf;
+  entry->next = g_pcie_shadow[PCIE_SHADOW_HASH(bdf)];
+  g_pcie_shadow[PCIE_SHADOW_HASH(bdf)] = entry;
+  g_pcie_shadow_num++;
+
+  return entry;
+}
+
+/**
+  @brief   Read a config space dword through the shadow
+
+  @param   bdf    - Segment/Bus/Dev/Func in the format of PCIE_CREATE_BDF
+  @param   offset - Register offset within a device PCIe config space
+  @param   *data  - 32-bit data read from the config space
+  @param   mode   - PCIE_SHADOW_READ_e
+
+  @return  success/failure
+**/
+static uint32_t
+val_pcie_shadow_read(uint32_t bdf, uint32_t offset, uint32_t *data, uint32_t mode)
+{
+  pcie_shadow_t *entry;
+  uint32_t dword = offset >> 2;
+  uint32_t status;
+  uint64_t start = 0;
+
+  if ((offset & WORD_ALIGN_MASK) || (offset >= PCIE_CFG_SIZE))
+      return val_pcie_ecam_read_cfg(bdf, offset, data);
+
+  entry = val_pcie_shadow_find(bdf);
+  if (entry && PCIE_SHADOW_TEST(entry->valid, dword) &&
+      ((mode != PCIE_SHADOW_READ) || PCIE_SHADOW_TEST(entry->ro, dword))) {
+      g_pcie_shadow_stats.hits++;
+      *data = entry->data[dword];
+      return 0;
+  }
+
+  if ((mode == PCIE_SHADOW_READ) &&
+      !(entry ? PCIE_SHADOW_TEST(entry->ro, dword) : val_pcie_shadow_header_ro(offset))) {
+      g_pcie_shadow_stats.bypass++;
+      return val_pcie_ecam_read_cfg(bdf, offset, data);
+  }
+
+#ifndef TARGET_LINUX
+  start = val_timer_get_counter();
+#endif
+  status = val_pcie_ecam_read_cfg(bdf, offset, data);
+#ifndef TARGET_LINUX
+  g_pcie_shadow_stats.fill_ticks += val_timer_get_counter() - start;
+#else
+  (void)start;
+#endif
+
+  /* Never hold the response of a missing function or a failed read */
+  if (status || (*data == PCIE_UNKNOWN_RESPONSE))
+      return status;
+
+  if (entry == NULL)
+      entry = val_pcie_shadow_create(bdf);
+  if (entry == NULL)
+      return 0;
+
+  entry->data[dword] = *data;
+  PCIE_SHADOW_SET(entry->valid, dword);
+  if (mode == PCIE_SHADOW_READ_RO_DWORD)
+      PCIE_SHADOW_SET(entry->ro, dword);
+  g_pcie_shadow_stats.fills++;
+
+  return 0;
+}
+
+/**
+  @brief   Read config space, through the shadow when it is enabled
+
+  @param   bdf    - Segment/Bus/Dev/Func in the format of PCIE_CREATE_BDF
+  @param   offset - Register offset within a device PCIe config space
+  @param   *data  - 32-bit data read from the config space
+  @param   mode   - PCIE_SHADOW_READ_e
+
+  @return  success/failure
+**/
+static uint32_t
+val_pcie_read_cfg_mode(uint32_t bdf, uint32_t offset, uint32_t *data, uint32_t mode)
+{
+  if (g_pcie_shadow_enabled)
+      return val_pcie_shadow_read(bdf, offset, data, mode);
+
+  return val_pcie_ecam_read_cfg(bdf, offset, data);
+}
+
+/**
+  @brief   Read config space for VAL, from the shadow for dwords known to be
+           read-only as a whole
+
+  @param   bdf    - Segment/Bus/Dev/Func in the format of PCIE_CREATE_BDF
+  @param   offset - Register offset within a device PCIe config space
+  @param   *data  - 32-bit data read from the config space
+
+  @return  success/failure
+**/
+static uint32_t
+val_pcie_read_cfg_shadow(uint32_t bdf, uint32_t offset, uint32_t *data)
+{
+  return val_pcie_read_cfg_mode(bdf, offset, data, PCIE_SHADOW_READ);
+}
+
+/**
+  @brief   Mark the capability registers of a PCI Express capability as
+           read-only in the shadow of the function
+
+  @param   bdf         - Segment/Bus/Dev/Func in the format of PCIE_CREATE_BDF
+  @param   pciecs_base - Offset of the PCI Express capability
+
+  @return  None
+**/
+static void
+val_pcie_shadow_mark_pciecs(uint32_t bdf, uint32_t pciecs_base)
+{
+  pcie_shadow_t *entry;
+
+  entry = val_pcie_shadow_find(bdf);
+  if (entry == NULL)
+      return;
+
+  PCIE_SHADOW_SET(entry->ro, (pciecs_base + CIDR_OFFSET) >> 2);
+  PCIE_SHADOW_SET(entry->ro, (pciecs_base + DCAPR_OFFSET) >> 2);
+  PCIE_SHADOW_SET(entry->ro, (pciecs_base + LCAPR_OFFSET) >> 2);
+  PCIE_SHADOW_SET(entry->ro, (pciecs_base + SCAPR_OFFSET) >> 2);
+  PCIE_SHADOW_SET(entry->ro, (pciecs_base + DCAP2R_OFFSET) >> 2);
+  PCIE_SHADOW_SET(entry->ro, (pciecs_base + LCAP2R_OFFSET) >> 2);
+}
+
+/**
+  @brief   Drop the dword a config space write went to from the shadow
+
+  @param   bdf    - Segment/Bus/Dev/Func in the format of PCIE_CREATE_BDF
+  @param   offset - Register offset written
+
+  @return  None
+**/
+static void
+val_pcie_shadow_drop(uint32_t bdf, uint32_t offset)
+{
+  pcie_shadow_t *entry;
+
+  entry = val_pcie_shadow_find(bdf);
+  if ((entry == NULL) || (offset >= PCIE_CFG_SIZE))
+      return;
+
+  if (PCIE_SHADOW_TEST(entry->valid, offset >> 2)) {
+      PCIE_SHADOW_CLEAR(entry->valid, offset >> 2);
+      g_pcie_shadow_stats.drops++;
+  }
+}
+
+/**
+  @brief   Drop the shadow of one function, or of every function. Needed when
+           a function may come back different, for example after its bus
+           numbers were reprogrammed.
+           1. Caller       -  Test Suite, VAL
+           2. Prerequisite -  None
+  @param   bdf   - Segment/Bus/Dev/Func in the format of PCIE_CREATE_BDF,
+                   PCIE_SHADOW_ALL for every function
+  @return  None
+**/
+void
+val_pcie_shadow_invalidate(uint32_t bdf)
+{
+  pcie_shadow_t **link;
+  pcie_shadow_t *entry;
+  uint32_t i;
+
+  for (i = 0; i < PCIE_SHADOW_HASH_SIZE; i++) {
+      if ((bdf != PCIE_SHADOW_ALL) && (i != PCIE_SHADOW_HASH(bdf)))
+          continue;
+
+      link = &g_pcie_shadow[i];
+      while ((entry = *link) != NULL) {
+          if ((bdf != PCIE_SHADOW_ALL) && (entry->bdf != bdf)) {
+              link = &entry->next;
+              continue;
+          }
+
+          *link = entry->next;
+          pal_mem_free(entry);
+          g_pcie_shadow_num--;
+      }
+  }
+}
+
+/**
+  @brief   Keep the shadow in step with a config space write. Drops the dword
+           written, the whole function on FLR and every function when the
+           bus numbers of a bridge change, since the functions below it may
+           now answer at other BDFs.
+
+  @param   bdf    - Segment/Bus/Dev/Func in the format of PCIE_CREATE_BDF
+  @param   offset - Register offset written
+  @param   data   - Value written
+
+  @return  None
+**/
+static void
+val_pcie_shadow_write(uint32_t bdf, uint32_t offset, uint32_t data)
+{
+  uint32_t reg_value;
+  uint32_t pciecs_base;
+
+  if ((offset & ~WORD_ALIGN_MASK) == TYPE1_PBN) {
+      val_pcie_read_cfg_ro(bdf, TYPE01_CLSR, &reg_value);
+      if (((reg_value >> TYPE01_HTR_SHIFT) & TYPE01_HTR_MASK) == TYPE1_HEADER) {
+          val_pcie_shadow_invalidate(PCIE_SHADOW_ALL);
+          return;
+      }
+  }
+
+  if ((val_pcie_find_capability(bdf, PCIE_CAP, CID_PCIECS, &pciecs_base) == PCIE_SUCCESS) &&
+      ((offset & ~WORD_ALIGN_MASK) == pciecs_base + DCTLR_OFFSET) &&
+      ((data >> DCTLR_IFLR_SHIFT) & DCTLR_IFLR_MASK)) {
+      val_pcie_shadow_invalidate(bdf);
+      return;
+  }
+
+  val_pcie_shadow_drop(bdf, offset);
+}
+
+/**
+  @brief   Enable or disable the config space shadow. Disabling drops every
+           shadow and clears the statistics.
+           1. Caller       -  Application layer
+           2. Prerequisite -  val_pcie_create_info_table
+  @param   enable  - 1 to enable, 0 to disable
+  @return  None
+**/
+void
+val_pcie_shadow_enable(uint32_t enable)
+{
+  if (!enable) {
+      val_pcie_shadow_invalidate(PCIE_SHADOW_ALL);
+      val_memory_set(&g_pcie_shadow_stats, sizeof(g_pcie_shadow_stats), 0);
+  }
+
+  g_pcie_shadow_enabled = enable;
+}
+
+/**
+  @brief   Stop using the config space shadow until val_pcie_shadow_resume.
+           Drops every shadow, since writes are not tracked meanwhile, but
+           keeps the statistics. Lets PCIe reads run on secondary PEs, where
+           the shadow may neither allocate nor change its lists.
+           1. Caller       -  VAL, val_test_sched_run
+           2. Prerequisite -  None
+  @param   None
+  @return  1 if the shadow was enabled, 0 otherwise
+**/
+uint32_t
+val_pcie_shadow_suspend(void)
+{
+  uint32_t enabled = g_pcie_shadow_enabled;
+
+  if (enabled) {
+      g_pcie_shadow_enabled = 0;
+      val_pcie_shadow_invalidate(PCIE_SHADOW_ALL);
+  }
+
+  return enabled;
+}
+
+/**
+  @brief   Use the config space shadow again after val_pcie_shadow_suspend
+           1. Caller       -  VAL, val_test_sched_run
+           2. Prerequisite -  val_pcie_shadow_suspend
+  @param   enabled  - Value returned by val_pcie_shadow_suspend
+  @return  None
+**/
+void
+val_pcie_shadow_resume(uint32_t enabled)
+{
+  g_pcie_shadow_enabled = enabled;
+}
+
+/**
+  @brief   Print the hit rate of the config space shadow and an estimate of
+           the time it saved, from the average ECAM read time of its fills
+           1. Caller       -  Application layer
+           2. Prerequisite -  val_pcie_shadow_enable
+  @param   None
+  @return  None
+**/
+void
+val_pcie_shadow_report(void)
+{
+  uint64_t lookups;
+  uint64_t saved;
+
+  if (!g_pcie_shadow_enabled)
+      return;
+
+  lookups = g_pcie_shadow_stats.hits + g_pcie_shadow_stats.fills + g_pcie_shadow_stats.bypass;
+  val_print(ACS_PRINT_TEST, "\n     Config space shadow: %d functions", g_pcie_shadow_num);
+  val_print(ACS_PRINT_TEST, ", %d reads", lookups);
+  val_print(ACS_PRINT_TEST, ", %d hits", g_pcie_shadow_stats.hits);
+  val_print(ACS_PRINT_TEST, ", %d fills", g_pcie_shadow_stats.fills);
+  val_print(ACS_PRINT_TEST, ", %d bypassed", g_pcie_shadow_stats.bypass);
+  val_print(ACS_PRINT_TEST, ", %d dropped by writes", g_pcie_shadow_stats.drops);
+  if (lookups)
+      val_print(ACS_PRINT_TEST, "\n     Hit rate %d%%",
+                (g_pcie_shadow_stats.hits * 100) / lookups);
+
+  if (g_pcie_shadow_stats.fills) {
+      saved = (g_pcie_shadow_stats.fill_ticks / g_pcie_shadow_stats.fills) *
+              g_pcie_shadow_stats.hits;
+      val_print(ACS_PRINT_TEST, ", ECAM read 0x%llx ticks",
+                g_pcie_shadow_stats.fill_ticks / g_pcie_shadow_stats.fills);
+      val_print(ACS_PRINT_TEST, ", saved 0x%llx ticks", saved);
+  }
+  val_print(ACS_PRINT_TEST, "\n", 0);
+}
+
+/**
+  @brief   This API reads 32-bit data from PCIe config space pointed by Bus,
+           Device, Function and register offset.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_pcie_create_info_table
+  @param   bdf    - concatenated Bus(8-bits), device(8-bits) & function(8-bits)
+  @param   offset - Register offset within a device PCIe config space
+  @param   *data  - 32-bit data read from the config space
+
+  @return  success/failure
+**/
+uint32_t
+val_pcie_read_cfg(uint32_t bdf, uint32_t offset, uint32_t *data)
+{
+  return val_pcie_ecam_read_cfg(bdf, offset, data);
+}
+
+/**
+  @brief   Reads 32-bit data from PCIe config space for a caller that only uses
+           read-only fields of the dword. The dword may come from the config
+           space shadow, in which case its other fields can be stale.
+           1. Caller       -  Test Suite, VAL
+           2. Prerequisite -  val_pcie_create_info_table
+  @param   bdf    - concatenated Bus(8-bits), device(8-bits) & function(8-bits)
+  @param   offset - Register offset within a device PCIe config space
+  @param   *data  - 32-bit data read from the config space
+
+  @return  success/failure
+**/
+uint32_t
+val_pcie_read_cfg_ro(uint32_t bdf, uint32_t offset, uint32_t *data)
+{
+  return val_pcie_read_cfg_mode(bdf, offset, data, PCIE_SHADOW_READ_RO_FIELDS);
+}
+
 /**
   @brief   Read 32bit data  from PCIe config space pointed by Bus,
            Device, Function and offset using UEFI PciIoProtocol interface
@@ -163,6 +634,9 @@ val_pcie_write_cfg(uint32_t bdf, uint32_t offset, uint32_t data)
                (dev * PCIE_MAX_FUNC * 4096) + (func * 4096);
 
   pal_mmio_write(ecam_base + cfg_addr + offset, data);
+
+  if (g_pcie_shadow_enabled)
+      val_pcie_shadow_write(bdf, offset, data);
 }
 
 /**
@@ -267,6 +741,45 @@ val_pcie_execute_tests(uint32_t num_pe, uint32_t *g_sw_view)
 {
   uint32_t status, i;
   uint32_t num_ecam = 0;
+#ifndef TARGET_LINUX
+  /* Register bitfield checks disable error reporting, so they own PCIe */
+  val_sched_test_t os_tests[] = {
+    {os_p002_entry, TEST_RES_PCIE, 0},
+    {os_p003_entry, TEST_RES_PCIE, 0},
+    {os_p004_entry, TEST_RES_PCIE | TEST_RES_PRIMARY, TEST_RES_PCIE},
+    {os_p005_entry, TEST_RES_PCIE, 0},
+    {os_p006_entry, TEST_RES_PCIE | TEST_RES_GIC | TEST_RES_PRIMARY, 0},
+    {os_p008_entry, TEST_RES_PCIE, 0},
+    {os_p009_entry, TEST_RES_PCIE, 0},
+    {os_p010_entry, TEST_RES_PCIE, TEST_RES_PCIE},
+    {os_p011_entry, TEST_RES_PCIE, TEST_RES_PCIE},
+    {os_p012_entry, TEST_RES_PCIE, 0},
+    {os_p013_entry, TEST_RES_PCIE, 0},
+    {os_p014_entry, TEST_RES_PCIE, 0},
+    {os_p015_entry, TEST_RES_PCIE, 0},
+    {os_p016_entry, TEST_RES_PCIE, 0},
+    {os_p017_entry, TEST_RES_PCIE, 0},
+    {os_p018_entry, TEST_RES_PCIE, 0},
+    {os_p019_entry, TEST_RES_PCIE, 0},
+    {os_p020_entry, TEST_RES_PCIE, TEST_RES_PCIE},
+    {os_p021_entry, TEST_RES_PCIE, TEST_RES_PCIE},
+    {os_p022_entry, TEST_RES_PCIE, TEST_RES_PCIE},
+    {os_p023_entry, TEST_RES_PCIE, TEST_RES_PCIE},
+    {os_p024_entry, TEST_RES_PCIE, TEST_RES_PCIE},
+    {os_p025_entry, TEST_RES_PCIE, TEST_RES_PCIE},
+    {os_p026_entry, TEST_RES_PCIE, TEST_RES_PCIE},
+    {os_p027_entry, TEST_RES_PCIE, TEST_RES_PCIE},
+    {os_p028_entry, TEST_RES_PCIE, TEST_RES_PCIE},
+    {os_p029_entry, TEST_RES_PCIE, TEST_RES_PCIE},
+    {os_p030_entry, TEST_RES_PCIE | TEST_RES_PRIMARY, TEST_RES_PCIE},
+    {os_p031_entry, TEST_RES_PCIE, 0},
+    {os_p032_entry, TEST_RES_PCIE, 0},
+    {os_p033_entry, TEST_RES_PCIE, 0},
+    {os_p034_entry, TEST_RES_PCIE, 0},
+    {os_p035_entry, TEST_RES_PCIE | TEST_RES_PRIMARY, TEST_RES_PCIE},
+    {os_p036_entry, TEST_RES_PCIE, TEST_RES_PCIE}
+  };
+#endif
 
   status = ACS_STATUS_PASS;
 
@@ -309,41 +822,12 @@ val_pcie_execute_tests(uint32_t num_pe, uint32_t *g_sw_view)
       status |= os_p065_entry(num_pe);
       status |= os_p066_entry(num_pe);
 #else
-      status |= os_p002_entry(num_pe);
-      status |= os_p003_entry(num_pe);
-      status |= os_p004_entry(num_pe);
-      status |= os_p005_entry(num_pe);
-      status |= os_p006_entry(num_pe);
-      status |= os_p008_entry(num_pe);
-      status |= os_p009_entry(num_pe);
-      status |= os_p010_entry(num_pe);
-      status |= os_p011_entry(num_pe);
-      status |= os_p012_entry(num_pe);
-      status |= os_p013_entry(num_pe);
-      status |= os_p014_entry(num_pe);
-      status |= os_p015_entry(num_pe);
-      status |= os_p016_entry(num_pe);
-      status |= os_p017_entry(num_pe);
-      status |= os_p018_entry(num_pe);
-      status |= os_p019_entry(num_pe);
-      status |= os_p020_entry(num_pe);
-      status |= os_p021_entry(num_pe);
-      status |= os_p022_entry(num_pe);
-      status |= os_p023_entry(num_pe);
-      status |= os_p024_entry(num_pe);
-      status |= os_p025_entry(num_pe);
-      status |= os_p026_entry(num_pe);
-      status |= os_p027_entry(num_pe);
-      status |= os_p028_entry(num_pe);
-      status |= os_p029_entry(num_pe);
-      status |= os_p030_entry(num_pe);
-      status |= os_p031_entry(num_pe);
-      status |= os_p032_entry(num_pe);
-      status |= os_p033_entry(num_pe);
-      status |= os_p034_entry(num_pe);
-      status |= os_p035_entry(num_pe);
-      status |= os_p036_entry(num_pe);
-
+      /* The scheduler turns the shadow off, run in order to keep it */
+      if (g_pcie_shadow_enabled) {
+          for (i = 0; i < sizeof(os_tests)/sizeof(os_tests[0]); i++)
+              status |= os_tests[i].entry(num_pe);
+      } else
+          status |= val_test_sched_run(os_tests, sizeof(os_tests)/sizeof(os_tests[0]), num_pe);
 #endif
 
   }
@@ -438,7 +922,7 @@ val_pcie_print_device_info(void)
           dev_num  = PCIE_EXTRACT_BDF_DEV(bdf);
           func_num = PCIE_EXTRACT_BDF_FUNC(bdf);
 
-          val_pcie_read_cfg(bdf, TYPE01_VIDR, &reg_value);
+          val_pcie_read_cfg_shadow(bdf, TYPE01_VIDR, &reg_value);
           device_id = (reg_value >> TYPE01_DIDR_SHIFT) & TYPE01_DIDR_MASK;
           vendor_id = (reg_value >> TYPE01_VIDR_SHIFT) & TYPE01_VIDR_MASK;
 
@@ -534,6 +1018,132 @@ static uint32_t val_pcie_populate_device_rootport(void)
   return 0;
 }
 
+/**
+  @brief   Count the PCIe functions the bus scan of
+           val_pcie_create_device_bdf_table would list, looking only at
+           populated buses: the first bus of each ECAM, the buses of the
+           restored table and the buses behind every bridge found.
+
+  @param   count  Number of functions found
+
+  @return  0 if Success, 1 on a BDF mapping issue
+**/
+static uint32_t val_pcie_count_live_functions(uint32_t *count)
+{
+  uint32_t bus_map[PCIE_MAX_BUS / 32];
+  uint32_t num_ecam, ecam_index, seg_num, start_bus, end_bus;
+  uint32_t bus_index, dev_index, func_index, tbl_index;
+  uint32_t bdf, reg_value, sec_bus, sub_bus, cid_offset;
+
+  *count = 0;
+  num_ecam = val_pcie_get_info(PCIE_INFO_NUM_ECAM, 0);
+
+  for (ecam_index = 0; ecam_index < num_ecam; ecam_index++)
+  {
+      seg_num = val_pcie_get_info(PCIE_INFO_SEGMENT, ecam_index);
+      start_bus = val_pcie_get_info(PCIE_INFO_START_BUS, ecam_index);
+      end_bus = val_pcie_get_info(PCIE_INFO_END_BUS, ecam_index);
+
+      val_memory_set(bus_map, sizeof(bus_map), 0);
+      bus_map[start_bus / 32] |= 1u << (start_bus % 32);
+
+      for (tbl_index = 0; tbl_index < g_pcie_bdf_table->num_entries; tbl_index++)
+      {
+          bdf = g_pcie_bdf_table->device[tbl_index].bdf;
+          bus_index = PCIE_EXTRACT_BDF_BUS(bdf);
+          if ((PCIE_EXTRACT_BDF_SEG(bdf) == seg_num) &&
+              (bus_index >= start_bus) && (bus_index <= end_bus))
+              bus_map[bus_index / 32] |= 1u << (bus_index % 32);
+      }
+
+      /* Buses behind a bridge are numbered above it, so one ascending pass
+         reaches the whole hierarchy */
+      for (bus_index = start_bus; bus_index <= end_bus; bus_index++)
+      {
+          if (!(bus_map[bus_index / 32] & (1u << (bus_index % 32))))
+              continue;
+
+          for (dev_index = 0; dev_index < PCIE_MAX_DEV; dev_index++)
+          {
+              for (func_index = 0; func_index < PCIE_MAX_FUNC; func_index++)
+              {
+                  bdf = PCIE_CREATE_BDF(seg_num, bus_index, dev_index, func_index);
+
+                  if (val_pcie_read_cfg_shadow(bdf, TYPE01_VIDR, &reg_value) == PCIE_NO_MAPPING)
+                      return 1;
+
+                  if (reg_value == PCIE_UNKNOWN_RESPONSE)
+                      continue;
+
+                  if (val_pcie_function_header_type(bdf) == TYPE1_HEADER)
+                  {
+                      val_pcie_read_cfg_shadow(bdf, TYPE1_PBN, &reg_value);
+                      sec_bus = ((reg_value >> SECBN_SHIFT) & SECBN_MASK);
+                      sub_bus = ((reg_value >> SUBBN_SHIFT) & SUBBN_MASK);
+                      if (sub_bus > end_bus)
+                          sub_bus = end_bus;
+                      for (; (sec_bus > bus_index) && (sec_bus <= sub_bus); sec_bus++)
+                          bus_map[sec_bus / 32] |= 1u << (sec_bus % 32);
+                  }
+
+                  /* Same filter as the full scan */
+                  if (val_pcie_is_host_bridge(bdf))
+                      continue;
+
+                  if (val_pcie_find_capability(bdf, PCIE_CAP, CID_PCIECS, &cid_offset) !=
+                      PCIE_SUCCESS)
+                      continue;
+
+                  (*count)++;
+              }
+          }
+      }
+  }
+
+  return 0;
+}
+
+/**
+  @brief   Check that a BDF table restored from a snapshot still matches the
+           hardware: every listed function must respond to a config read, and
+           the populated buses must hold as many functions as the table lists.
+
+  @param   None
+
+  @return  0 if the table is usable, 1 otherwise
+**/
+static uint32_t val_pcie_check_bdf_table(void)
+{
+  uint32_t tbl_index;
+  uint32_t reg_value;
+  uint32_t count;
+
+  if (g_pcie_bdf_table->num_entries >
+      ((PCIE_DEVICE_BDF_TABLE_SZ - sizeof(pcie_device_bdf_table)) / sizeof(pcie_device_attr)))
+      return 1;
+
+  for (tbl_index = 0; tbl_index < g_pcie_bdf_table->num_entries; tbl_index++)
+  {
+      if (val_pcie_read_cfg_shadow(g_pcie_bdf_table->device[tbl_index].bdf, TYPE01_VIDR, &reg_value))
+          return 1;
+
+      if (reg_value == PCIE_UNKNOWN_RESPONSE)
+          return 1;
+  }
+
+  /* Functions added since the snapshot was taken */
+  if (val_pcie_count_live_functions(&count))
+      return 1;
+
+  if (count != g_pcie_bdf_table->num_entries) {
+      val_print(ACS_PRINT_DEBUG, "\n  Snapshot lists %d functions", g_pcie_bdf_table->num_entries);
+      val_print(ACS_PRINT_DEBUG, ", found %d", count);
+      return 1;
+  }
+
+  return 0;
+}
+
 /**
   @brief   This API creates the device bdf table from enumeration
 
@@ -581,6 +1191,18 @@ val_pcie_create_device_bdf_table()
       return 1;
   }
 
+  /* A BDF table restored from a platform snapshot is kept as long as every
+     function it lists still responds, else the buses are scanned again */
+  val_snapshot_register(SNAPSHOT_PCIE_BDF, g_pcie_bdf_table, PCIE_DEVICE_BDF_TABLE_SZ);
+  if (!val_snapshot_restore(SNAPSHOT_PCIE_BDF, g_pcie_bdf_table)) {
+      if (!val_pcie_check_bdf_table())
+          return 0;
+
+      val_print(ACS_PRINT_WARN, "\n  Snapshot BDF table is stale, rescanning", 0);
+      val_snapshot_invalidate(SNAPSHOT_PCIE_BDF);
+      g_pcie_bdf_table->num_entries = 0;
+  }
+
   for (ecam_index = 0; ecam_index < num_ecam; ecam_index++)
   {
       /* Derive ecam specific information */
@@ -599,7 +1221,7 @@ val_pcie_create_device_bdf_table()
                   bdf = PCIE_CREATE_BDF(seg_num, bus_index, dev_index, func_index);
 
                   /* Probe pcie device Function with this bdf */
-                  if (val_pcie_read_cfg(bdf, TYPE01_VIDR, &reg_value) == PCIE_NO_MAPPING)
+                  if (val_pcie_read_cfg_shadow(bdf, TYPE01_VIDR, &reg_value) == PCIE_NO_MAPPING)
                   {
                       /* Return if there is a bdf mapping issue */
                       val_print(ACS_PRINT_ERR, "\n       BDF 0x%x mapping issue", bdf);
@@ -677,7 +1299,7 @@ addr_t val_pcie_get_ecam_base(uint32_t bdf)
           else
           {
               /* Check for Secondary/Subordinate bus if Type1 Header */
-              val_pcie_read_cfg(bdf, TYPE1_PBN, &reg_value);
+              val_pcie_read_cfg_shadow(bdf, TYPE1_PBN, &reg_value);
               sec_bus = ((reg_value >> SECBN_SHIFT) & SECBN_MASK);
               sub_bus = ((reg_value >> SUBBN_SHIFT) & SUBBN_MASK);
 
@@ -719,6 +1341,7 @@ val_pcie_bdf_table_ptr()
 void
 val_pcie_free_info_table()
 {
+  val_pcie_shadow_enable(0);
   pal_mem_free((void *)g_pcie_info_table);
 }
 
@@ -928,7 +1551,7 @@ uint32_t
 val_pcie_multifunction_support(uint32_t bdf)
 {
   uint32_t reg_data;
-  val_pcie_read_cfg(bdf, TYPE01_CLSR, &reg_data);
+  val_pcie_read_cfg_shadow(bdf, TYPE01_CLSR, &reg_data);
   reg_data = ((reg_data >> TYPE01_HTR_SHIFT) & TYPE01_HTR_MASK);
 
   return !((reg_data >> HTR_MFD_SHIFT) & HTR_MFD_MASK);
@@ -1162,6 +1785,27 @@ val_pcie_get_atomicop_requester_capable(uint32_t bdf)
   return 0;
 }
 
+/**
+  @brief  Returns the number of MSI-X table entries of a PCIe Function
+
+  @param  bdf        - Segment/Bus/Dev/Func in the format of PCIE_CREATE_BDF
+  @return Returns MSI-X Table Size + 1 from the Message Control register,
+          0 if the Function has no MSI-X capability
+**/
+uint32_t
+val_pcie_get_msix_table_size(uint32_t bdf)
+{
+  uint32_t msi_cap_offset;
+  uint32_t reg_value;
+
+  if (val_pcie_find_capability(bdf, PCIE_CAP, CID_MSIX, &msi_cap_offset))
+      return 0;
+
+  val_pcie_read_cfg_shadow(bdf, msi_cap_offset, &reg_value);
+
+  return ((reg_value >> MSI_X_TABLE_SIZE_SHIFT) & MSI_X_TABLE_SIZE_MASK) + 1;
+}
+
 /**
   @brief  Returns the type of pcie device or port for the given bdf
 
@@ -1184,7 +1828,7 @@ val_pcie_device_port_type(uint32_t bdf)
    * use that offset to read pci express capabilities register
    */
   val_pcie_find_capability(bdf, PCIE_CAP, CID_PCIECS, &pciecs_base);
-  status = val_pcie_read_cfg(bdf, pciecs_base + CIDR_OFFSET, &reg_value);
+  status = val_pcie_read_cfg_shadow(bdf, pciecs_base + CIDR_OFFSET, &reg_value);
 
   if (status)
       return PCIE_UNKNOWN_RESPONSE;
@@ -1229,16 +1873,20 @@ val_pcie_find_capability(uint32_t bdf, uint32_t cid_type, uint32_t cid, uint32_t
   if (cid_type == PCIE_CAP) {
 
       /* Serach in PCIe configuration space */
-      ret = val_pcie_read_cfg(bdf, TYPE01_CPR, &reg_value);
+      ret = val_pcie_read_cfg_shadow(bdf, TYPE01_CPR, &reg_value);
       if (ret == PCIE_NO_MAPPING || reg_value == PCIE_UNKNOWN_RESPONSE)
           return ret;
 
       next_cap_offset = (reg_value & TYPE01_CPR_MASK);
       while (next_cap_offset)
       {
-          val_pcie_read_cfg(bdf, next_cap_offset, &reg_value);
+          /* Only the ID and next pointer are read-only for every capability */
+          val_pcie_read_cfg_ro(bdf, next_cap_offset, &reg_value);
           if ((reg_value & PCIE_CIDR_MASK) == cid)
           {
+              if ((cid == CID_PCIECS) && g_pcie_shadow_enabled)
+                  val_pcie_shadow_mark_pciecs(bdf, next_cap_offset);
+
               *cid_offset = next_cap_offset;
               return PCIE_SUCCESS;
           }
@@ -1251,7 +1899,7 @@ val_pcie_find_capability(uint32_t bdf, uint32_t cid_type, uint32_t cid, uint32_t
       next_cap_offset = PCIE_ECAP_START;
       while (next_cap_offset)
       {
-          val_pcie_read_cfg(bdf, next_cap_offset, &reg_value);
+          val_pcie_read_cfg_mode(bdf, next_cap_offset, &reg_value, PCIE_SHADOW_READ_RO_DWORD);
           if ((reg_value & PCIE_ECAP_CIDR_MASK) == cid)
           {
               *cid_offset = next_cap_offset;
@@ -1282,7 +1930,7 @@ val_pcie_disable_bme(uint32_t bdf)
   uint32_t dis_mask;
 
   /* Clear BME bit in Command Register to disable ability to issue Memory Requests */
-  val_pcie_read_cfg(bdf, TYPE01_CR, &reg_value);
+  val_pcie_read_cfg_shadow(bdf, TYPE01_CR, &reg_value);
   dis_mask = ~(1 << CR_BME_SHIFT);
   val_pcie_write_cfg(bdf, TYPE01_CR, reg_value & dis_mask);
 
@@ -1317,7 +1965,7 @@ val_pcie_enable_bme(uint32_t bdf)
   uint32_t reg_value;
 
   /* Set BME bit in Command Register to enable ability to issue Memory Requests */
-  val_pcie_read_cfg(bdf, TYPE01_CR, &reg_value);
+  val_pcie_read_cfg_shadow(bdf, TYPE01_CR, &reg_value);
   val_pcie_write_cfg(bdf, TYPE01_CR, reg_value | (1 << CR_BME_SHIFT));
 
 }
@@ -1338,7 +1986,7 @@ val_pcie_disable_msa(uint32_t bdf)
   uint32_t dis_mask;
 
   /* Clear MSE bit in Command Register to disable BAR memory space accesses */
-  val_pcie_read_cfg(bdf, TYPE01_CR, &reg_value);
+  val_pcie_read_cfg_shadow(bdf, TYPE01_CR, &reg_value);
   dis_mask = ~(1 << CR_MSE_SHIFT);
   val_pcie_write_cfg(bdf, TYPE01_CR, reg_value & dis_mask);
 
@@ -1359,7 +2007,7 @@ val_pcie_enable_msa(uint32_t bdf)
   uint32_t reg_value;
 
   /* Enable MSE bit in Command Register to enable BAR memory space accesses */
-  val_pcie_read_cfg(bdf, TYPE01_CR, &reg_value);
+  val_pcie_read_cfg_shadow(bdf, TYPE01_CR, &reg_value);
   val_pcie_write_cfg(bdf, TYPE01_CR, reg_value | (1 << CR_MSE_SHIFT));
 
 }
@@ -1382,7 +2030,7 @@ val_pcie_clear_urd(uint32_t bdf)
    * offset to write 1b to clear URD bit in Device Status register
    */
   val_pcie_find_capability(bdf, PCIE_CAP, CID_PCIECS, &pciecs_base);
-  val_pcie_read_cfg(bdf, pciecs_base + DCTLR_OFFSET, &reg_value);
+  val_pcie_read_cfg_shadow(bdf, pciecs_base + DCTLR_OFFSET, &reg_value);
   reg_value &= DCTLR_MASK;
   reg_value |= (1 << (DCTLR_DSR_SHIFT + DSR_URD_SHIFT));
   val_pcie_write_cfg(bdf, pciecs_base + DCTLR_OFFSET, reg_value);
@@ -1407,7 +2055,7 @@ val_pcie_is_urd(uint32_t bdf)
    * use that offset to read the Device Status register
    */
   val_pcie_find_capability(bdf, PCIE_CAP, CID_PCIECS, &pciecs_base);
-  val_pcie_read_cfg(bdf, pciecs_base + DCTLR_OFFSET, &reg_value);
+  val_pcie_read_cfg_shadow(bdf, pciecs_base + DCTLR_OFFSET, &reg_value);
 
   /* Check if URD bit is set in Function's Device Control register */
   reg_value = (reg_value >> DCTLR_DSR_SHIFT) & DCTLR_DSR_MASK;
@@ -1436,7 +2084,7 @@ val_pcie_clear_device_status_error(uint32_t bdf)
    * offset to write 1b to clear CED, NFED, FED, URD bit in Device Status register
    */
   val_pcie_find_capability(bdf, PCIE_CAP, CID_PCIECS, &pciecs_base);
-  val_pcie_read_cfg(bdf, pciecs_base + DCTLR_OFFSET, &reg_value);
+  val_pcie_read_cfg_shadow(bdf, pciecs_base + DCTLR_OFFSET, &reg_value);
   reg_value = reg_value | (0xF << DCTLR_DSR_SHIFT);
   val_pcie_write_cfg(bdf, pciecs_base + DCTLR_OFFSET, reg_value);
 
@@ -1460,7 +2108,7 @@ val_pcie_is_device_status_error(uint32_t bdf)
    * offset to check CED, NFED, FED, URD bit in Device Status register
    */
   val_pcie_find_capability(bdf, PCIE_CAP, CID_PCIECS, &pciecs_base);
-  val_pcie_read_cfg(bdf, pciecs_base + DCTLR_OFFSET, &reg_value);
+  val_pcie_read_cfg_shadow(bdf, pciecs_base + DCTLR_OFFSET, &reg_value);
 
   if (reg_value & (0xF << DCTLR_DSR_SHIFT))
       return 1;
@@ -1482,11 +2130,11 @@ val_pcie_clear_sig_target_abort(uint32_t bdf)
   uint32_t sec_status_val;
 
   /* Read Status Register at 0x4 Offset */
-  val_pcie_read_cfg(bdf, TYPE01_CR, &status_val);
+  val_pcie_read_cfg_shadow(bdf, TYPE01_CR, &status_val);
   val_pcie_write_cfg(bdf, TYPE01_CR, (status_val | (1 << SR_STA_SHIFT)));
 
   /* Read Secondary Status Register at 0x1C Offset */
-  val_pcie_read_cfg(bdf, TYPE1_SEC_STA, &sec_status_val);
+  val_pcie_read_cfg_shadow(bdf, TYPE1_SEC_STA, &sec_status_val);
   val_pcie_write_cfg(bdf, TYPE1_SEC_STA, (sec_status_val | (1 << SSR_STA_SHIFT)));
 }
 
@@ -1504,9 +2152,9 @@ val_pcie_is_sig_target_abort(uint32_t bdf)
   uint32_t sec_status_val;
 
   /* Read Status Register at 0x4 Offset */
-  val_pcie_read_cfg(bdf, TYPE01_CR, &status_val);
+  val_pcie_read_cfg_shadow(bdf, TYPE01_CR, &status_val);
   /* Read Secondary Status Register at 0x1C Offset */
-  val_pcie_read_cfg(bdf, TYPE1_SEC_STA, &sec_status_val);
+  val_pcie_read_cfg_shadow(bdf, TYPE1_SEC_STA, &sec_status_val);
 
   if (((status_val >> SR_STA_SHIFT) & SR_STA_MASK) ||
       ((sec_status_val >> SSR_STA_SHIFT) & SSR_STA_MASK))
@@ -1531,7 +2179,7 @@ val_pcie_disable_eru(uint32_t bdf)
   /* Clear SERR# Enable bit in the Command Register to disable reporting
    * upstream of Non-fatal and Fatal errors detected by the Function.
    */
-  val_pcie_read_cfg(bdf, TYPE01_CR, &reg_value);
+  val_pcie_read_cfg_shadow(bdf, TYPE01_CR, &reg_value);
   dis_mask = ~(1 << CR_SERRE_SHIFT);
   val_pcie_write_cfg(bdf, TYPE01_CR, reg_value & dis_mask);
 
@@ -1539,7 +2187,7 @@ val_pcie_disable_eru(uint32_t bdf)
    * use that offset to read the Device Control register
    */
   val_pcie_find_capability(bdf, PCIE_CAP, CID_PCIECS, &pciecs_base);
-  val_pcie_read_cfg(bdf, pciecs_base + DCTLR_OFFSET, &reg_value);
+  val_pcie_read_cfg_shadow(bdf, pciecs_base + DCTLR_OFFSET, &reg_value);
 
   /* Clear Correctable, Non-fatal, Fatal, UR Reporting Enable bits in the
    * Device Control Register to disable reporting upstream of these errors
@@ -1608,11 +2256,11 @@ uint32_t val_pcie_bitfield_check(uint32_t bdf, uint64_t *bitfield_entry)
   }
 
   /* Derive bit-field of interest from the register value */
-  val_pcie_read_cfg(bdf, cap_base + reg_offset, &reg_value);
+  val_pcie_read_cfg_shadow(bdf, cap_base + reg_offset, &reg_value);
 
   /* To prevent status bits are clear when write 1, just clear it firstly */
   val_pcie_write_cfg(bdf, cap_base + reg_offset, reg_value);
-  val_pcie_read_cfg(bdf, cap_base + reg_offset, &reg_value);
+  val_pcie_read_cfg_shadow(bdf, cap_base + reg_offset, &reg_value);
 
   bf_value = (reg_value >> REG_SHIFT(alignment_byte_cnt, bf_entry->start)) &
                     REG_MASK(bf_entry->end, bf_entry->start);
@@ -1637,13 +2285,13 @@ uint32_t val_pcie_bitfield_check(uint32_t bdf, uint64_t *bitfield_entry)
           reg_overwrite_value = reg_value ^ (REG_MASK(bf_entry->end, bf_entry->start) <<
                                        REG_SHIFT(alignment_byte_cnt, bf_entry->start));
           val_pcie_write_cfg(bdf, cap_base + reg_offset, reg_overwrite_value);
-          val_pcie_read_cfg(bdf, cap_base + reg_offset, &reg_overwrite_value);
+          val_pcie_read_cfg_shadow(bdf, cap_base + reg_offset, &reg_overwrite_value);
           break;
       case RSVDP_RO:
           /* Software must preserve the value read to write to these bits */
           reg_overwrite_value = reg_value;
           val_pcie_write_cfg(bdf, cap_base + reg_offset, reg_overwrite_value);
-          val_pcie_read_cfg(bdf, cap_base + reg_offset, &reg_overwrite_value);
+          val_pcie_read_cfg_shadow(bdf, cap_base + reg_offset, &reg_overwrite_value);
           shft_cnt = REG_SHIFT(alignment_byte_cnt, bf_entry->start);
           reg_overwrite_value = (reg_overwrite_value >> shft_cnt) &
                     REG_MASK(bf_entry->end, bf_entry->start);
@@ -1655,7 +2303,7 @@ uint32_t val_pcie_bitfield_check(uint32_t bdf, uint64_t *bitfield_entry)
           reg_overwrite_value = reg_value & (~(REG_MASK(bf_entry->end, bf_entry->start) <<
                                        REG_SHIFT(alignment_byte_cnt, bf_entry->start)));
           val_pcie_write_cfg(bdf, cap_base + reg_offset, reg_overwrite_value);
-          val_pcie_read_cfg(bdf, cap_base + reg_offset, &reg_overwrite_value);
+          val_pcie_read_cfg_shadow(bdf, cap_base + reg_offset, &reg_overwrite_value);
           break;
       case READ_WRITE:
       case STICKY_RW:
@@ -1664,7 +2312,7 @@ uint32_t val_pcie_bitfield_check(uint32_t bdf, uint64_t *bitfield_entry)
           reg_overwrite_value = reg_value ^ (REG_MASK(bf_entry->end, bf_entry->start) <<
                                        REG_SHIFT(alignment_byte_cnt, bf_entry->start));
           val_pcie_write_cfg(bdf, cap_base + reg_offset, reg_overwrite_value);
-          val_pcie_read_cfg(bdf, cap_base + reg_offset, &reg_value);
+          val_pcie_read_cfg_shadow(bdf, cap_base + reg_offset, &reg_value);
           /* Restore the original register value */
           val_pcie_write_cfg(bdf, cap_base + reg_offset, temp_reg_value);
           break;
@@ -1769,8 +2417,10 @@ val_pcie_function_header_type(uint32_t bdf)
 
   uint32_t reg_value;
 
-  /* Read four bytes of config space starting from cache line size register */
-  val_pcie_read_cfg(bdf, TYPE01_CLSR, &reg_value);
+  /* Read four bytes of config space starting from cache line size register,
+   * only the read-only header type is used
+   */
+  val_pcie_read_cfg_ro(bdf, TYPE01_CLSR, &reg_value);
 
   /* Extract header type register value */
   reg_value = ((reg_value >> TYPE01_HTR_SHIFT) & TYPE01_HTR_MASK);
@@ -1800,7 +2450,7 @@ val_pcie_get_mmio_bar(uint32_t bdf, void *base)
   while (index < TYPE0_MAX_BARS)
   {
       /* Read the base address register at loop index */
-      val_pcie_read_cfg(bdf, TYPE01_BAR + index * 4, &bar_low32bits);
+      val_pcie_read_cfg_shadow(bdf, TYPE01_BAR + index * 4, &bar_low32bits);
 
       /* Check if the BAR is Memory Mapped IO type */
       if (((bar_low32bits >> BAR_MIT_SHIFT) & BAR_MIT_MASK) == MMIO)
@@ -1809,7 +2459,7 @@ val_pcie_get_mmio_bar(uint32_t bdf, void *base)
           if (((bar_low32bits >> BAR_MDT_SHIFT) & BAR_MDT_MASK) == BITS_64)
           {
               /* Read the second sequential BAR at next index */
-              val_pcie_read_cfg(bdf, TYPE01_BAR + (index + 1) * 4, &bar_high32bits);
+              val_pcie_read_cfg_shadow(bdf, TYPE01_BAR + (index + 1) * 4, &bar_high32bits);
 
               /* Fill upper 32-bits of 64-bit address with second sequential BAR */
               base_ptr[1] = bar_high32bits;
@@ -1877,7 +2527,7 @@ val_pcie_get_downstream_function(uint32_t bdf, uint32_t *dsf_bdf)
    * register and extract the Secondary and Subordinate Bus numbers
    * and the segment.
    */
-  val_pcie_read_cfg(bdf, TYPE1_PBN, &reg_value);
+  val_pcie_read_cfg_shadow(bdf, TYPE1_PBN, &reg_value);
   sec_bus = ((reg_value >> SECBN_SHIFT) & SECBN_MASK);
   sub_bus = ((reg_value >> SUBBN_SHIFT) & SUBBN_MASK);
   seg = (PCIE_EXTRACT_BDF_SEG(bdf));
@@ -1968,7 +2618,7 @@ val_pcie_get_rootport(uint32_t bdf, uint32_t *rp_bdf)
        * upstream Root port and check if the input function's
        * bus number falls within that range.
        */
-      val_pcie_read_cfg(*rp_bdf, TYPE1_PBN, &reg_value);
+      val_pcie_read_cfg_shadow(*rp_bdf, TYPE1_PBN, &reg_value);
       sec_bus = ((reg_value >> SECBN_SHIFT) & SECBN_MASK);
       sub_bus = ((reg_value >> SUBBN_SHIFT) & SUBBN_MASK);
       dp_type = val_pcie_device_port_type(*rp_bdf);
@@ -2018,7 +2668,7 @@ val_pcie_parent_is_rootport(uint32_t dsf_bdf, uint32_t *rp_bdf)
       if (dp_type == RP)
       {
          /* Check if device is a direct child of this root port */
-          val_pcie_read_cfg(bdf, TYPE1_PBN, &reg_value);
+          val_pcie_read_cfg_shadow(bdf, TYPE1_PBN, &reg_value);
           if ((dsf_bus == ((reg_value >> SECBN_SHIFT) & SECBN_MASK)) &&
               (dsf_bus <= ((reg_value >> SUBBN_SHIFT) & SUBBN_MASK)))
           {
@@ -2042,7 +2692,7 @@ val_pcie_is_host_bridge(uint32_t bdf)
 {
   uint32_t  reg_value;
 
-  val_pcie_read_cfg(bdf, TYPE01_RIDR, &reg_value);
+  val_pcie_read_cfg_shadow(bdf, TYPE01_RIDR, &reg_value);
   if ((HB_BASE_CLASS == ((reg_value >> CC_BASE_SHIFT) & CC_BASE_MASK)) &&
       (HB_SUB_CLASS == ((reg_value >> CC_SUB_SHIFT) & CC_SUB_MASK)))
     return 1;
@@ -2078,7 +2728,7 @@ val_pcie_link_cap_support(uint32_t bdf)
   uint32_t reg_value = 0xFFFFFFFF;
 
   val_pcie_find_capability(bdf, PCIE_CAP, CID_PCIECS, &pciecs_base);
-  val_pcie_read_cfg(bdf, pciecs_base + LCAPR_OFFSET, &reg_value);
+  val_pcie_read_cfg_shadow(bdf, pciecs_base + LCAPR_OFFSET, &reg_value);
 
   if (reg_value != 0) {
      val_print(ACS_PRINT_ERR, "\n       Link Capabilities reg check failed", 0);
@@ -2086,21 +2736,21 @@ val_pcie_link_cap_support(uint32_t bdf)
   }
 
   reg_value = 0xFFFFFFFF;
-  val_pcie_read_cfg(bdf, pciecs_base + LCTLR_OFFSET, &reg_value);
+  val_pcie_read_cfg_shadow(bdf, pciecs_base + LCTLR_OFFSET, &reg_value);
   if (reg_value != 0) {
      val_print(ACS_PRINT_ERR, "\n       Link Capabilities control and status check failed", 0);
      return 1;
   }
 
   reg_value = 0xFFFFFFFF;
-  val_pcie_read_cfg(bdf, pciecs_base + LCAP2R_OFFSET, &reg_value);
+  val_pcie_read_cfg_shadow(bdf, pciecs_base + LCAP2R_OFFSET, &reg_value);
   if (reg_value != 0) {
      val_print(ACS_PRINT_ERR, "\n       Link Capabilities 2 reg check failed", 0);
      return 1;
   }
 
   reg_value = 0xFFFFFFFF;
-  val_pcie_read_cfg(bdf, pciecs_base + LCTL2R_OFFSET, &reg_value);
+  val_pcie_read_cfg_shadow(bdf, pciecs_base + LCTL2R_OFFSET, &reg_value);
   if (reg_value != 0) {
      val_print(ACS_PRINT_ERR, "\n       Link Capabilities 2 control and status check failed", 0);
      return 1;
@@ -2127,7 +2777,7 @@ val_pcie_get_max_pasid_width(uint32_t bdf, uint32_t *max_pasid_width)
   if (status)
       return status;
 
-  val_pcie_read_cfg(bdf, pciecs_base + PASID_CAPABILITY_OFFSET, max_pasid_width);
+  val_pcie_read_cfg_shadow(bdf, pciecs_base + PASID_CAPABILITY_OFFSET, max_pasid_width);
   *max_pasid_width = (*max_pasid_width & MAX_PASID_MASK) >> MAX_PASID_SHIFT;
 
   return 0;
@@ -2169,7 +2819,7 @@ val_pcie_get_ecam_index(uint32_t bdf, uint32_t *ecam_index)
           else
           {
               /* Check for Secondary/Subordinate bus if Type1 Header */
-              val_pcie_read_cfg(bdf, TYPE1_PBN, &reg_value);
+              val_pcie_read_cfg_shadow(bdf, TYPE1_PBN, &reg_value);
               sec_bus = ((reg_value >> SECBN_SHIFT) & SECBN_MASK);
               sub_bus = ((reg_value >> SUBBN_SHIFT) & SUBBN_MASK);
 
@@ -2205,7 +2855,7 @@ val_is_transaction_pending_set(uint32_t bdf)
    * use that offset to read pci express capabilities register
    */
   val_pcie_find_capability(bdf, PCIE_CAP, CID_PCIECS, &pciecs_base);
-  status = val_pcie_read_cfg(bdf, pciecs_base + DCTLR_OFFSET, &reg_value);
+  status = val_pcie_read_cfg_shadow(bdf, pciecs_base + DCTLR_OFFSET, &reg_value);
 
   if (status) {
       val_print(ACS_PRINT_ERR, "\n       Error in reading transaction pending bit", 0);
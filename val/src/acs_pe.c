@@ -18,6 +18,7 @@
 #include "include/bsa_acs_val.h"
 #include "include/bsa_acs_pe.h"
 #include "include/bsa_acs_common.h"
+#include "include/bsa_acs_memory.h"
 #include "include/bsa_std_smc.h"
 
 
@@ -53,6 +54,9 @@ val_pe_execute_tests(uint32_t num_pe, uint32_t *g_sw_view)
 
   status = ACS_STATUS_PASS;
 
+  /* Tests checking only ID registers read them from this database */
+  val_pe_feat_db_create();
+
   if (g_sw_view[G_SW_OS]) {
       val_print(ACS_PRINT_ERR, "\nOperating System View:\n", 0);
       status |= os_c001_entry(num_pe);
@@ -91,6 +95,8 @@ val_pe_execute_tests(uint32_t num_pe, uint32_t *g_sw_view)
       status |= ps_c001_entry(num_pe);
   }
 
+  val_pe_feat_db_free();
+
   if (status != ACS_STATUS_PASS)
       val_print(ACS_PRINT_TEST, "\n      *** One or more tests have Failed/Skipped.*** \n", 0);
   else
@@ -265,7 +271,7 @@ val_pe_reg_read(uint32_t reg_id)
       case DBGBCR15_EL1:
           return AA64ReadDbgbcr15El1();
       default:
-           val_report_status(val_pe_get_index_mpid(val_pe_get_mpid()),
+           val_report_status(val_pe_get_index(),
                                                  RESULT_FAIL(0, 0x78), NULL);
            break;
   }
@@ -326,12 +332,320 @@ val_pe_reg_write(uint32_t reg_id, uint64_t write_data)
           AA64WritePmblimitr(write_data);
           break;
       default:
-           val_report_status(val_pe_get_index_mpid(val_pe_get_mpid()),
+           val_report_status(val_pe_get_index(),
                                                   RESULT_FAIL(0, 0x78), NULL);
   }
 
 }
 
+/**
+  @brief   Capture the ID and feature registers of the current PE in one
+           call, for comparison with the values of other PEs.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  None
+  @param   regs - snapshot to fill
+  @return  None
+**/
+void
+val_pe_id_regs_snapshot(pe_id_regs_t *regs)
+{
+  uint64_t pfr0;
+  uint32_t num_err;
+  uint32_t level;
+  uint32_t i;
+
+  PeIdRegSnapshot(regs->reg);
+
+  for (i = PE_ID_CLIDR + 1; i < PE_ID_REG_NUM; i++)
+      regs->reg[i] = 0;
+
+  pfr0 = regs->reg[PE_ID_AA64PFR0];
+
+  /* Statistical Profiling Extension, any version */
+  if (((regs->reg[PE_ID_AA64DFR0] >> 32) & 0xF) != 0) {
+      regs->reg[PE_ID_PMBIDR] = AA64ReadPmbidr();
+      regs->reg[PE_ID_PMSIDR] = AA64ReadPmsidr();
+  }
+
+  /* RAS Extension, any version. Only the records ERRIDR_EL1.NUM reports
+     have an ERR<n>FR */
+  if (((pfr0 >> 28) & 0xF) != 0) {
+      regs->reg[PE_ID_ERRIDR] = AA64ReadErridr();
+      num_err = regs->reg[PE_ID_ERRIDR] & 0xFFFF;
+      if (num_err > 0)
+          regs->reg[PE_ID_ERR0FR] = AA64ReadErr0fr();
+      if (num_err > 1)
+          regs->reg[PE_ID_ERR1FR] = AA64ReadErr1fr();
+      if (num_err > 2)
+          regs->reg[PE_ID_ERR2FR] = AA64ReadErr2fr();
+      if (num_err > 3)
+          regs->reg[PE_ID_ERR3FR] = AA64ReadErr3fr();
+  }
+
+  /* Limited Ordering Regions */
+  if (((regs->reg[PE_ID_AA64MMFR1] >> 16) & 0xF) == 1)
+      regs->reg[PE_ID_LORID] = AA64ReadLorid();
+
+  /* The AArch32 ID registers are UNKNOWN in a pure AArch64 implementation */
+  if (pfr0 & 1)
+      for (i = PE_ID_DFR0; i <= PE_ID_MVFR2; i++)
+          regs->reg[i] = 0;
+
+  /* Only the cache levels CLIDR reports as implemented have a CCSIDR */
+  for (level = 0; level < PE_MAX_CACHE_LEVEL; level++) {
+      regs->ccsidr[level] = 0;
+      if (regs->reg[PE_ID_CLIDR] & (0x7ull << (level * 3))) {
+          AA64WriteCsselr(level << 1);
+          regs->ccsidr[level] = AA64ReadCcsidr();
+      }
+  }
+
+  regs->valid = PE_ID_REGS_VALID;
+}
+
+/* Feature database: the ID register snapshot of every PE, captured in one
+   multi-PE pass before the PE tests. Tests that only check ID register
+   fields evaluate their rules for each PE on the primary from these
+   snapshots instead of waking every PE. */
+static void *g_pe_feat_db_mem;
+static void *g_pe_feat_db;
+static void (*g_pe_feat_payload)(uint32_t index);
+
+/**
+  @brief   Fill the feature database entry of the current PE. Runs on the
+           secondary PEs.
+           1. Caller       -  val_pe_feat_db_create, through val_execute_on_pe
+  @param   None
+  @return  None
+**/
+static
+void
+val_pe_feat_db_capture(void)
+{
+  pe_id_regs_t *regs;
+
+  val_data_cache_ops_by_range((addr_t)&g_pe_feat_db, sizeof(g_pe_feat_db), INVALIDATE);
+  regs = PE_ID_REGS_ENTRY(g_pe_feat_db, val_pe_get_index());
+
+  val_pe_id_regs_snapshot(regs);
+  val_data_cache_ops_by_range((addr_t)regs, sizeof(pe_id_regs_t), CLEAN_AND_INVALIDATE);
+}
+
+/**
+  @brief   Capture the ID registers of all PEs in a single dispatch round.
+           A PE that does not respond keeps an invalid entry, tests then
+           run their payload on that PE instead.
+           1. Caller       -  VAL
+           2. Prerequisite -  val_pe_create_info_table, val_allocate_shared_mem
+  @param   None
+  @return  0 on success, 1 if the database could not be allocated
+**/
+uint32_t
+val_pe_feat_db_create(void)
+{
+  uint32_t num_pe = val_pe_get_num();
+  uint32_t my_index = val_pe_get_index();
+  uint32_t size = num_pe * PE_ID_REGS_STRIDE;
+  uint32_t missing = 0;
+  uint32_t timeout;
+  uint32_t i;
+  pe_id_regs_t *regs;
+
+  g_pe_feat_db_mem = val_memory_alloc(size + 64);
+  if (g_pe_feat_db_mem == NULL) {
+      val_print(ACS_PRINT_WARN, "\n       PE feature database allocation failed", 0);
+      return 1;
+  }
+
+  /* Cache line aligned entries so each PE writes back only its own lines */
+  g_pe_feat_db = (void *)(((addr_t)g_pe_feat_db_mem + 63) & ~(addr_t)63);
+  val_memory_set(g_pe_feat_db, size, 0);
+  val_data_cache_ops_by_range((addr_t)g_pe_feat_db, size, CLEAN_AND_INVALIDATE);
+  val_data_cache_ops_by_range((addr_t)&g_pe_feat_db, sizeof(g_pe_feat_db), CLEAN_AND_INVALIDATE);
+
+  val_pe_id_regs_snapshot(PE_ID_REGS_ENTRY(g_pe_feat_db, my_index));
+
+  for (i = 0; i < num_pe; i++) {
+      if (i != my_index)
+          val_execute_on_pe(i, val_pe_feat_db_capture, 0);
+  }
+
+  for (i = 0; i < num_pe; i++) {
+      if (i == my_index)
+          continue;
+
+      regs = PE_ID_REGS_ENTRY(g_pe_feat_db, i);
+      timeout = TIMEOUT_LARGE;
+      do {
+          val_data_cache_ops_by_range((addr_t)regs, sizeof(pe_id_regs_t), INVALIDATE);
+      } while ((regs->valid != PE_ID_REGS_VALID) && (--timeout));
+
+      if (regs->valid != PE_ID_REGS_VALID)
+          missing++;
+  }
+
+  if (missing)
+      val_print(ACS_PRINT_WARN, "\n       %d PEs missing from the feature database", missing);
+
+  return 0;
+}
+
+/**
+  @brief   Release the feature database
+  @param   None
+  @return  None
+**/
+void
+val_pe_feat_db_free(void)
+{
+  if (g_pe_feat_db_mem)
+      val_memory_free(g_pe_feat_db_mem);
+
+  g_pe_feat_db_mem = NULL;
+  g_pe_feat_db = NULL;
+}
+
+/**
+  @brief   Return the feature database entry of a PE
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_pe_feat_db_create
+  @param   index - PE index
+  @return  Snapshot of the PE, NULL if the PE is not in the database
+**/
+pe_id_regs_t *
+val_pe_feat_db_get(uint32_t index)
+{
+  pe_id_regs_t *regs;
+
+  if ((g_pe_feat_db == NULL) || (index >= val_pe_get_num()))
+      return NULL;
+
+  regs = PE_ID_REGS_ENTRY(g_pe_feat_db, index);
+  if (regs->valid != PE_ID_REGS_VALID)
+      return NULL;
+
+  return regs;
+}
+
+/**
+  @brief   Read an ID register of a PE from the feature database. Registers
+           not held in the database are read from the current PE, so the
+           caller must be running on the PE given by index in that case.
+           1. Caller       -  Test Suite, payloads of val_pe_run_feat_payload
+           2. Prerequisite -  None
+  @param   index  - PE index
+  @param   reg_id - register, one of BSA_ACS_PE_REGS
+  @return  Register value
+**/
+uint64_t
+val_pe_feat_reg(uint32_t index, uint32_t reg_id)
+{
+  pe_id_regs_t *regs = val_pe_feat_db_get(index);
+  uint32_t id;
+
+  if (regs == NULL)
+      return val_pe_reg_read(reg_id);
+
+  switch (reg_id) {
+      case ID_AA64PFR0_EL1:  id = PE_ID_AA64PFR0;  break;
+      case ID_AA64PFR1_EL1:  id = PE_ID_AA64PFR1;  break;
+      case ID_AA64DFR0_EL1:  id = PE_ID_AA64DFR0;  break;
+      case ID_AA64DFR1_EL1:  id = PE_ID_AA64DFR1;  break;
+      case ID_AA64MMFR0_EL1: id = PE_ID_AA64MMFR0; break;
+      case ID_AA64MMFR1_EL1: id = PE_ID_AA64MMFR1; break;
+      case CTR_EL0:          id = PE_ID_CTR;       break;
+      case ID_AA64ISAR0_EL1: id = PE_ID_AA64ISAR0; break;
+      case ID_AA64ISAR1_EL1: id = PE_ID_AA64ISAR1; break;
+      case MPIDR_EL1:        id = PE_ID_MPIDR;     break;
+      case MIDR_EL1:         id = PE_ID_MIDR;      break;
+      case ID_DFR0_EL1:      id = PE_ID_DFR0;      break;
+      case ID_ISAR0_EL1:     id = PE_ID_ISAR0;     break;
+      case ID_ISAR1_EL1:     id = PE_ID_ISAR1;     break;
+      case ID_ISAR2_EL1:     id = PE_ID_ISAR2;     break;
+      case ID_ISAR3_EL1:     id = PE_ID_ISAR3;     break;
+      case ID_ISAR4_EL1:     id = PE_ID_ISAR4;     break;
+      case ID_ISAR5_EL1:     id = PE_ID_ISAR5;     break;
+      case ID_MMFR0_EL1:     id = PE_ID_MMFR0;     break;
+      case ID_MMFR1_EL1:     id = PE_ID_MMFR1;     break;
+      case ID_MMFR2_EL1:     id = PE_ID_MMFR2;     break;
+      case ID_MMFR3_EL1:     id = PE_ID_MMFR3;     break;
+      case ID_MMFR4_EL1:     id = PE_ID_MMFR4;     break;
+      case ID_PFR0_EL1:      id = PE_ID_PFR0;      break;
+      case ID_PFR1_EL1:      id = PE_ID_PFR1;      break;
+      case MVFR0_EL1:        id = PE_ID_MVFR0;     break;
+      case MVFR1_EL1:        id = PE_ID_MVFR1;     break;
+      case MVFR2_EL1:        id = PE_ID_MVFR2;     break;
+      case PMCEID0_EL0:      id = PE_ID_PMCEID0;   break;
+      case PMCEID1_EL0:      id = PE_ID_PMCEID1;   break;
+      case PMCR_EL0:         id = PE_ID_PMCR;      break;
+      case CLIDR_EL1:        id = PE_ID_CLIDR;     break;
+      case PMBIDR_EL1:       id = PE_ID_PMBIDR;    break;
+      case PMSIDR_EL1:       id = PE_ID_PMSIDR;    break;
+      case ERRIDR_EL1:       id = PE_ID_ERRIDR;    break;
+      case ERR0FR_EL1:       id = PE_ID_ERR0FR;    break;
+      case ERR1FR_EL1:       id = PE_ID_ERR1FR;    break;
+      case ERR2FR_EL1:       id = PE_ID_ERR2FR;    break;
+      case ERR3FR_EL1:       id = PE_ID_ERR3FR;    break;
+      case LORID_EL1:        id = PE_ID_LORID;     break;
+      default:
+          return val_pe_reg_read(reg_id);
+  }
+
+  return regs->reg[id];
+}
+
+/**
+  @brief   Run a payload on the secondary PE, for a PE missing from the
+           feature database
+  @param   None
+  @return  None
+**/
+static
+void
+val_pe_feat_payload_entry(void)
+{
+  val_data_cache_ops_by_range((addr_t)&g_pe_feat_payload, sizeof(g_pe_feat_payload), INVALIDATE);
+  g_pe_feat_payload(val_pe_get_index());
+}
+
+/**
+  @brief   Run a test payload that only checks ID register fields for all
+           PEs. The payload is called on the current PE with the index of
+           each PE in the feature database, and reads the registers with
+           val_pe_feat_reg. Only PEs missing from the database are woken
+           up to run the payload themselves.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_pe_feat_db_create
+  @param   test_num - unique test number
+  @param   num_pe   - The number of PEs to run this test on
+  @param   payload  - Function evaluating the test rule for a PE index
+  @return  None
+**/
+void
+val_pe_run_feat_payload(uint32_t test_num, uint32_t num_pe, void (*payload)(uint32_t index))
+{
+  uint32_t my_index = val_pe_get_index();
+  uint32_t dispatched = 0;
+  uint32_t i;
+
+  g_pe_feat_payload = payload;
+  val_data_cache_ops_by_range((addr_t)&g_pe_feat_payload, sizeof(g_pe_feat_payload),
+                              CLEAN_AND_INVALIDATE);
+
+  for (i = 0; i < num_pe; i++) {
+      if ((i == my_index) || val_pe_feat_db_get(i)) {
+          payload(i);
+          continue;
+      }
+
+      val_execute_on_pe(i, val_pe_feat_payload_entry, 0);
+      dispatched = 1;
+  }
+
+  if (dispatched)
+      val_wait_for_test_completion(test_num, num_pe, TIMEOUT_LARGE);
+}
+
 /**
   @brief   This API indicates the presence of exception level 3
            1. Caller       -  Test Suite
@@ -29,7 +29,120 @@ PE_INFO_TABLE *g_pe_info_table;
   @brief   global structure to pass and retrieve arguments for the SMC call
 **/
 ARM_SMC_ARGS g_smc_args;
+/**
+  @brief   Open addressed MPIDR hash, each slot holds PE index + 1, 0 if free
+**/
+static uint32_t *g_pe_index_hash;
+static uint32_t g_pe_index_hash_mask;
+/**
+  @brief   Per PE, 1 if the PE was started and never came back. Such a PE is
+           still powered on and is left out of later tests.
+**/
+static uint8_t *g_pe_lost;
+/**
+  @brief   TPIDR_EL1 of the primary PE before the index was cached there
+**/
+#ifndef TARGET_LINUX
+static uint64_t g_pe_saved_tpidr;
+static uint32_t g_pe_tpidr_saved;
+#endif
+
+
+/**
+  @brief   Hash the affinity fields of an MPIDR into a g_pe_index_hash slot
+  @param   mpid  MPIDR affinity value
+  @return  Slot index
+**/
+static uint32_t
+val_pe_mpid_hash(uint64_t mpid)
+{
+  uint32_t aff;
+
+  aff = (uint32_t)((mpid & 0xFFFFFF) | ((mpid >> 8) & 0xFF000000));
 
+  return ((aff * 0x9E3779B1) >> 16) & g_pe_index_hash_mask;
+}
+
+/**
+  @brief   Record the index of the calling PE in TPIDR_EL1, so that
+           val_pe_get_index needs a single register read.
+  @param   index  PE index of the calling PE
+  @return  None
+**/
+static void
+val_pe_cache_index(uint32_t index)
+{
+#ifndef TARGET_LINUX
+  AA64WriteTpidr1(PE_INDEX_CACHE_TAG | index);
+#endif
+}
+
+/**
+  @brief   Build the MPIDR to PE index hash over g_pe_info_table. The table
+           is kept at most half full, so every probe sequence ends on a free
+           slot.
+           1. Caller       -  val_pe_create_info_table
+           2. Prerequisite -  g_pe_info_table populated
+  @param   None
+  @return  None
+**/
+static void
+val_pe_create_index_hash(void)
+{
+  uint32_t num_pe = val_pe_get_num();
+  uint32_t size = 1;
+  uint32_t slot, i;
+
+  while (size < (2 * num_pe))
+      size <<= 1;
+
+  g_pe_index_hash = pal_mem_alloc(size * sizeof(uint32_t));
+  if (g_pe_index_hash == NULL) {
+      val_print(ACS_PRINT_WARN, "\n PE index hash allocation failed, using linear lookup", 0);
+      return;
+  }
+
+  g_pe_index_hash_mask = size - 1;
+  for (slot = 0; slot < size; slot++)
+      g_pe_index_hash[slot] = 0;
+
+  for (i = 0; i < num_pe; i++) {
+      slot = val_pe_mpid_hash(g_pe_info_table->pe_info[i].mpidr);
+      while (g_pe_index_hash[slot] != 0)
+          slot = (slot + 1) & g_pe_index_hash_mask;
+      g_pe_index_hash[slot] = i + 1;
+  }
+
+  /* Secondary PEs look the hash up as soon as they are powered on */
+  val_data_cache_ops_by_range((addr_t)g_pe_index_hash, size * sizeof(uint32_t),
+                              CLEAN_AND_INVALIDATE);
+  val_data_cache_ops_by_va((addr_t)&g_pe_index_hash, CLEAN_AND_INVALIDATE);
+  val_data_cache_ops_by_va((addr_t)&g_pe_index_hash_mask, CLEAN_AND_INVALIDATE);
+}
+
+/**
+  @brief   Return the MPIDR hash, so that the secondary PE entry point can
+           find its PE index before it has a stack. Slot values are
+           PE index + 1, 0 for a free slot.
+  @param   None
+  @return  Base address of the hash, 0 if it was not allocated
+**/
+uint64_t
+val_pe_get_index_hash(void)
+{
+  return (uint64_t)g_pe_index_hash;
+}
+
+/**
+  @brief   Return the slot mask of the MPIDR hash, see val_pe_get_index_hash.
+  @param   None
+  @return  Number of slots - 1
+**/
+uint32_t
+val_pe_get_index_hash_mask(void)
+{
+  return g_pe_index_hash_mask;
+}
 
 /**
   @brief   This API will call PAL layer to fill in the PE information
@@ -42,6 +155,7 @@ ARM_SMC_ARGS g_smc_args;
 uint32_t
 val_pe_create_info_table(uint64_t *pe_info_table)
 {
+  uint32_t i;
 
   val_print(ACS_PRINT_INFO, " Creating PE INFO table\n", 0);
 
@@ -61,6 +175,22 @@ val_pe_create_info_table(uint64_t *pe_info_table)
       val_print(ACS_PRINT_ERR, "\n *** CRITICAL ERROR: Num PE is 0x0 ***\n", 0);
       return ACS_STATUS_ERR;
   }
+
+  val_pe_create_index_hash();
+
+  g_pe_lost = pal_mem_alloc(val_pe_get_num());
+  for (i = 0; (g_pe_lost != NULL) && (i < val_pe_get_num()); i++)
+      g_pe_lost[i] = 0;
+
+#ifndef TARGET_LINUX
+  /* TPIDR_EL1 belongs to the firmware, give it back in val_pe_free_info_table */
+  if (!g_pe_tpidr_saved) {
+      g_pe_saved_tpidr = AA64ReadTpidr1();
+      g_pe_tpidr_saved = 1;
+  }
+#endif
+  val_pe_cache_index(val_pe_get_index_mpid(val_pe_get_mpid()));
+
   return ACS_STATUS_PASS;
 }
 
@@ -74,6 +204,23 @@ val_pe_create_info_table(uint64_t *pe_info_table)
 void
 val_pe_free_info_table()
 {
+#ifndef TARGET_LINUX
+  if (g_pe_tpidr_saved) {
+      AA64WriteTpidr1(g_pe_saved_tpidr);
+      g_pe_tpidr_saved = 0;
+  }
+#endif
+
+  if (g_pe_index_hash != NULL) {
+      pal_mem_free((void *)g_pe_index_hash);
+      g_pe_index_hash = NULL;
+  }
+
+  if (g_pe_lost != NULL) {
+      pal_mem_free((void *)g_pe_lost);
+      g_pe_lost = NULL;
+  }
+
   pal_mem_free((void *)g_pe_info_table);
 }
 
@@ -155,9 +302,20 @@ val_pe_get_index_mpid(uint64_t mpid)
 
   PE_INFO_ENTRY *entry;
   uint32_t i = g_pe_info_table->header.num_of_pe;
+  uint32_t slot;
 
   entry = g_pe_info_table->pe_info;
 
+  if (g_pe_index_hash != NULL) {
+    slot = val_pe_mpid_hash(mpid);
+    while (g_pe_index_hash[slot] != 0) {
+      if (entry[g_pe_index_hash[slot] - 1].mpidr == mpid)
+        return entry[g_pe_index_hash[slot] - 1].pe_num;
+      slot = (slot + 1) & g_pe_index_hash_mask;
+    }
+    return 0x0;
+  }
+
   while (i > 0) {
     if (entry->mpidr == mpid) {
       return entry->pe_num;
@@ -169,6 +327,28 @@ val_pe_get_index_mpid(uint64_t mpid)
   return 0x0;  //Return index 0 as a safe failsafe value
 }
 
+/**
+  @brief   This API returns the index of the calling PE. The index cached in
+           TPIDR_EL1 by val_pe_create_info_table on the primary PE, and by
+           val_test_entry on secondary PEs, is used when present.
+           1. Caller       -  Test Suite, VAL
+           2. Prerequisite -  val_create_peinfo_table
+  @param   None
+  @return  Index of the calling PE
+**/
+uint32_t
+val_pe_get_index(void)
+{
+#ifndef TARGET_LINUX
+  uint64_t cached = AA64ReadTpidr1();
+
+  if ((cached & PE_INDEX_CACHE_TAG_MASK) == PE_INDEX_CACHE_TAG)
+    return (uint32_t)(cached & PE_INDEX_CACHE_MASK);
+#endif
+
+  return val_pe_get_index_mpid(val_pe_get_mpid());
+}
+
 
 /**
   @brief   'C' Entry point for Secondary PE.
@@ -185,7 +365,13 @@ val_test_entry(void)
   ARM_SMC_ARGS smc_args;
   void (*vector)(uint64_t args);
 
-  val_get_test_data(val_pe_get_index_mpid(val_pe_get_mpid()), (uint64_t *)&vector, &test_arg);
+  uint32_t index;
+
+  /* TPIDR_EL1 is UNKNOWN after CPU_ON, refresh the cached index first */
+  index = val_pe_get_index_mpid(val_pe_get_mpid());
+  val_pe_cache_index(index);
+
+  val_get_test_data(index, (uint64_t *)&vector, &test_arg);
   vector(test_arg);
 
   // We have completed our TEST code. So, switch off the PE now
@@ -216,6 +402,12 @@ val_execute_on_pe(uint32_t index, void (*payload)(void), uint64_t test_input)
       return;
   }
 
+  /* The PE is still on, CPU_ON would only return ALREADY_ON */
+  if (val_pe_is_lost(index)) {
+      val_print(ACS_PRINT_DEBUG, "\n       PE %d is lost, not started", index);
+      return;
+  }
+
   do {
       g_smc_args.Arg0 = ARM_SMC_ID_PSCI_CPU_ON_AARCH64;
 
@@ -242,6 +434,42 @@ val_execute_on_pe(uint32_t index, void (*payload)(void), uint64_t test_input)
   val_set_status(index, RESULT_FAIL(0, 0x120 - (int)g_smc_args.Arg0));
 }
 
+/**
+  @brief   Mark a PE as lost: it was started and did not come back, so it is
+           still powered on and may still touch memory. Later tests leave it
+           out. The mark holds until val_pe_free_info_table.
+           1. Caller       -  VAL
+           2. Prerequisite -  val_pe_create_info_table
+  @param   index  PE index
+  @return  None
+**/
+void
+val_pe_set_lost(uint32_t index)
+{
+  if ((g_pe_lost == NULL) || (index >= val_pe_get_num()) || g_pe_lost[index])
+      return;
+
+  g_pe_lost[index] = 1;
+  val_print(ACS_PRINT_WARN, "\n       PE %d did not return, leaving it out of later tests",
+            index);
+}
+
+/**
+  @brief   Check whether a PE was marked lost by val_pe_set_lost
+           1. Caller       -  VAL
+           2. Prerequisite -  None
+  @param   index  PE index
+  @return  1 if the PE is lost, 0 otherwise
+**/
+uint32_t
+val_pe_is_lost(uint32_t index)
+{
+  if ((g_pe_lost == NULL) || (index >= val_pe_get_num()))
+      return 0;
+
+  return g_pe_lost[index];
+}
+
 /**
   @brief   This API installs the Exception handler pointed
            by the function pointer to the input exception type.
@@ -324,7 +552,7 @@ val_pe_initialize_default_exception_handler(void (*esr)(uint64_t, void *))
 void
 val_pe_default_esr(uint64_t interrupt_type, void *context)
 {
-    uint32_t index = val_pe_get_index_mpid(val_pe_get_mpid());
+    uint32_t index = val_pe_get_index();
     val_print(ACS_PRINT_WARN, "\n        Unexpected exception occured", 0);
 
 #ifndef TARGET_LINUX
@@ -353,15 +581,6 @@ void
 val_pe_cache_clean_range(uint64_t start_addr, uint64_t length)
 {
 #ifndef TARGET_LINUX
-  uint64_t aligned_addr, end_addr, line_length;
-
-  line_length = 2 << ((val_pe_reg_read(CTR_EL0) >> 16) & 0xf);
-  aligned_addr = start_addr - (start_addr & (line_length-1));
-  end_addr = start_addr + length;
-
-  while(aligned_addr < end_addr){
-      val_data_cache_ops_by_va(aligned_addr, CLEAN);
-      aligned_addr += line_length;
-  }
+  val_data_cache_ops_by_range(start_addr, length, CLEAN);
 #endif
 }
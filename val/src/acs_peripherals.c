@@ -36,6 +36,14 @@ val_peripheral_execute_tests(uint32_t num_pe, uint32_t *g_sw_view)
 {
 
   uint32_t status, i;
+#ifndef TARGET_LINUX
+  val_sched_test_t os_tests[] = {
+    {os_d001_entry, TEST_RES_PCIE | TEST_RES_PRIMARY, 0},
+    {os_d002_entry, TEST_RES_PCIE | TEST_RES_PRIMARY, 0},
+    {os_d003_entry, TEST_RES_UART | TEST_RES_GIC | TEST_RES_PRIMARY, TEST_RES_UART},
+    {os_d005_entry, TEST_RES_UART, TEST_RES_UART}
+  };
+#endif
 
   status = ACS_STATUS_PASS;
 
@@ -49,10 +57,7 @@ val_peripheral_execute_tests(uint32_t num_pe, uint32_t *g_sw_view)
   if (g_sw_view[G_SW_OS]) {
       val_print(ACS_PRINT_ERR, "\nOperating System View:\n", 0);
 #ifndef TARGET_LINUX
-      status |= os_d001_entry(num_pe);
-      status |= os_d002_entry(num_pe);
-      status |= os_d003_entry(num_pe);
-      status |= os_d005_entry(num_pe);
+      status |= val_test_sched_run(os_tests, sizeof(os_tests)/sizeof(os_tests[0]), num_pe);
 #else
       status |= os_d004_entry(num_pe);
 #endif
@@ -212,6 +217,11 @@ val_peripheral_get_info(PERIPHERAL_INFO_e info_type, uint32_t instance)
           if (i != 0xFFFF)
               return g_peripheral_info_table->info[i].interface_type;
           break;
+      case UART_ACCESS_WIDTH:
+          i = val_peripheral_get_entry_index(PERIPHERAL_TYPE_UART, instance);
+          if (i != 0xFFFF)
+              return g_peripheral_info_table->info[i].access_width;
+          break;
       case ANY_FLAGS:
           i = val_peripheral_get_entry_index (PERIPHERAL_TYPE_NONE, instance);
           if (i != 0xFFFF)
@@ -262,7 +272,8 @@ val_peripheral_create_info_table(uint64_t *peripheral_info_table)
   g_peripheral_info_table = (PERIPHERAL_INFO_TABLE *)peripheral_info_table;
   val_print(ACS_PRINT_INFO, " Creating PERIPHERAL INFO table\n", 0);
 
-  pal_peripheral_create_info_table(g_peripheral_info_table);
+  if (val_snapshot_restore(SNAPSHOT_PERIPHERAL_INFO, g_peripheral_info_table))
+      pal_peripheral_create_info_table(g_peripheral_info_table);
 
   val_print(ACS_PRINT_TEST, " Peripheral: Num of USB controllers   :    %d \n",
     val_peripheral_get_info(NUM_USB, 0));
@@ -303,3 +314,60 @@ uint32_t val_peripheral_is_pcie(uint32_t bdf)
   return pal_peripheral_is_pcie(seg, bus, dev, func);
 }
 
+/**
+  @brief   Find the UART instance at a base address
+
+  @param   base     - UART base address
+
+  @return  Instance number, 0xFFFFFFFF if the UART is not known
+**/
+static uint32_t
+val_peripheral_uart_instance(uint64_t base)
+{
+  uint32_t num_uart = val_peripheral_get_info(NUM_UART, 0);
+  uint32_t i;
+
+  for (i = 0; i < num_uart; i++) {
+      if (val_peripheral_get_info(UART_BASE0, i) == base)
+          return i;
+  }
+
+  return 0xFFFFFFFF;
+}
+
+/**
+  @brief   Find the interface type of the UART at a base address, so raw
+           prints can drive its FIFO
+           1. Caller       -  VAL
+           2. Prerequisite -  val_peripheral_create_info_table
+  @param   base     - UART base address
+  @return  SPCR interface type, 0xFFFFFFFF if the UART is not known
+**/
+uint32_t
+val_peripheral_uart_type(uint64_t base)
+{
+  uint32_t instance = val_peripheral_uart_instance(base);
+
+  if (instance == 0xFFFFFFFF)
+      return 0xFFFFFFFF;
+
+  return val_peripheral_get_info(UART_INTERFACE_TYPE, instance);
+}
+
+/**
+  @brief   Find the register access width of the UART at a base address
+           1. Caller       -  VAL
+           2. Prerequisite -  val_peripheral_create_info_table
+  @param   base     - UART base address
+  @return  GAS access size, 0 if not known
+**/
+uint32_t
+val_peripheral_uart_access_width(uint64_t base)
+{
+  uint32_t instance = val_peripheral_uart_instance(base);
+
+  if (instance == 0xFFFFFFFF)
+      return 0;
+
+  return val_peripheral_get_info(UART_ACCESS_WIDTH, instance);
+}
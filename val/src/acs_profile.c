@@ -0,0 +1,369 @@
+/** @file
+ * Copyright (c) 2021 Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "include/bsa_acs_val.h"
+#include "include/bsa_acs_pe.h"
+#include "include/bsa_acs_memory.h"
+
+/* PMU profiling of the suite itself.
+
+   With -profile the cycle counter and up to six event counters are
+   programmed when a test starts and read when its status is checked, giving
+   IPC and cache miss rates per test. VAL hot paths additionally bracket
+   themselves with val_profile_region_enter/exit so their share of the test
+   can be seen. Only the PE that started the test is measured; payloads on
+   other PEs are not counted. The Linux module leaves the PMU to perf, all
+   calls are no-ops there. */
+
+#ifndef TARGET_LINUX
+
+/* PMUv3 common events, in the order counters are handed out */
+typedef enum {
+  PROFILE_EVT_INST = 0,
+  PROFILE_EVT_L1D_REFILL,
+  PROFILE_EVT_L1D,
+  PROFILE_EVT_L2D_REFILL,
+  PROFILE_EVT_L2D,
+  PROFILE_EVT_BUS,
+  PROFILE_NUM_EVENTS
+} PROFILE_EVENT_e;
+
+static const uint32_t g_profile_event[PROFILE_NUM_EVENTS] = {
+  0x08,   /* INST_RETIRED */
+  0x03,   /* L1D_CACHE_REFILL */
+  0x04,   /* L1D_CACHE */
+  0x17,   /* L2D_CACHE_REFILL */
+  0x16,   /* L2D_CACHE */
+  0x19    /* BUS_ACCESS */
+};
+
+static char8_t *g_profile_region_name[PROFILE_NUM_REGIONS] = {
+  "cfg read ",
+  "cache op ",
+  "its cmd  ",
+  "smmu cmd "
+};
+
+/* Sample layout is PMCCNTR_EL0 followed by one entry per event counter */
+#define PROFILE_SAMPLE_NUM   (PROFILE_NUM_EVENTS + 1)
+
+#define PMU_VER_SHIFT        8
+#define PMU_VER_MASK         0xF
+#define PMU_VER_IMP_DEF      0xF
+#define PMU_VER_V3P5         0x6
+#define PMCR_E               (1ULL << 0)
+#define PMCR_LC              (1ULL << 6)
+#define PMCR_LP              (1ULL << 7)
+#define PMCR_N_SHIFT         11
+#define PMCR_N_MASK          0x1F
+#define MDCR_EL2_HPMN_MASK   0x1F
+#define PMCCNTR_ENABLE       (1ULL << 31)
+/* Count at EL2 as well as EL1 */
+#define PMU_FILTER_NSH       (1ULL << 27)
+
+typedef struct {
+  uint32_t depth;
+  uint32_t calls;
+  uint64_t start[PROFILE_SAMPLE_NUM];
+  uint64_t total[PROFILE_SAMPLE_NUM];
+} profile_region_t;
+
+typedef struct {
+  uint32_t probed;
+  uint32_t present;                      ///< PMUv3 usable from this EL
+  uint32_t num_cnt;                      ///< Event counters in use
+  uint32_t slot[PROFILE_NUM_EVENTS];     ///< Sample index of each event, 0 if not counted
+  uint64_t cnt_mask;                     ///< Event counter width
+  uint64_t cnt_enable;
+  uint64_t pmcr;                         ///< PMCR_EL0 before the test started
+  uint64_t mpidr;                        ///< PE being profiled
+  volatile uint32_t active;
+  uint64_t start[PROFILE_SAMPLE_NUM];
+  profile_region_t region[PROFILE_NUM_REGIONS];
+} profile_ctrl_t;
+
+static profile_ctrl_t g_profile;
+
+/**
+  @brief   Find the PMU counters available to the suite and assign the
+           events to them. Done once, on the first profiled test.
+
+  @param   None
+
+  @return  None
+**/
+static void
+val_profile_probe(void)
+{
+  uint64_t pmu_ver;
+  uint64_t pmceid0;
+  uint32_t num;
+  uint32_t i;
+
+  g_profile.probed = 1;
+
+  pmu_ver = (AA64ReadIdDfr0() >> PMU_VER_SHIFT) & PMU_VER_MASK;
+  if ((pmu_ver == 0) || (pmu_ver == PMU_VER_IMP_DEF)) {
+      val_print(ACS_PRINT_WARN, "\n       PMUv3 not implemented, profiling disabled", 0);
+      return;
+  }
+
+  g_profile.present = 1;
+  num = (AA64ReadPmcr() >> PMCR_N_SHIFT) & PMCR_N_MASK;
+  /* At EL2 counters from MDCR_EL2.HPMN on are not enabled by PMCR_EL0.E */
+  if (AA64ReadCurrentEL() == AARCH64_EL2) {
+      if ((AA64ReadMdcr2() & MDCR_EL2_HPMN_MASK) < num)
+          num = AA64ReadMdcr2() & MDCR_EL2_HPMN_MASK;
+  }
+
+  g_profile.cnt_mask = (pmu_ver >= PMU_VER_V3P5) ? ~0ULL : 0xFFFFFFFFULL;
+
+  /* All the events are below 32, PMCEID0_EL0 tells which are implemented */
+  pmceid0 = AA64ReadPmceid0();
+  for (i = 0; (i < PROFILE_NUM_EVENTS) && (g_profile.num_cnt < num); i++) {
+      if (!(pmceid0 & (1ULL << g_profile_event[i])))
+          continue;
+
+      g_profile.slot[i] = ++g_profile.num_cnt;
+  }
+
+  g_profile.cnt_enable = PMCCNTR_ENABLE | ((1ULL << g_profile.num_cnt) - 1);
+}
+
+/**
+  @brief   Program the counters for the events assigned by val_profile_probe.
+           Redone for every test as a test may itself reprogram the PMU.
+
+  @param   None
+
+  @return  None
+**/
+static void
+val_profile_program(void)
+{
+  uint32_t i;
+
+  for (i = 0; i < PROFILE_NUM_EVENTS; i++) {
+      if (g_profile.slot[i] == 0)
+          continue;
+
+      AA64WritePmselr(g_profile.slot[i] - 1);
+      AA64WritePmxevtyper(PMU_FILTER_NSH | g_profile_event[i]);
+  }
+  AA64WritePmccfiltr(PMU_FILTER_NSH);
+
+  g_profile.pmcr = AA64ReadPmcr();
+  AA64WritePmcr(g_profile.pmcr | PMCR_E | PMCR_LC |
+                ((g_profile.cnt_mask == ~0ULL) ? PMCR_LP : 0));
+  AA64WritePmcntenset(g_profile.cnt_enable);
+}
+
+/**
+  @brief   Add the counts since start to total
+
+  @param   start  Sample taken at the start of the region
+  @param   total  Running totals to add to
+
+  @return  None
+**/
+static void
+val_profile_accumulate(uint64_t *start, uint64_t *total)
+{
+  uint64_t end[PROFILE_SAMPLE_NUM];
+  uint32_t i;
+
+  PmuReadCounters(end, g_profile.num_cnt);
+
+  total[0] += end[0] - start[0];
+  for (i = 1; i <= g_profile.num_cnt; i++)
+      total[i] += (end[i] - start[i]) & g_profile.cnt_mask;
+}
+
+/**
+  @brief   Print num/den with two decimals, or n/a when an event was not counted
+
+  @param   label  Text printed before the value
+  @param   num    Numerator
+  @param   den    Denominator
+  @param   scale  1 for a ratio, 100 for a percentage
+
+  @return  None
+**/
+static void
+val_profile_print_ratio(char8_t *label, uint64_t num, uint64_t den, uint32_t scale)
+{
+  uint64_t value;
+
+  val_print(ACS_PRINT_TEST, label, 0);
+  if (den == 0) {
+      val_print(ACS_PRINT_TEST, "n/a", 0);
+      return;
+  }
+
+  value = (num * 100 * scale) / den;
+  val_print(ACS_PRINT_TEST, "%d", value / 100);
+  val_print(ACS_PRINT_TEST, ".%02d", value % 100);
+  if (scale == 100)
+      val_print(ACS_PRINT_TEST, "%%", 0);
+}
+
+/**
+  @brief   Print cycles, IPC and miss rates of one set of totals
+
+  @param   total  Totals in sample layout
+
+  @return  None
+**/
+static void
+val_profile_print(uint64_t *total)
+{
+  uint64_t count[PROFILE_NUM_EVENTS];
+  uint32_t i;
+
+  for (i = 0; i < PROFILE_NUM_EVENTS; i++)
+      count[i] = g_profile.slot[i] ? total[g_profile.slot[i]] : 0;
+
+  val_print(ACS_PRINT_TEST, "cycles 0x%llx", total[0]);
+  val_profile_print_ratio(", IPC ", count[PROFILE_EVT_INST],
+                          g_profile.slot[PROFILE_EVT_INST] ? total[0] : 0, 1);
+  val_profile_print_ratio(", L1D miss ", count[PROFILE_EVT_L1D_REFILL],
+                          g_profile.slot[PROFILE_EVT_L1D_REFILL] ? count[PROFILE_EVT_L1D] : 0,
+                          100);
+  val_profile_print_ratio(", L2D miss ", count[PROFILE_EVT_L2D_REFILL],
+                          g_profile.slot[PROFILE_EVT_L2D_REFILL] ? count[PROFILE_EVT_L2D] : 0,
+                          100);
+  if (g_profile.slot[PROFILE_EVT_BUS])
+      val_print(ACS_PRINT_TEST, ", bus access 0x%llx", count[PROFILE_EVT_BUS]);
+}
+
+#endif
+
+/**
+  @brief   Start counting for a test if profiling is enabled.
+           1. Caller       -  VAL, val_initialize_test.
+           2. Prerequisite -  None.
+  @param   test_num  Test being profiled
+  @return  None
+**/
+void
+val_profile_start(uint32_t test_num)
+{
+#ifndef TARGET_LINUX
+  if (!g_profile_mode)
+      return;
+
+  if (!g_profile.probed)
+      val_profile_probe();
+
+  if (!g_profile.present)
+      return;
+
+  val_memory_set(g_profile.region, sizeof(g_profile.region), 0);
+  val_profile_program();
+
+  g_profile.mpidr = ArmReadMpidr();
+  PmuReadCounters(g_profile.start, g_profile.num_cnt);
+  g_profile.active = 1;
+#endif
+}
+
+/**
+  @brief   Stop counting and report the test and region totals.
+           1. Caller       -  VAL, val_check_for_error.
+           2. Prerequisite -  val_profile_start.
+  @param   test_num  Test being profiled
+  @return  None
+**/
+void
+val_profile_stop(uint32_t test_num)
+{
+#ifndef TARGET_LINUX
+  uint64_t total[PROFILE_SAMPLE_NUM];
+  uint32_t i;
+
+  if (!g_profile.active)
+      return;
+
+  val_memory_set(total, sizeof(total), 0);
+  val_profile_accumulate(g_profile.start, total);
+  g_profile.active = 0;
+
+  AA64WritePmcntenclr(g_profile.cnt_enable);
+  AA64WritePmcr(g_profile.pmcr);
+
+  val_print(ACS_PRINT_TEST, "\n       Profile %d: ", test_num);
+  val_profile_print(total);
+
+  for (i = 0; i < PROFILE_NUM_REGIONS; i++) {
+      if (g_profile.region[i].calls == 0)
+          continue;
+
+      val_print(ACS_PRINT_TEST, "\n         ", 0);
+      val_print(ACS_PRINT_TEST, g_profile_region_name[i], 0);
+      val_print(ACS_PRINT_TEST, "calls %d, ", g_profile.region[i].calls);
+      val_profile_print(g_profile.region[i].total);
+  }
+  val_print(ACS_PRINT_TEST, "\n       ", 0);
+#endif
+}
+
+/**
+  @brief   Mark the start of a VAL hot path. Nested entries of the same
+           region are counted once, by the outermost pair.
+           1. Caller       -  VAL.
+           2. Prerequisite -  None.
+  @param   region  Region being entered
+  @return  None
+**/
+void
+val_profile_region_enter(PROFILE_REGION_e region)
+{
+#ifndef TARGET_LINUX
+  if (!g_profile.active || (ArmReadMpidr() != g_profile.mpidr))
+      return;
+
+  if (g_profile.region[region].depth++)
+      return;
+
+  PmuReadCounters(g_profile.region[region].start, g_profile.num_cnt);
+#endif
+}
+
+/**
+  @brief   Mark the end of a VAL hot path and add it to the region totals.
+           1. Caller       -  VAL.
+           2. Prerequisite -  val_profile_region_enter.
+  @param   region  Region being left
+  @return  None
+**/
+void
+val_profile_region_exit(PROFILE_REGION_e region)
+{
+#ifndef TARGET_LINUX
+  profile_region_t *entry;
+
+  if (!g_profile.active || (ArmReadMpidr() != g_profile.mpidr))
+      return;
+
+  entry = &g_profile.region[region];
+  if ((entry->depth == 0) || --entry->depth)
+      return;
+
+  val_profile_accumulate(entry->start, entry->total);
+  entry->calls++;
+#endif
+}
@@ -57,6 +57,17 @@ val_smmu_execute_tests(uint32_t num_pe, uint32_t *g_sw_view)
 {
   uint32_t status, i;
   uint32_t num_smmu;
+  val_sched_test_t os_tests[] = {
+    {os_i001_entry, TEST_RES_SMMU, 0},
+    {os_i002_entry, TEST_RES_SMMU, 0},
+    {os_i003_entry, TEST_RES_SMMU, 0},
+    {os_i004_entry, TEST_RES_SMMU, 0},
+    {os_i005_entry, TEST_RES_SMMU, 0},
+    {os_i006_entry, TEST_RES_SMMU, 0},
+    {os_i007_entry, TEST_RES_SMMU | TEST_RES_PCIE, 0},
+    {os_i008_entry, TEST_RES_SMMU | TEST_RES_PCIE, 0},
+    {os_i009_entry, TEST_RES_SMMU, 0}
+  };
 
   status = ACS_STATUS_PASS;
 
@@ -75,15 +86,7 @@ val_smmu_execute_tests(uint32_t num_pe, uint32_t *g_sw_view)
 
   if (g_sw_view[G_SW_OS]) {
        val_print(ACS_PRINT_ERR, "\nOperating System View:\n", 0);
-       status |= os_i001_entry(num_pe);
-       status |= os_i002_entry(num_pe);
-       status |= os_i003_entry(num_pe);
-       status |= os_i004_entry(num_pe);
-       status |= os_i005_entry(num_pe);
-       status |= os_i006_entry(num_pe);
-       status |= os_i007_entry(num_pe);
-       status |= os_i008_entry(num_pe);
-       status |= os_i009_entry(num_pe);
+       status |= val_test_sched_run(os_tests, sizeof(os_tests)/sizeof(os_tests[0]), num_pe);
   }
 
   if (g_sw_view[G_SW_HYP]) {
@@ -0,0 +1,295 @@
+/** @file
+ * Copyright (c) 2021 Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "include/bsa_acs_val.h"
+#include "include/bsa_acs_pcie.h"
+#include "include/bsa_acs_memory.h"
+#include "include/bsa_acs_snapshot.h"
+
+/* Platform information snapshot.
+
+   The info tables are filled by parsing ACPI or DT, and the PCIe BDF table
+   by scanning every bus of every ECAM. Both are fixed for a given platform,
+   so the application can save the tables after a full discovery and hand
+   them back on the next run. The PE and PCIe info tables are not held:
+   their PAL fills also set up PAL state, such as the secondary PE stacks,
+   and parsing them is cheap. Neither is the memory info table, which comes
+   from the UEFI memory map and changes from one boot to the next. A snapshot is only used when it was written by
+   the same table layout for the same ACPI tables or DT blob; otherwise the
+   tables are discovered again and the snapshot is rewritten. */
+
+typedef struct {
+  void     *table;
+  uint32_t size;
+} snapshot_table_t;
+
+static snapshot_table_t  g_snapshot_table[SNAPSHOT_NUM_RECORDS];
+static snapshot_header_t *g_snapshot;
+static uint32_t          g_snapshot_registered;
+static uint32_t          g_snapshot_restored;
+
+/**
+  @brief   Hash of the entry sizes of every table held in a snapshot. Guards
+           against loading a snapshot written by a build with different
+           table layouts.
+
+  @param   None
+
+  @return  Layout hash
+**/
+static uint32_t
+val_snapshot_layout(void)
+{
+  uint32_t sizes[] = {
+    sizeof(GIC_INFO_ENTRY), sizeof(TIMER_INFO_GTBLOCK),
+    sizeof(WD_INFO_BLOCK), sizeof(IOVIRT_BLOCK),
+    sizeof(PERIPHERAL_INFO_BLOCK), sizeof(pcie_device_attr),
+    SNAPSHOT_NUM_RECORDS
+  };
+  uint32_t hash = 2166136261U;
+  uint32_t i;
+
+  for (i = 0; i < sizeof(sizes)/sizeof(sizes[0]); i++)
+      hash = (hash ^ sizes[i]) * 16777619U;
+
+  return hash;
+}
+
+/**
+  @brief   Hash of the firmware tables the info tables are discovered from
+
+  @param   None
+
+  @return  Platform hash, 0 if not available
+**/
+static uint64_t
+val_snapshot_platform_hash(void)
+{
+#ifndef TARGET_LINUX
+  return pal_get_platform_hash();
+#else
+  return 0;
+#endif
+}
+
+/**
+  @brief   Register an info table so it can be restored from, or captured
+           into, a snapshot.
+           1. Caller       -  Application layer, VAL.
+           2. Prerequisite -  Memory allocated for the table.
+  @param   id     Snapshot record of the table
+  @param   table  Table memory
+  @param   size   Size of the table memory in bytes
+  @return  None
+**/
+void
+val_snapshot_register(SNAPSHOT_RECORD_e id, void *table, uint32_t size)
+{
+  if ((id >= SNAPSHOT_NUM_RECORDS) || (table == NULL))
+      return;
+
+  g_snapshot_table[id].table = table;
+  g_snapshot_table[id].size  = size;
+  g_snapshot_registered |= (1 << id);
+}
+
+/**
+  @brief   Fill a registered table from the loaded snapshot. Info table
+           creation calls this before parsing ACPI or DT and only parses when
+           it fails.
+           1. Caller       -  VAL, *_create_info_table.
+           2. Prerequisite -  val_snapshot_register.
+  @param   id     Snapshot record of the table
+  @param   table  Table memory, must be the registered one
+  @return  0 if the table was restored, 1 otherwise
+**/
+uint32_t
+val_snapshot_restore(SNAPSHOT_RECORD_e id, void *table)
+{
+  snapshot_record_t *record;
+
+  if ((g_snapshot == NULL) || (id >= SNAPSHOT_NUM_RECORDS))
+      return 1;
+
+  if ((table == NULL) || (g_snapshot_table[id].table != table))
+      return 1;
+
+  record = &g_snapshot->record[id];
+  if ((record->size == 0) || (record->size != g_snapshot_table[id].size))
+      return 1;
+
+  val_memcpy(table, (uint8_t *)g_snapshot + record->offset, record->size);
+  g_snapshot_restored |= (1 << id);
+
+  val_print(ACS_PRINT_DEBUG, "  Restored snapshot record %d\n", id);
+  return 0;
+}
+
+/**
+  @brief   Mark a restored table as not matching the platform after all, so
+           the snapshot is rewritten at the end of table creation
+
+  @param   id  Snapshot record of the table
+
+  @return  None
+**/
+void
+val_snapshot_invalidate(SNAPSHOT_RECORD_e id)
+{
+  if (id < SNAPSHOT_NUM_RECORDS)
+      g_snapshot_restored &= ~(1 << id);
+}
+
+/**
+  @brief   Validate a snapshot read back by the application and use it for
+           the info tables created from now on.
+           1. Caller       -  Application layer.
+           2. Prerequisite -  None.
+  @param   buffer  Snapshot contents, owned by the caller until val_snapshot_release
+  @param   size    Size of the snapshot in bytes
+  @return  0 if the snapshot matches this platform, 1 otherwise
+**/
+uint32_t
+val_snapshot_load(void *buffer, uint32_t size)
+{
+  snapshot_header_t *hdr = (snapshot_header_t *)buffer;
+  uint64_t platform_hash;
+  uint32_t i;
+
+  g_snapshot = NULL;
+
+  if ((hdr == NULL) || (size < sizeof(snapshot_header_t)))
+      return 1;
+
+  if ((hdr->magic != SNAPSHOT_MAGIC) || (hdr->version != SNAPSHOT_VERSION) ||
+      (hdr->layout != val_snapshot_layout()) || (hdr->num_records != SNAPSHOT_NUM_RECORDS) ||
+      (hdr->total_size != size)) {
+      val_print(ACS_PRINT_WARN, "\n  Platform snapshot format not supported, ignoring it", 0);
+      return 1;
+  }
+
+  platform_hash = val_snapshot_platform_hash();
+  if ((platform_hash == 0) || (hdr->platform_hash != platform_hash)) {
+      val_print(ACS_PRINT_WARN, "\n  Platform tables changed since the snapshot, ignoring it", 0);
+      return 1;
+  }
+
+  for (i = 0; i < SNAPSHOT_NUM_RECORDS; i++) {
+      if (hdr->record[i].size == 0)
+          continue;
+
+      if ((hdr->record[i].offset < sizeof(snapshot_header_t)) ||
+          (hdr->record[i].offset > size) ||
+          (hdr->record[i].size > (size - hdr->record[i].offset))) {
+          val_print(ACS_PRINT_WARN, "\n  Platform snapshot record %d is corrupt", i);
+          return 1;
+      }
+  }
+
+  g_snapshot = hdr;
+  val_print(ACS_PRINT_TEST, " Using platform snapshot, hash 0x%llx\n", platform_hash);
+  return 0;
+}
+
+/**
+  @brief   Stop using the loaded snapshot so the caller can free it
+
+  @param   None
+
+  @return  None
+**/
+void
+val_snapshot_release(void)
+{
+  g_snapshot = NULL;
+}
+
+/**
+  @brief   Check whether every registered table came from the snapshot
+
+  @param   None
+
+  @return  1 if all registered tables were restored, 0 otherwise
+**/
+uint32_t
+val_snapshot_is_restored(void)
+{
+  return (g_snapshot_registered != 0) && (g_snapshot_restored == g_snapshot_registered);
+}
+
+/**
+  @brief   Size of the snapshot val_snapshot_save would write
+
+  @param   None
+
+  @return  Size in bytes
+**/
+uint32_t
+val_snapshot_get_size(void)
+{
+  uint32_t size = sizeof(snapshot_header_t);
+  uint32_t i;
+
+  for (i = 0; i < SNAPSHOT_NUM_RECORDS; i++)
+      if (g_snapshot_table[i].table)
+          size += g_snapshot_table[i].size;
+
+  return size;
+}
+
+/**
+  @brief   Capture all registered tables into a snapshot.
+           1. Caller       -  Application layer.
+           2. Prerequisite -  Info tables created.
+  @param   buffer  Destination, at least val_snapshot_get_size bytes
+  @param   size    Size of buffer in bytes
+  @return  0 on success, 1 on failure
+**/
+uint32_t
+val_snapshot_save(void *buffer, uint32_t size)
+{
+  snapshot_header_t *hdr = (snapshot_header_t *)buffer;
+  uint32_t offset;
+  uint32_t i;
+
+  if ((hdr == NULL) || (size < val_snapshot_get_size()))
+      return 1;
+
+  val_memory_set(hdr, sizeof(snapshot_header_t), 0);
+  hdr->magic         = SNAPSHOT_MAGIC;
+  hdr->version       = SNAPSHOT_VERSION;
+  hdr->layout        = val_snapshot_layout();
+  hdr->platform_hash = val_snapshot_platform_hash();
+  hdr->num_records   = SNAPSHOT_NUM_RECORDS;
+
+  if (hdr->platform_hash == 0)
+      return 1;
+
+  offset = sizeof(snapshot_header_t);
+  for (i = 0; i < SNAPSHOT_NUM_RECORDS; i++) {
+      if (g_snapshot_table[i].table == NULL)
+          continue;
+
+      val_memcpy((uint8_t *)hdr + offset, g_snapshot_table[i].table, g_snapshot_table[i].size);
+      hdr->record[i].offset = offset;
+      hdr->record[i].size   = g_snapshot_table[i].size;
+      offset += g_snapshot_table[i].size;
+  }
+
+  hdr->total_size = offset;
+  return 0;
+}
@@ -18,6 +18,7 @@
 #include "include/bsa_acs_val.h"
 #include "include/bsa_acs_pe.h"
 #include "include/bsa_acs_common.h"
+#include "include/bsa_acs_memory.h"
 #include "sys_arch_src/gic/bsa_exception.h"
 
 /**
@@ -36,8 +37,13 @@ void
 val_print(uint32_t level, char8_t *string, uint64_t data)
 {
 
-  if (level >= g_print_level)
+  if (level >= g_print_level) {
+#ifndef TARGET_LINUX
+      if (val_test_sched_capture(string, data))
+          return;
+#endif
       pal_print(string, data);
+  }
 
 }
 
@@ -59,7 +65,12 @@ val_print_raw(uint64_t uart_address, uint32_t level, char8_t *string,
 {
 
   if (level >= g_print_level){
+#ifndef TARGET_LINUX
+      pal_uart_print_raw(uart_address, val_peripheral_uart_type(uart_address),
+                         val_peripheral_uart_access_width(uart_address), string, data);
+#else
       pal_print_raw(uart_address, string, data);
+#endif
   }
 
 }
@@ -220,17 +231,28 @@ val_initialize_test(uint32_t test_num, char8_t *desc, uint32_t num_pe)
 {
 
   uint32_t i;
-  uint32_t index = val_pe_get_index_mpid(val_pe_get_mpid());
+  uint32_t index = val_pe_get_index();
+  uint32_t sched_mode = SCHED_MODE_OFF;
+
+#ifndef TARGET_LINUX
+  sched_mode = val_test_sched_mode();
+#endif
 
   val_print(ACS_PRINT_ERR, "%4d : ", test_num); //Always print this
   val_print(ACS_PRINT_TEST, desc, 0);
   val_report_status(0, BSA_ACS_START(test_num), NULL);
   val_pe_initialize_default_exception_handler(val_pe_default_esr);
 
-  g_bsa_tests_total++;
+  /* The dispatch pass of the test scheduler only looks at the skip list */
+  if (sched_mode != SCHED_MODE_DISPATCH)
+      g_bsa_tests_total++;
 
-  for (i = 0; i < num_pe; i++)
-      val_set_status(i, RESULT_PENDING(test_num));
+  /* Secondary PEs may be running other tests under the scheduler */
+  if (sched_mode == SCHED_MODE_OFF) {
+      for (i = 0; i < num_pe; i++)
+          val_set_status(i, RESULT_PENDING(test_num));
+  } else
+      val_set_status(index, RESULT_PENDING(test_num));
 
   for (i=0 ; i<MAX_TEST_SKIP_NUM ; i++){
       if (g_skip_test_num[i] == test_num) {
@@ -240,6 +262,10 @@ val_initialize_test(uint32_t test_num, char8_t *desc, uint32_t num_pe)
       }
   }
 
+  /* Under the scheduler the payload may run on another PE than the counters */
+  if (sched_mode == SCHED_MODE_OFF)
+      val_profile_start(test_num);
+
   return ACS_STATUS_PASS;
 }
 
@@ -304,8 +330,8 @@ val_set_test_data(uint32_t index, uint64_t addr, uint64_t test_data)
   mem->data0 = addr;
   mem->data1 = test_data;
 
-  val_data_cache_ops_by_va((addr_t)&mem->data0, CLEAN_AND_INVALIDATE);
-  val_data_cache_ops_by_va((addr_t)&mem->data1, CLEAN_AND_INVALIDATE);
+  val_data_cache_ops_by_range((addr_t)&mem->data0, sizeof(mem->data0) + sizeof(mem->data1),
+                              CLEAN_AND_INVALIDATE);
 }
 
 /**
@@ -336,8 +362,8 @@ val_get_test_data(uint32_t index, uint64_t *data0, uint64_t *data1)
   mem = (VAL_SHARED_MEM_t *) pal_mem_get_shared_addr();
   mem = mem + index;
 
-  val_data_cache_ops_by_va((addr_t)&mem->data0, INVALIDATE);
-  val_data_cache_ops_by_va((addr_t)&mem->data1, INVALIDATE);
+  val_data_cache_ops_by_range((addr_t)&mem->data0, sizeof(mem->data0) + sizeof(mem->data1),
+                              INVALIDATE);
 
   *data0 = mem->data0;
   *data1 = mem->data1;
@@ -372,6 +398,10 @@ val_wait_for_test_completion(uint32_t test_num, uint32_t num_pe, uint32_t timeou
       j = 0;
       for (i = 0; i < num_pe; i++)
       {
+          /* A lost PE was not started and holds a stale status */
+          if (val_pe_is_lost(i))
+              continue;
+
           if (IS_RESULT_PENDING(val_get_status(i))) {
               j = i+1;
           }
@@ -400,10 +430,19 @@ void
 val_run_test_payload(uint32_t test_num, uint32_t num_pe, void (*payload)(void), uint64_t test_input)
 {
 
-  uint32_t my_index = val_pe_get_index_mpid(val_pe_get_mpid());
+  uint32_t my_index = val_pe_get_index();
   uint32_t i;
 
+#ifndef TARGET_LINUX
+  if (val_test_sched_payload_hook(test_num, num_pe, payload))
+      return;
+#endif
+
+#ifndef TARGET_LINUX
+  val_test_watchdog_run(test_num, payload);  //this is test run separately on present PE
+#else
   payload();  //this is test run separately on present PE
+#endif
   if (num_pe == 1)
       return;
 
@@ -433,7 +472,14 @@ val_check_for_error(uint32_t test_num, uint32_t num_pe, char8_t *ruleid)
   uint32_t i;
   uint32_t status = 0;
   uint32_t error_flag = 0;
-  uint32_t my_index = val_pe_get_index_mpid(val_pe_get_mpid());
+  uint32_t my_index = val_pe_get_index();
+
+#ifndef TARGET_LINUX
+  if (val_test_sched_mode() == SCHED_MODE_DISPATCH)
+      return ACS_STATUS_PASS;
+#endif
+
+  val_profile_stop(test_num);
 
   /* this special case is needed when the Main PE is not the first entry
      of pe_info_table but num_pe is 1 for SOC tests */
@@ -452,6 +498,16 @@ val_check_for_error(uint32_t test_num, uint32_t num_pe, char8_t *ruleid)
   }
 
   for (i = 0; i < num_pe; i++) {
+      if (val_pe_is_lost(i))
+          continue;
+
+#ifndef TARGET_LINUX
+      /* A secondary PE which ran off its stack may have corrupted others */
+      if ((i != my_index) && pal_pe_secondary_stack_overflow(i)) {
+          val_print(ACS_PRINT_ERR, "\n       Stack overflow on PE %d", i);
+          val_set_status(i, RESULT_FAIL(test_num, 0xFE));
+      }
+#endif
       status = val_get_status(i);
       //val_print(ACS_PRINT_ERR, "Status %4x \n", status);
       if (IS_TEST_FAIL_SKIP(status)) {
@@ -487,8 +543,56 @@ val_check_for_error(uint32_t test_num, uint32_t num_pe, char8_t *ruleid)
 void
 val_data_cache_ops_by_va(addr_t addr, uint32_t type)
 {
+  val_profile_region_enter(PROFILE_REGION_CACHE_OP);
   pal_pe_data_cache_ops_by_va(addr, type);
+  val_profile_region_exit(PROFILE_REGION_CACHE_OP);
+}
+
+/**
+  @brief  Perform cache maintenance on every Data cache line of an address
+          range. Lines are walked at the CTR_EL0.DminLine size and a single
+          barrier completes the whole range.
+
+  @param  addr Start address of the range
+  @param  len  Length of the range in bytes
+  @param  type type of maintenance, CLEAN, INVALIDATE or CLEAN_AND_INVALIDATE
+
+  @return None
+**/
+void
+val_data_cache_ops_by_range(addr_t addr, uint64_t len, uint32_t type)
+{
+#ifndef TARGET_LINUX
+  val_profile_region_enter(PROFILE_REGION_CACHE_OP);
+  pal_pe_data_cache_ops_by_range(addr, len, type);
+  val_profile_region_exit(PROFILE_REGION_CACHE_OP);
+#else
+  addr_t end_addr = addr + len;
+
+  /* Linux PAL maintains one line per call, step by the smallest line size */
+  addr = addr & ~(CACHE_LINE_MIN_SIZE - 1);
+  do {
+    pal_pe_data_cache_ops_by_va(addr, type);
+    addr += CACHE_LINE_MIN_SIZE;
+  } while (addr < end_addr);
+#endif
+}
+
+/**
+  @brief  Clean, or clean and invalidate, the whole Data cache hierarchy up to
+          the Level of Coherency by set/way. Meant for whole-cache flushes
+          where walking an address range would take longer.
+
+  @param  type type of maintenance, CLEAN or CLEAN_AND_INVALIDATE
 
+  @return None
+**/
+void
+val_data_cache_ops_by_set_way(uint32_t type)
+{
+#ifndef TARGET_LINUX
+  pal_pe_data_cache_ops_by_set_way(type);
+#endif
 }
 
 /**
@@ -579,7 +683,7 @@ val_strncmp(char8_t *str1, char8_t *str2, uint32_t len)
 void*
 val_memcpy(void *dst_buffer, void *src_buffer, uint32_t len)
 {
-  return pal_memcpy(dst_buffer, src_buffer, len);
+  return val_memory_copy(dst_buffer, src_buffer, len);
 }
 
 /**
@@ -609,3 +713,44 @@ val_dump_dtb(void)
 {
   pal_dump_dtb();
 }
+
+/**
+  @brief  Sorts the input samples in place and summarises them. Used by the
+          benchmark tests to report latency distributions.
+
+  @param  samples  Array of timing samples, reordered on return
+  @param  count    Number of valid entries in samples
+  @param  stats    Filled with min, median, 99th percentile, max and sum
+
+  @return None
+**/
+void
+val_perf_get_stats(uint64_t *samples, uint32_t count, perf_stats_t *stats)
+{
+  uint32_t i, j;
+  uint64_t key;
+
+  stats->min = stats->median = stats->p99 = stats->max = stats->total = 0;
+  if (count == 0)
+      return;
+
+  /* Sample counts are small, insertion sort is good enough */
+  for (i = 1; i < count; i++) {
+      key = samples[i];
+      j = i;
+      while (j > 0 && samples[j - 1] > key) {
+          samples[j] = samples[j - 1];
+          j--;
+      }
+      samples[j] = key;
+  }
+
+  for (i = 0; i < count; i++)
+      stats->total += samples[i];
+
+  stats->min    = samples[0];
+  stats->median = samples[count / 2];
+  /* Nearest-rank percentile */
+  stats->p99    = samples[((count * 99) + 99) / 100 - 1];
+  stats->max    = samples[count - 1];
+}
@@ -0,0 +1,443 @@
+/** @file
+ * Copyright (c) 2021 Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "include/bsa_acs_val.h"
+#include "include/bsa_acs_common.h"
+#include "include/bsa_acs_memory.h"
+
+/* Concurrent execution of single PE tests.
+
+   A module hands val_test_sched_run its tests in order, each with the
+   hardware it reads (uses) and the hardware it changes (owns). The entry
+   function of every test is called twice:
+
+   - Dispatch pass: prints are dropped, val_initialize_test only applies the
+     skip list and val_run_test_payload queues the payload instead of running
+     it. Nothing else in the entry may touch hardware.
+   - Report pass: the entries run in the original order as usual.
+     val_run_test_payload waits for the queued payload, replays the prints it
+     made and hands its status to the primary PE, so the log reads exactly
+     as if the tests had run one after the other.
+
+   Meanwhile the queue is fed to idle secondary PEs. A test starts only when
+   it does not conflict with a running test or with an earlier queued test,
+   so tests sharing hardware keep their original order. Tests marked
+   TEST_RES_PRIMARY, because they need UEFI services or exception handling,
+   and multi-PE tests run on the primary PE in the report pass once their
+   resources are free. The PCIe config space shadow is off meanwhile.
+
+   A payload that times out keeps running on its PE. The PE is marked lost
+   so that later modules leave it alone, and the scheduler state it points
+   to is never freed. */
+
+#define TEST_SCHED_MAX_TESTS    64
+#define TEST_SCHED_LOG_SIZE     32
+#define TEST_SCHED_TIMEOUT_MS   10000
+
+typedef enum {
+  SCHED_TEST_NONE = 0,      ///< Entry skipped the test or has not queued it
+  SCHED_TEST_QUEUED,
+  SCHED_TEST_RUNNING,
+  SCHED_TEST_DONE,
+  SCHED_TEST_INLINE         ///< Runs on the primary PE in the report pass
+} SCHED_TEST_STATE_e;
+
+typedef struct {
+  char8_t  *string;
+  uint64_t data;
+} sched_log_t;
+
+typedef struct {
+  uint32_t test_num;
+  uint32_t uses;
+  uint32_t owns;
+  void     (*payload)(void);
+  volatile uint32_t state;
+  uint32_t run_inline;      ///< Entry runs on the primary PE in the report pass
+  uint32_t pe_index;
+  uint32_t status;          ///< Status the payload left on its PE
+  uint64_t deadline;
+  uint32_t num_log;
+  uint32_t lost_log;
+  sched_log_t log[TEST_SCHED_LOG_SIZE];
+} sched_test_t;
+
+typedef struct {
+  uint32_t     mode;
+  uint32_t     primary;
+  uint32_t     num_tests;
+  uint32_t     current;     ///< Test whose entry is being called
+  sched_test_t *test;
+  sched_test_t **capture;   ///< Per PE, test whose prints are being captured
+  uint32_t     *pe_busy;    ///< Per PE, 0 idle, 1 running a test, 2 hung or lost
+  uint32_t     num_hung;    ///< Payloads still running after their timeout
+} sched_ctrl_t;
+
+static sched_ctrl_t g_sched;
+
+/**
+  @brief   Check whether two resource footprints may run at the same time
+
+  @param   a  First test
+  @param   b  Second test
+
+  @return  1 if they conflict, 0 otherwise
+**/
+static uint32_t
+val_test_sched_conflict(sched_test_t *a, sched_test_t *b)
+{
+  return ((a->owns & (b->owns | b->uses)) != 0) || ((b->owns & a->uses) != 0);
+}
+
+/**
+  @brief   Payload run on a secondary PE. Runs the queued test payload with
+           its prints captured and records the status it left.
+
+  @param   None
+
+  @return  None
+**/
+static void
+val_test_sched_payload(void)
+{
+  uint64_t data0, data1;
+  uint32_t index = val_pe_get_index();
+  sched_test_t *test;
+  sched_test_t **capture;
+
+  val_get_test_data(index, &data0, &data1);
+  val_data_cache_ops_by_range((addr_t)&g_sched, sizeof(g_sched), INVALIDATE);
+
+  /* g_sched is cleared once the module is done, even if this payload hung */
+  test = &g_sched.test[data1];
+  capture = g_sched.capture;
+  val_data_cache_ops_by_range((addr_t)test, sizeof(sched_test_t), INVALIDATE);
+
+  capture[index] = test;
+  val_data_cache_ops_by_va((addr_t)&capture[index], CLEAN_AND_INVALIDATE);
+
+  test->payload();
+
+  capture[index] = NULL;
+  val_data_cache_ops_by_va((addr_t)&capture[index], CLEAN_AND_INVALIDATE);
+
+  test->status = val_get_status(index);
+  test->state = SCHED_TEST_DONE;
+  val_data_cache_ops_by_range((addr_t)test, sizeof(sched_test_t), CLEAN_AND_INVALIDATE);
+}
+
+/**
+  @brief   Collect finished tests and start every queued test that can run.
+           A queued test is held back by the running tests and by any
+           earlier queued test it conflicts with.
+
+  @param   None
+
+  @return  None
+**/
+static void
+val_test_sched_pump(void)
+{
+  sched_test_t *test, *other;
+  uint32_t num_pe = val_pe_get_num();
+  uint32_t i, j, pe;
+  uint32_t blocked;
+
+  for (i = 0; i < g_sched.num_tests; i++) {
+      test = &g_sched.test[i];
+      if (test->state != SCHED_TEST_RUNNING)
+          continue;
+
+      val_data_cache_ops_by_range((addr_t)test, sizeof(sched_test_t), INVALIDATE);
+      if (test->state == SCHED_TEST_DONE) {
+          g_sched.pe_busy[test->pe_index] = 0;
+          continue;
+      }
+
+      if (val_timer_get_counter() > test->deadline) {
+          val_print(ACS_PRINT_ERR, "\n       Test %d timed out on PE", test->test_num);
+          val_print(ACS_PRINT_ERR, " %d", test->pe_index);
+          test->status = RESULT_FAIL(test->test_num, 0xF);
+          test->state = SCHED_TEST_DONE;
+          g_sched.pe_busy[test->pe_index] = 2;
+          g_sched.num_hung++;
+          val_pe_set_lost(test->pe_index);
+      }
+  }
+
+  for (i = 0; i < g_sched.num_tests; i++) {
+      test = &g_sched.test[i];
+      if (test->state != SCHED_TEST_QUEUED)
+          continue;
+
+      blocked = 0;
+      for (j = 0; (j < g_sched.num_tests) && !blocked; j++) {
+          other = &g_sched.test[j];
+          if ((j == i) || ((other->state != SCHED_TEST_RUNNING) &&
+              !((j < i) && ((other->state == SCHED_TEST_QUEUED) ||
+                            (other->state == SCHED_TEST_INLINE)))))
+              continue;
+
+          blocked = val_test_sched_conflict(test, other);
+      }
+      if (blocked)
+          continue;
+
+      for (pe = 0; pe < num_pe; pe++)
+          if ((pe != g_sched.primary) && (g_sched.pe_busy[pe] == 0))
+              break;
+      if (pe == num_pe)
+          return;
+
+      test->pe_index = pe;
+      test->deadline = val_timer_get_counter() +
+                       (val_timer_get_info(TIMER_INFO_CNTFREQ, 0) * TEST_SCHED_TIMEOUT_MS) / 1000;
+      test->state = SCHED_TEST_RUNNING;
+      g_sched.pe_busy[pe] = 1;
+      val_data_cache_ops_by_range((addr_t)test, sizeof(sched_test_t), CLEAN_AND_INVALIDATE);
+
+      val_set_status(pe, RESULT_PENDING(test->test_num));
+      val_execute_on_pe(pe, val_test_sched_payload, i);
+  }
+}
+
+/**
+  @brief   Hook of val_print. Drops prints of the dispatch pass and captures
+           prints of payloads running on secondary PEs.
+           1. Caller       -  VAL, val_print.
+           2. Prerequisite -  None.
+  @param   string  Format string
+  @param   data    Value to print
+  @return  1 if the print was consumed, 0 if it should go to the console
+**/
+uint32_t
+val_test_sched_capture(char8_t *string, uint64_t data)
+{
+  sched_test_t *test;
+  uint32_t index;
+
+  if (g_sched.mode == SCHED_MODE_OFF)
+      return 0;
+
+  index = val_pe_get_index();
+  if (index == g_sched.primary)
+      return (g_sched.mode == SCHED_MODE_DISPATCH);
+
+  test = g_sched.capture[index];
+  if (test == NULL)
+      return 0;
+
+  if (test->num_log < TEST_SCHED_LOG_SIZE) {
+      test->log[test->num_log].string = string;
+      test->log[test->num_log].data   = data;
+      test->num_log++;
+  } else
+      test->lost_log++;
+
+  return 1;
+}
+
+/**
+  @brief   Current pass of the scheduler, lets the test infrastructure skip
+           the bookkeeping of the dispatch pass
+           1. Caller       -  VAL.
+           2. Prerequisite -  None.
+  @param   None
+  @return  SCHED_MODE_e
+**/
+uint32_t
+val_test_sched_mode(void)
+{
+  return g_sched.mode;
+}
+
+/**
+  @brief   Hook of val_run_test_payload. Queues the payload in the dispatch
+           pass. In the report pass, waits for the queued payload and makes
+           its prints and status those of the primary PE.
+           1. Caller       -  VAL, val_run_test_payload.
+           2. Prerequisite -  None.
+  @param   test_num  Test of the payload
+  @param   num_pe    Number of PEs the test runs on
+  @param   payload   Test payload
+  @return  1 if the payload was handled, 0 if it should run as usual
+**/
+uint32_t
+val_test_sched_payload_hook(uint32_t test_num, uint32_t num_pe, void (*payload)(void))
+{
+  sched_test_t *test, *other;
+  uint32_t my_index = val_pe_get_index();
+  uint32_t i, busy;
+
+  if (g_sched.mode == SCHED_MODE_OFF)
+      return 0;
+
+  test = &g_sched.test[g_sched.current];
+
+  if (g_sched.mode == SCHED_MODE_DISPATCH) {
+      test->test_num = test_num;
+      test->payload  = payload;
+      if ((num_pe != 1) || (test->uses & TEST_RES_PRIMARY))
+          test->run_inline = 1;
+      test->state = test->run_inline ? SCHED_TEST_INLINE : SCHED_TEST_QUEUED;
+      return 1;
+  }
+
+  /* Entries call this the same way in both passes, NONE is only a safety net.
+     An entry running several tests must be TEST_RES_PRIMARY, each of its
+     payloads then comes here. */
+  if (test->run_inline || (test->state == SCHED_TEST_NONE)) {
+      /* Wait for conflicting tests, and for every PE if the test needs them */
+      do {
+          val_test_sched_pump();
+          busy = 0;
+          for (i = 0; i < g_sched.num_tests; i++) {
+              other = &g_sched.test[i];
+              if ((other->state == SCHED_TEST_RUNNING) &&
+                  ((num_pe != 1) || val_test_sched_conflict(test, other)))
+                  busy = 1;
+          }
+      } while (busy);
+
+      test->state = SCHED_TEST_DONE;
+      return 0;
+  }
+
+  while (test->state != SCHED_TEST_DONE)
+      val_test_sched_pump();
+
+  for (i = 0; i < test->num_log; i++)
+      pal_print(test->log[i].string, test->log[i].data);
+  if (test->lost_log)
+      val_print(ACS_PRINT_WARN, "\n       %d prints of the test were lost", test->lost_log);
+
+  val_set_status(my_index, test->status);
+  return 1;
+}
+
+/**
+  @brief   Free the scheduler state. A hung payload may still write its test
+           entry and capture slot, so the state is leaked if any PE hung.
+
+  @param   None
+
+  @return  None
+**/
+static void
+val_test_sched_free(void)
+{
+  if (g_sched.num_hung) {
+      val_memory_set(&g_sched, sizeof(g_sched), 0);
+      return;
+  }
+
+  if (g_sched.test)
+      pal_mem_free(g_sched.test);
+  if (g_sched.capture)
+      pal_mem_free(g_sched.capture);
+  if (g_sched.pe_busy)
+      pal_mem_free(g_sched.pe_busy);
+  val_memory_set(&g_sched, sizeof(g_sched), 0);
+}
+
+/**
+  @brief   Run single PE tests of a module concurrently on the secondary PEs,
+           reporting them in the original order. Runs the tests one after the
+           other when concurrent mode is off.
+           1. Caller       -  VAL, *_execute_tests.
+           2. Prerequisite -  val_allocate_shared_mem.
+  @param   tests      Tests in the order they are to be reported
+  @param   num_tests  Number of tests
+  @param   num_pe     Number of PEs, passed to the test entries
+  @return  Consolidated status of all the tests run
+**/
+uint32_t
+val_test_sched_run(val_sched_test_t *tests, uint32_t num_tests, uint32_t num_pe)
+{
+  uint32_t status = ACS_STATUS_PASS;
+  uint32_t total = val_pe_get_num();
+  uint32_t shadow;
+  uint32_t i;
+
+  /* PAL prints of MMIO accesses at INFO level go straight to the console */
+  if (!g_concurrent_mode || (g_print_level <= ACS_PRINT_INFO) || (total < 2) ||
+      (num_tests > TEST_SCHED_MAX_TESTS))
+      goto sequential;
+
+  g_sched.test    = pal_mem_alloc(num_tests * sizeof(sched_test_t));
+  g_sched.capture = pal_mem_alloc(total * sizeof(sched_test_t *));
+  g_sched.pe_busy = pal_mem_alloc(total * sizeof(uint32_t));
+  if ((g_sched.test == NULL) || (g_sched.capture == NULL) || (g_sched.pe_busy == NULL)) {
+      val_print(ACS_PRINT_WARN, "\n       Test scheduler allocation failed", 0);
+      val_test_sched_free();
+      goto sequential;
+  }
+
+  val_memory_set(g_sched.test, num_tests * sizeof(sched_test_t), 0);
+  val_memory_set(g_sched.capture, total * sizeof(sched_test_t *), 0);
+  val_memory_set(g_sched.pe_busy, total * sizeof(uint32_t), 0);
+  for (i = 0; i < total; i++)
+      if (val_pe_is_lost(i))
+          g_sched.pe_busy[i] = 2;
+  g_sched.num_tests = num_tests;
+  g_sched.primary   = val_pe_get_index();
+
+  /* The config space shadow allocates memory and is not MP safe */
+  shadow = val_pcie_shadow_suspend();
+
+  g_sched.mode = SCHED_MODE_DISPATCH;
+  for (i = 0; i < num_tests; i++) {
+      g_sched.current = i;
+      g_sched.test[i].uses = tests[i].uses;
+      g_sched.test[i].owns = tests[i].owns;
+      tests[i].entry(num_pe);
+  }
+
+  g_sched.mode = SCHED_MODE_REPORT;
+  val_data_cache_ops_by_range((addr_t)g_sched.test, num_tests * sizeof(sched_test_t),
+                              CLEAN_AND_INVALIDATE);
+  val_data_cache_ops_by_range((addr_t)g_sched.capture, total * sizeof(sched_test_t *),
+                              CLEAN_AND_INVALIDATE);
+  val_data_cache_ops_by_range((addr_t)&g_sched, sizeof(g_sched), CLEAN_AND_INVALIDATE);
+
+  val_test_sched_pump();
+  for (i = 0; i < num_tests; i++) {
+      g_sched.current = i;
+      status |= tests[i].entry(num_pe);
+  }
+
+  /* Every PE must be off before the next module reuses them */
+  do {
+      val_test_sched_pump();
+      for (i = 0; i < g_sched.num_tests; i++)
+          if (g_sched.test[i].state == SCHED_TEST_RUNNING)
+              break;
+  } while (i < g_sched.num_tests);
+
+  /* A hung payload may still read config space */
+  if (!g_sched.num_hung)
+      val_pcie_shadow_resume(shadow);
+
+  val_test_sched_free();
+  return status;
+
+sequential:
+  for (i = 0; i < num_tests; i++)
+      status |= tests[i].entry(num_pe);
+
+  return status;
+}
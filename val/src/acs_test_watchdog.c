@@ -0,0 +1,145 @@
+/** @file
+ * Copyright (c) 2021 Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "include/bsa_acs_val.h"
+#include "include/bsa_acs_common.h"
+#include "include/bsa_acs_pe.h"
+#include "include/bsa_acs_timer.h"
+
+/* Per test hang recovery.
+
+   With a test timeout set, the payload on the primary PE runs with the PE
+   physical timer of the current EL armed as a deadline. If the deadline
+   passes, the timer interrupt handler points the exception return at
+   PeResumeRecoveryPoint, which unwinds to the recovery point saved before
+   the payload was called. The test is failed and the suite carries on with
+   the next test.
+
+   Tests that program the same PE timer or install their own handler for its
+   interrupt replace the watchdog for their duration. */
+
+#define TEST_WATCHDOG_MAX_TICKS  0x7FFFFFFF   ///< Largest positive TVAL
+
+/* Registers restored by PeResumeRecoveryPoint: x19-x28, x29, x30, sp */
+uint64_t g_test_recovery[13];
+
+static uint32_t g_wdog_intid;
+static uint64_t g_wdog_deadline;
+static volatile uint32_t g_wdog_armed;
+
+/**
+  @brief   Program the watchdog timer for the remaining time, capped to what
+           fits in TVAL. A disarmed watchdog stops the timer.
+
+  @param   None
+
+  @return  None
+**/
+static void
+val_test_watchdog_program(void)
+{
+  uint64_t now, ticks = 0;
+
+  if (g_wdog_armed) {
+      now = val_timer_get_counter();
+      ticks = (g_wdog_deadline > now) ? (g_wdog_deadline - now) : 1;
+      if (ticks > TEST_WATCHDOG_MAX_TICKS)
+          ticks = TEST_WATCHDOG_MAX_TICKS;
+  }
+
+  if (AA64ReadCurrentEL() == AARCH64_EL2)
+      val_timer_set_phy_el2(ticks);
+  else
+      val_timer_set_phy_el1(ticks);
+}
+
+/**
+  @brief   Watchdog timer interrupt handler. Re-arms the timer if the deadline
+           is further than one TVAL period away, otherwise returns to the
+           recovery point of the test.
+
+  @param   int_id   Interrupt ID, passed by the interrupt protocol
+  @param   context  Exception context, passed by the interrupt protocol
+
+  @return  None
+**/
+static void
+val_test_watchdog_isr(uint32_t int_id, void *context)
+{
+  (void)int_id;
+
+  if (g_wdog_armed && (val_timer_get_counter() < g_wdog_deadline)) {
+      val_test_watchdog_program();
+      val_gic_end_of_interrupt(g_wdog_intid);
+      return;
+  }
+
+  g_wdog_armed = 0;
+  val_test_watchdog_program();
+  val_gic_end_of_interrupt(g_wdog_intid);
+  val_pe_update_elr(context, (uint64_t)PeResumeRecoveryPoint);
+}
+
+/**
+  @brief   Run a test payload on the current PE. With a test timeout set, a
+           payload that does not return in time is abandoned and the test is
+           failed.
+           1. Caller       -  VAL, val_run_test_payload.
+           2. Prerequisite -  val_timer_create_info_table, GIC initialized.
+  @param   test_num  Test of the payload
+  @param   payload   Test payload
+  @return  None
+**/
+void
+val_test_watchdog_run(uint32_t test_num, void (*payload)(void))
+{
+  uint32_t index;
+
+  if (g_test_timeout_ms == 0) {
+      payload();
+      return;
+  }
+
+  if (AA64ReadCurrentEL() == AARCH64_EL2)
+      g_wdog_intid = val_timer_get_info(TIMER_INFO_PHY_EL2_INTID, 0);
+  else
+      g_wdog_intid = val_timer_get_info(TIMER_INFO_PHY_EL1_INTID, 0);
+
+  if ((g_wdog_intid == 0) ||
+      val_gic_install_isr(g_wdog_intid, (void (*)(void))val_test_watchdog_isr)) {
+      payload();
+      return;
+  }
+
+  if (PeSaveRecoveryPoint(g_test_recovery) == 0) {
+      g_wdog_deadline = val_timer_get_counter() +
+                        (val_timer_get_info(TIMER_INFO_CNTFREQ, 0) * g_test_timeout_ms) / 1000;
+      g_wdog_armed = 1;
+      val_test_watchdog_program();
+
+      payload();
+
+      g_wdog_armed = 0;
+      val_test_watchdog_program();
+      return;
+  }
+
+  /* Resumed here from the watchdog interrupt */
+  index = val_pe_get_index();
+  val_print(ACS_PRINT_ERR, "\n       Test timed out after %d ms", g_test_timeout_ms);
+  val_set_status(index, RESULT_FAIL(test_num, 0xFD));
+}
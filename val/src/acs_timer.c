@@ -36,6 +36,13 @@ uint32_t
 val_timer_execute_tests(uint32_t num_pe, uint32_t *g_sw_view)
 {
   uint32_t status, i;
+  val_sched_test_t os_tests[] = {
+    {os_t001_entry, TEST_RES_TIMER, 0},
+    {os_t002_entry, TEST_RES_TIMER, 0},
+    {os_t003_entry, 0, TEST_RES_TIMER},
+    {os_t004_entry, TEST_RES_PRIMARY, TEST_RES_TIMER | TEST_RES_GIC},
+    {os_t005_entry, TEST_RES_PRIMARY, TEST_RES_TIMER | TEST_RES_GIC}
+  };
 
   status = ACS_STATUS_PASS;
 
@@ -48,11 +55,7 @@ val_timer_execute_tests(uint32_t num_pe, uint32_t *g_sw_view)
 
   if (g_sw_view[G_SW_OS]) {
       val_print(ACS_PRINT_ERR, "\nOperating System View:\n", 0);
-      status |= os_t001_entry(num_pe);
-      status |= os_t002_entry(num_pe);
-      status |= os_t003_entry(num_pe);
-      status |= os_t004_entry(num_pe);
-      status |= os_t005_entry(num_pe);
+      status |= val_test_sched_run(os_tests, sizeof(os_tests)/sizeof(os_tests[0]), num_pe);
   }
 
   if (status != ACS_STATUS_PASS)
@@ -223,6 +226,20 @@ val_get_phy_el1_timer_count(void)
   return  ArmArchTimerReadReg(CntpTval);
 }
 
+/**
+  @brief   This API returns the current value of the generic physical counter.
+           Tick rate is given by val_timer_get_info(TIMER_INFO_CNTFREQ, 0).
+           1. Caller       -  Test Suite
+           2. Prerequisite -  None
+
+  @return  CNTPCT_EL0 count
+**/
+uint64_t
+val_timer_get_counter(void)
+{
+  return ArmArchTimerReadReg(CntPct);
+}
+
 /**
   @brief   This API programs the el1 phy timer with the input timeout value.
            1. Caller       -  Test Suite
@@ -329,7 +346,8 @@ val_timer_create_info_table(uint64_t *timer_info_table)
 
   g_timer_info_table = (TIMER_INFO_TABLE *)timer_info_table;
 
-  pal_timer_create_info_table(g_timer_info_table);
+  if (val_snapshot_restore(SNAPSHOT_TIMER_INFO, g_timer_info_table))
+      pal_timer_create_info_table(g_timer_info_table);
 
   /* UEFI or other EL1 software may have enabled the el1 physical timer.
      Disable the timer to prevent interrupts at un-expected times */
@@ -24,7 +24,7 @@
 typedef void (*bsa_fp) (uint64_t, void *);
 bsa_fp g_esr_handler[4];
 
-typedef void (*irq_handler) (void);
+typedef void (*irq_handler) (uint32_t);
 irq_handler g_intr_handler[NUM_ARM_MAX_INTERRUPT];
 
 void default_irq_handler(uint64_t exception_type, void *context)
@@ -35,9 +35,10 @@ void default_irq_handler(uint64_t exception_type, void *context)
   iar_ack_val = val_bsa_gic_acknowledgeInterrupt();
   ack_interrupt = iar_ack_val & 0xFFFFFF;
 
-  /* Call Interrupt handler if installed otherwise print err. */
+  /* Call Interrupt handler if installed otherwise print err.
+     Interrupt ID is passed as the first argument, as the UEFI interrupt protocol does */
   if (g_intr_handler[ack_interrupt]) {
-      g_intr_handler[ack_interrupt]();
+      g_intr_handler[ack_interrupt](ack_interrupt);
   } else {
       val_print(ACS_PRINT_ERR,
                 "\n       GIC_INIT: Unregistered Handler for the interrupt_id : 0x%x",
@@ -82,6 +83,8 @@ void val_gic_bsa_install_esr(uint32_t exception_type, void (*esr)(uint64_t, void
 
 uint32_t common_exception_handler(uint32_t exception_type)
 {
+  uint64_t elr = bsa_gic_get_elr();
+
   val_print(ACS_PRINT_INFO, "\n       GIC_INIT: In Exception Handler Type : %x", exception_type);
 
   /* Call Handler for exception, Handler would have
@@ -93,9 +96,9 @@ uint32_t common_exception_handler(uint32_t exception_type)
   val_print(ACS_PRINT_INFO, "\n       GIC_INIT: Common Handler, ESR = %x", bsa_gic_get_esr());
 
   /* If ELR is updated inside the handler then skip the elr update in assembly handler
-   * Return 1 else return 0
+   * Return 1 else return 0. Interrupt handlers may update it too, e.g. the test watchdog
   */
-  if (exception_type == EXCEPT_AARCH64_SYNCHRONOUS_EXCEPTIONS)
+  if ((exception_type == EXCEPT_AARCH64_SYNCHRONOUS_EXCEPTIONS) || (bsa_gic_get_elr() != elr))
     return 1;
   else
     return 0;
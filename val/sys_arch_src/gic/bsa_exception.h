@@ -24,7 +24,7 @@
 
 void bsa_gic_set_el2_vector_table(void);
 uint32_t bsa_gic_update_elr(uint64_t elr_value);
-uint32_t bsa_gic_get_elr(void);
+uint64_t bsa_gic_get_elr(void);
 uint32_t bsa_gic_get_far(void);
 uint32_t bsa_gic_get_esr(void);
 uint32_t bsa_gic_ack_intr(void);
@@ -206,7 +206,7 @@ WriteCmdQMAPD(
     val_mmio_write64((uint64_t)(CMDQ_BASE + g_cwriter_ptr[its_index] + 2),
                      (uint64_t)((Valid << ITS_CMD_SHIFT_VALID) | (ITT_BASE & ITT_PAR_MASK)));
     val_mmio_write64((uint64_t)(CMDQ_BASE + g_cwriter_ptr[its_index] + 3), (uint64_t)(0x0));
-    g_cwriter_ptr[its_index] = g_cwriter_ptr[its_index] + ITS_NEXT_CMD_PTR;
+    g_cwriter_ptr[its_index] = (g_cwriter_ptr[its_index] + ITS_NEXT_CMD_PTR) % ITS_CMDQ_NUM_DW;
 }
 
 void
@@ -225,7 +225,7 @@ WriteCmdQMAPC(
     val_mmio_write64((uint64_t)(CMDQ_BASE + g_cwriter_ptr[its_index] + 2),
                      (uint64_t)((Valid << ITS_CMD_SHIFT_VALID) | RDBase | Clctn_ID));
     val_mmio_write64((uint64_t)(CMDQ_BASE + g_cwriter_ptr[its_index] + 3), (uint64_t)(0x0));
-    g_cwriter_ptr[its_index] = g_cwriter_ptr[its_index] + ITS_NEXT_CMD_PTR;
+    g_cwriter_ptr[its_index] = (g_cwriter_ptr[its_index] + ITS_NEXT_CMD_PTR) % ITS_CMDQ_NUM_DW;
 }
 
 void
@@ -242,7 +242,7 @@ WriteCmdQMAPI(
     val_mmio_write64((uint64_t)(CMDQ_BASE + g_cwriter_ptr[its_index] + 1), (uint64_t)(int_id));
     val_mmio_write64((uint64_t)(CMDQ_BASE + g_cwriter_ptr[its_index] + 2), (uint64_t)(Clctn_ID));
     val_mmio_write64((uint64_t)(CMDQ_BASE + g_cwriter_ptr[its_index] + 3), (uint64_t)(0x0));
-    g_cwriter_ptr[its_index] = g_cwriter_ptr[its_index] + ITS_NEXT_CMD_PTR;
+    g_cwriter_ptr[its_index] = (g_cwriter_ptr[its_index] + ITS_NEXT_CMD_PTR) % ITS_CMDQ_NUM_DW;
 }
 
 void
@@ -258,7 +258,22 @@ WriteCmdQINV(
     val_mmio_write64((uint64_t)(CMDQ_BASE + g_cwriter_ptr[its_index] + 1), (uint64_t)(int_id));
     val_mmio_write64((uint64_t)(CMDQ_BASE + g_cwriter_ptr[its_index] + 2), (uint64_t)(0x0));
     val_mmio_write64((uint64_t)(CMDQ_BASE + g_cwriter_ptr[its_index] + 3), (uint64_t)(0x0));
-    g_cwriter_ptr[its_index] = g_cwriter_ptr[its_index] + ITS_NEXT_CMD_PTR;
+    g_cwriter_ptr[its_index] = (g_cwriter_ptr[its_index] + ITS_NEXT_CMD_PTR) % ITS_CMDQ_NUM_DW;
+}
+
+void
+WriteCmdQINVALL(
+   uint32_t     its_index,
+   uint64_t     *CMDQ_BASE,
+   uint32_t     Clctn_ID
+  )
+{
+    val_mmio_write64((uint64_t)(CMDQ_BASE + g_cwriter_ptr[its_index]),
+                     (uint64_t)(ARM_ITS_CMD_INVALL));
+    val_mmio_write64((uint64_t)(CMDQ_BASE + g_cwriter_ptr[its_index] + 1), (uint64_t)(0x0));
+    val_mmio_write64((uint64_t)(CMDQ_BASE + g_cwriter_ptr[its_index] + 2), (uint64_t)(Clctn_ID));
+    val_mmio_write64((uint64_t)(CMDQ_BASE + g_cwriter_ptr[its_index] + 3), (uint64_t)(0x0));
+    g_cwriter_ptr[its_index] = (g_cwriter_ptr[its_index] + ITS_NEXT_CMD_PTR) % ITS_CMDQ_NUM_DW;
 }
 
 void
@@ -274,7 +289,7 @@ WriteCmdQDISCARD(
     val_mmio_write64((uint64_t)(CMDQ_BASE + g_cwriter_ptr[its_index] + 1), (uint64_t)(int_id));
     val_mmio_write64((uint64_t)(CMDQ_BASE + g_cwriter_ptr[its_index] + 2), (uint64_t)(0x0));
     val_mmio_write64((uint64_t)(CMDQ_BASE + g_cwriter_ptr[its_index] + 3), (uint64_t)(0x0));
-    g_cwriter_ptr[its_index] = g_cwriter_ptr[its_index] + ITS_NEXT_CMD_PTR;
+    g_cwriter_ptr[its_index] = (g_cwriter_ptr[its_index] + ITS_NEXT_CMD_PTR) % ITS_CMDQ_NUM_DW;
 }
 
 
@@ -290,7 +305,7 @@ WriteCmdQSYNC(
     val_mmio_write64((uint64_t)(CMDQ_BASE + g_cwriter_ptr[its_index] + 1), (uint64_t)(0x0));
     val_mmio_write64((uint64_t)(CMDQ_BASE + g_cwriter_ptr[its_index] + 2), (uint64_t)(RDBase));
     val_mmio_write64((uint64_t)(CMDQ_BASE + g_cwriter_ptr[its_index] + 3), (uint64_t)(0x0));
-    g_cwriter_ptr[its_index] = g_cwriter_ptr[its_index] + ITS_NEXT_CMD_PTR;
+    g_cwriter_ptr[its_index] = (g_cwriter_ptr[its_index] + ITS_NEXT_CMD_PTR) % ITS_CMDQ_NUM_DW;
 }
 
 void PollTillCommandQueueDone(uint32_t its_index)
@@ -301,6 +316,8 @@ void PollTillCommandQueueDone(uint32_t its_index)
   uint64_t    cwriter_value;
   uint64_t    ItsBase;
 
+  val_profile_region_enter(PROFILE_REGION_ITS_CMD);
+
   count = 0;
   ItsBase = g_gic_its_info->GicIts[its_index].Base;
   cwriter_value = val_mmio_read64(ItsBase + ARM_GITS_CWRITER);
@@ -327,6 +344,7 @@ void PollTillCommandQueueDone(uint32_t its_index)
     creadr_value = val_mmio_read64(ItsBase + ARM_GITS_CREADR);
   }
 
+  val_profile_region_exit(PROFILE_REGION_ITS_CMD);
 }
 
 uint64_t GetRDBaseFormat(uint32_t its_index)
@@ -442,6 +460,109 @@ void val_its_create_lpi_map(uint32_t its_index, uint32_t device_id,
 }
 
 
+static void ItsSubmitCmdQ(uint32_t its_index)
+{
+  uint64_t    ItsBase;
+
+  ItsBase = g_gic_its_info->GicIts[its_index].Base;
+
+  TestExecuteBarrier();
+
+  /* Update the CWRITER Register so that all the commands from Command queue gets executed.*/
+  val_mmio_write64((ItsBase + ARM_GITS_CWRITER), (g_cwriter_ptr[its_index] * NUM_BYTES_IN_DW));
+
+  /* Check CREADR value which ensures Command Queue is processed */
+  PollTillCommandQueueDone(its_index);
+  TestExecuteBarrier();
+}
+
+void val_its_create_lpi_map_range(uint32_t its_index, uint32_t device_id,
+                                  uint32_t int_id_base, uint32_t num_int, uint32_t Priority)
+{
+  uint32_t    index;
+  uint32_t    queued;
+  uint64_t    RDBase;
+  uint64_t    ItsBase;
+  uint64_t    ItsCommandBase;
+
+  if (!g_its_setup_done)
+    return;
+
+  ItsBase        = g_gic_its_info->GicIts[its_index].Base;
+  ItsCommandBase = g_gic_its_info->GicIts[its_index].CommandQBase;
+
+  /* Set Config table for every LPI in the range. */
+  for (index = 0; index < num_int; index++)
+    SetConfigTable(int_id_base + index, Priority);
+
+  /* Enable Redistributor */
+  EnableLPIsRD(g_gic_its_info->GicRdBase);
+
+  /* Enable ITS */
+  EnableITS(ItsBase);
+
+  /* Get RDBase Depending on GITS_TYPER.PTA */
+  RDBase = GetRDBaseFormat(its_index);
+
+  /* Map Device and Collection once for the whole range */
+  WriteCmdQMAPD(its_index, (uint64_t *)(ItsCommandBase), device_id,
+                g_gic_its_info->GicIts[its_index].ITTBase,
+                g_gic_its_info->GicIts[its_index].IDBits, 0x1 /*Valid*/);
+  WriteCmdQMAPC(its_index, (uint64_t *)(ItsCommandBase), device_id,
+                0x1 /*Clctn_ID*/, RDBase, 0x1 /*Valid*/);
+  queued = 2;
+
+  /* Map every Interrupt using MAPI, submitting before the queue can wrap onto CREADR */
+  for (index = 0; index < num_int; index++) {
+    if (queued >= ITS_CMDQ_BATCH) {
+      ItsSubmitCmdQ(its_index);
+      queued = 0;
+    }
+    WriteCmdQMAPI(its_index, (uint64_t *)(ItsCommandBase), device_id,
+                  int_id_base + index, 0x1 /*Clctn_ID*/);
+    queued++;
+  }
+
+  /* A single INVALL replaces the per LPI INV of val_its_create_lpi_map */
+  WriteCmdQINVALL(its_index, (uint64_t *)(ItsCommandBase), 0x1 /*Clctn_ID*/);
+  /* ITS SYNC Command */
+  WriteCmdQSYNC(its_index, (uint64_t *)(ItsCommandBase), RDBase);
+
+  ItsSubmitCmdQ(its_index);
+}
+
+void val_its_clear_lpi_map_range(uint32_t its_index, uint32_t device_id,
+                                 uint32_t int_id_base, uint32_t num_int)
+{
+  uint32_t    index;
+  uint64_t    RDBase;
+  uint64_t    ItsCommandBase;
+
+  if (!g_its_setup_done)
+    return;
+
+  ItsCommandBase = g_gic_its_info->GicIts[its_index].CommandQBase;
+
+  /* Clear Config table for every LPI in the range */
+  for (index = 0; index < num_int; index++)
+    ClearConfigTable(int_id_base + index);
+
+  /* Get RDBase Depending on GITS_TYPER.PTA */
+  RDBase = GetRDBaseFormat(its_index);
+
+  /* Un Map Device using MAPD, this drops every event mapped for the device */
+  WriteCmdQMAPD(its_index, (uint64_t *)(ItsCommandBase), device_id,
+                g_gic_its_info->GicIts[its_index].ITTBase,
+                0, 0 /*InValid*/);
+  /* Make the Redistributor drop its cached config for the cleared LPIs */
+  WriteCmdQINVALL(its_index, (uint64_t *)(ItsCommandBase), 0x1 /*Clctn_ID*/);
+  /* ITS SYNC Command */
+  WriteCmdQSYNC(its_index, (uint64_t *)(ItsCommandBase), RDBase);
+
+  ItsSubmitCmdQ(its_index);
+}
+
+
 uint32_t val_its_get_max_lpi(void)
 {
   uint32_t    index;
@@ -154,6 +154,7 @@
 #define ARM_ITS_CMD_MAPC    0x9
 #define ARM_ITS_CMD_MAPI    0xB
 #define ARM_ITS_CMD_INV     0xC
+#define ARM_ITS_CMD_INVALL  0xD
 #define ARM_ITS_CMD_DISCARD 0xF
 #define ARM_ITS_CMD_SYNC    0x5
 
@@ -164,6 +165,10 @@
 #define ITS_NEXT_CMD_PTR    4
 #define NUM_BYTES_IN_DW     8
 
+/* Command queue is NUM_PAGES_8 pages of 32 byte commands */
+#define ITS_CMDQ_NUM_DW     ((NUM_PAGES_8 * SIZE_4KB) / NUM_BYTES_IN_DW)
+#define ITS_CMDQ_BATCH      ((ITS_CMDQ_NUM_DW / ITS_NEXT_CMD_PTR) / 2)
+
 uint32_t ArmGicRedistributorConfigurationForLPI(uint64_t gicd_base, uint64_t rd_base);
 
 void ClearConfigTable(uint32_t int_id);
@@ -177,6 +182,10 @@ void EnableLPIsRD(uint64_t rd_base);
 void val_its_create_lpi_map(uint32_t its_index, uint32_t device_id,
                             uint32_t int_id, uint32_t Priority);
 void val_its_clear_lpi_map(uint32_t its_index, uint32_t device_id, uint32_t int_id);
+void val_its_create_lpi_map_range(uint32_t its_index, uint32_t device_id,
+                                  uint32_t int_id_base, uint32_t num_int, uint32_t Priority);
+void val_its_clear_lpi_map_range(uint32_t its_index, uint32_t device_id,
+                                 uint32_t int_id_base, uint32_t num_int);
 
 uint64_t val_its_get_translater_addr(uint32_t its_index);
 uint32_t val_its_get_max_lpi(void);
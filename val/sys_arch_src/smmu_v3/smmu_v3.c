@@ -208,19 +208,20 @@ static uint32_t smmu_strtab_init_linear(smmu_dev_t *smmu)
     uint32_t size, i;
     smmu_strtab_config_t *cfg = &smmu->strtab_cfg;
 
-    size = (1 << smmu->sid_bits) * (STRTAB_STE_DWORDS << 3);
+    size = (1 << cfg->sid_bits) * (STRTAB_STE_DWORDS << 3);
     cfg->strtab_ptr = val_memory_alloc(2*size);
     if (!cfg->strtab_ptr) {
         val_print(ACS_PRINT_ERR, "\n       Failed to allocate linear stream table.     ", 0);
         return 0;
     }
     val_memory_set(cfg->strtab_ptr, 2*size, 0);
+    cfg->alloc_size = 2*size;
 
     cfg->strtab_phys = align_to_size((uint64_t)val_memory_virt_to_phys(cfg->strtab_ptr), size);
     cfg->strtab64 = (uint64_t*)align_to_size((uint64_t)cfg->strtab_ptr, size);
-    cfg->l1_ent_count = 1 << smmu->sid_bits;
+    cfg->l1_ent_count = 1 << cfg->sid_bits;
     cfg->strtab_base_cfg = BITFIELD_SET(STRTAB_BASE_CFG_FMT, STRTAB_BASE_CFG_FMT_LINEAR) |
-                           BITFIELD_SET(STRTAB_BASE_CFG_LOG2SIZE, smmu->sid_bits);
+                           BITFIELD_SET(STRTAB_BASE_CFG_LOG2SIZE, cfg->sid_bits);
 
     for (ste = cfg->strtab64, i = 0; i < cfg->l1_ent_count; ++i, ste += STRTAB_STE_DWORDS)
         smmu_strtab_write_ste(NULL, ste);
@@ -309,6 +310,7 @@ sid);
     }
     desc->l2desc_phys = align_to_size((uint64_t)val_memory_virt_to_phys(desc->l2ptr), size);
     desc->l2desc64 = (uint64_t*)align_to_size((uint64_t)desc->l2ptr, size);
+    cfg->alloc_size += size*2;
 
     val_memory_set(desc->l2desc64, size, 0);
 
@@ -345,7 +347,7 @@ static int smmu_strtab_init_2level(smmu_dev_t *smmu)
     smmu_strtab_config_t *cfg = &smmu->strtab_cfg;
     int ret;
 
-    log2size = smmu->sid_bits - STRTAB_SPLIT;
+    log2size = cfg->sid_bits - STRTAB_SPLIT;
     cfg->l1_ent_count = 1 << log2size;
 
     log2size += STRTAB_SPLIT;
@@ -356,6 +358,7 @@ static int smmu_strtab_init_2level(smmu_dev_t *smmu)
         val_print(ACS_PRINT_ERR, "\n       failed to allocate l1 stream table     ", 0);
         return 0;
     }
+    cfg->alloc_size = 2 * l1_tbl_size;
 
     cfg->strtab_phys = align_to_size((uint64_t)val_memory_virt_to_phys(cfg->strtab_ptr), l1_tbl_size);
     cfg->strtab64 = (uint64_t*)align_to_size((uint64_t)cfg->strtab_ptr, l1_tbl_size);
@@ -371,11 +374,61 @@ static int smmu_strtab_init_2level(smmu_dev_t *smmu)
     return 1;
 }
 
+/* Size the stream table to the StreamIDs described in the iovirt table instead
+ * of the full SMMU_IDR1.SIDSIZE range. Level 2 spans are allocated on first use
+ * in val_smmu_map.
+ */
+static void smmu_strtab_set_size(smmu_dev_t *smmu)
+{
+    smmu_strtab_config_t *cfg = &smmu->strtab_cfg;
+    uint32_t bits = 0;
+
+    if (smmu->num_sids == 0) {
+        cfg->sid_bits = smmu->sid_bits;
+        return;
+    }
+
+    while (bits < smmu->sid_bits && (smmu->max_sid >> bits))
+        bits++;
+    cfg->sid_bits = bits;
+
+    /* A single level 2 span covers the table, so keep it linear */
+    if (cfg->sid_bits <= STRTAB_SPLIT)
+        smmu->supported.st_level_2lvl = 0;
+}
+
+static void smmu_strtab_report(smmu_dev_t *smmu, uint32_t full_2lvl)
+{
+    smmu_strtab_config_t *cfg = &smmu->strtab_cfg;
+    uint64_t full_size;
+    uint64_t full_writes;
+
+    /* Size and number of descriptor writes of a table covering all SIDSIZE bits */
+    if (full_2lvl) {
+        full_writes = 1ull << (smmu->sid_bits - STRTAB_SPLIT);
+        full_size = 2 * full_writes * STRTAB_L1_DESC_SIZE;
+    } else {
+        full_writes = 1ull << smmu->sid_bits;
+        full_size = 2 * full_writes * (STRTAB_STE_DWORDS << 3);
+    }
+
+    val_print(ACS_PRINT_INFO, "  StreamIDs in IORT %d", smmu->num_sids);
+    val_print(ACS_PRINT_INFO, " max sid 0x%x", smmu->max_sid);
+    val_print(ACS_PRINT_INFO, " strtab sid_bits %d\n", cfg->sid_bits);
+    if (full_size > cfg->alloc_size) {
+        val_print(ACS_PRINT_INFO, "  Stream table memory saved 0x%llx bytes", full_size - cfg->alloc_size);
+        val_print(ACS_PRINT_INFO, ", descriptor writes saved %lld\n", full_writes - cfg->l1_ent_count);
+    }
+}
+
 static uint32_t smmu_strtab_init(smmu_dev_t *smmu)
 {
     uint64_t data;
+    uint32_t full_2lvl = smmu->supported.st_level_2lvl;
     int ret;
 
+    smmu_strtab_set_size(smmu);
+
     if (smmu->supported.st_level_2lvl)
         ret = smmu_strtab_init_2level(smmu);
     else
@@ -386,6 +439,8 @@ static uint32_t smmu_strtab_init(smmu_dev_t *smmu)
         return ret;
     }
 
+    smmu_strtab_report(smmu, full_2lvl);
+
     /* Set the strtab base address */
     data = smmu->strtab_cfg.strtab_phys & STRTAB_BASE_ADDR_MASK;
     data |= STRTAB_BASE_RA;
@@ -425,6 +480,8 @@ static int smmu_dev_disable(smmu_dev_t *smmu)
 
 static void smmu_tlbi_cfgi(smmu_dev_t *smmu)
 {
+    val_profile_region_enter(PROFILE_REGION_SMMU_CMD);
+
     /* Invalidate any cached configuration */
     smmu_cmdq_issue_cmd(smmu, CMDQ_OP_CFGI_ALL);
     if (smmu->supported.hyp) {
@@ -434,6 +491,8 @@ static void smmu_tlbi_cfgi(smmu_dev_t *smmu)
     smmu_cmdq_issue_cmd(smmu, CMDQ_OP_CMD_SYNC);
 
     smmu_cmdq_poll_until_consumed(smmu);
+
+    val_profile_region_exit(PROFILE_REGION_SMMU_CMD);
 }
 
 static int smmu_reset(smmu_dev_t *smmu)
@@ -876,7 +935,7 @@ uint32_t val_smmu_map(smmu_master_attributes_t master_attr, pgt_descriptor_t pgt
         master->ssid = master_attr.substreamid;
     }
 
-    if (master_attr.streamid >= (0x1ul << smmu->sid_bits))
+    if (master_attr.streamid >= (0x1ul << smmu->strtab_cfg.sid_bits))
     {
         val_print(ACS_PRINT_ERR,
         "\n       val_smmu_map: sid %d out of range     ",
@@ -948,7 +1007,7 @@ uint32_t val_smmu_map(smmu_master_attributes_t master_attr, pgt_descriptor_t pgt
 void val_smmu_unmap(smmu_master_attributes_t master_attr)
 {
     smmu_master_t *master;
-    uint64_t *strtab;
+    uint64_t *ste;
 
     if ((master = smmu_master_at(master_attr.streamid)) == NULL)
         return;
@@ -956,11 +1015,11 @@ void val_smmu_unmap(smmu_master_attributes_t master_attr)
     if (master->smmu == NULL)
         return;
 
-    if (master_attr.streamid >= (0x1ul << master->smmu->sid_bits))
+    if (master_attr.streamid >= (0x1ul << master->smmu->strtab_cfg.sid_bits))
         return;
 
-    strtab = master->smmu->strtab_cfg.strtab64 + master_attr.streamid * STRTAB_STE_DWORDS;
-    smmu_strtab_write_ste(NULL, strtab);
+    ste = smmu_strtab_get_ste_for_sid(master->smmu, master_attr.streamid);
+    smmu_strtab_write_ste(NULL, ste);
 
     smmu_cdtab_free(master);
     smmu_tlbi_cfgi(master->smmu);
@@ -1043,6 +1102,7 @@ uint32_t val_smmu_init(void)
             continue;
         }
         g_smmu[i].base = val_iovirt_get_smmu_info(SMMU_CTRL_BASE, i);
+        g_smmu[i].num_sids = val_iovirt_get_smmu_sid_range(i, &g_smmu[i].max_sid);
         if (smmu_init(&g_smmu[i]))
         {
             val_print(ACS_PRINT_ERR, "  smmu_init: smmu %d init failed\n", i);
@@ -98,6 +98,8 @@ typedef struct {
     uint64_t strtab_phys;
     smmu_strtab_l1_desc_t *l1_desc;
     uint32_t l1_ent_count;
+    uint32_t sid_bits;
+    uint64_t alloc_size;
     uint64_t strtab_base;
     uint32_t strtab_base_cfg;
 } smmu_strtab_config_t;
@@ -108,6 +110,8 @@ typedef struct {
     uint64_t oas;
     uint32_t ssid_bits;
     uint32_t sid_bits;
+    uint32_t num_sids;
+    uint32_t max_sid;
     smmu_cmd_queue_t cmdq;
     smmu_strtab_config_t strtab_cfg;
     union {